@@ -6,8 +6,7 @@
 
 #pragma once
 
-#include <afx.h>
-#include <atlcomtime.h>
+#include "CQGAPIFacadePlatform.h"
 
 #include <limits>
 #include <memory>
@@ -35,18 +34,215 @@ struct QuoteInfo
    Type type;             ///< Quote type.
    Price price;           ///< Quote price.
    Volume volume;         ///< Quote volume.
+   DATE timestamp;        ///< Quote time (Line Time), trade time for trade quote.
 };
 
 /// @brief Quotes container.
 typedef std::vector<QuoteInfo> Quotes;
 
+/// @brief Compact symbol identifier assigned once symbol is subscribed.
+///        Stays the same for given full symbol name during facade instance lifetime.
+typedef unsigned SymbolId;
+
+static const SymbolId InvalidSymbolId = static_cast<SymbolId>(-1);
+
 /// @brief Resolved symbol information.
 struct SymbolInfo
 {
+   SymbolInfo(): id(InvalidSymbolId), tickSize(0.0), tickValue(0.0)
+   {}
+
+   SymbolId id;           ///< Symbol identifier.
    CString fullName;      ///< Full CQG symbol name.
+   Price tickSize;        ///< Minimal price increment, provided by IAPIEvents::OnSymbolSubscribed() only.
+   MoneyAmount tickValue; ///< Money value of one tick, provided by IAPIEvents::OnSymbolSubscribed() only.
    Quotes lastQuotes;     ///< Last symbol quotes - BBA & trade.
 };
 
+/// @brief Symbol quotes update, doesn't need any heap allocation.
+struct QuoteEvent
+{
+   enum { MaxQuotes = QuoteInfo::Low };   ///< One quote per each known quote type.
+
+   /// @brief Returns changedMask bit of given quote type.
+   static unsigned TypeMask(const QuoteInfo::Type type)
+   {
+      return 1u << type;
+   }
+
+   SymbolId symbolId;             ///< Symbol identifier, see IAPIFacade::GetSymbolName().
+   unsigned count;                ///< Number of valid quotes.
+   unsigned changedMask;          ///< Types of quotes present in this event, see TypeMask().
+   QuoteInfo quotes[MaxQuotes];   ///< Changed quotes.
+};
+
+/// @brief Market depth price level.
+struct DepthLevel
+{
+   Price price;           ///< Level price.
+   Volume volume;         ///< Level volume.
+};
+
+/// @brief Market depth (DOM) snapshot, doesn't need any heap allocation.
+struct MarketDepth
+{
+   enum { MaxLevels = 10 };   ///< Maximum number of levels per side.
+
+   SymbolId symbolId;                 ///< Symbol identifier.
+   unsigned bidsCount;                ///< Number of valid bid levels.
+   unsigned asksCount;                ///< Number of valid ask levels.
+   DepthLevel bids[MaxLevels];        ///< Bid levels, best (highest price) first.
+   DepthLevel asks[MaxLevels];        ///< Ask levels, best (lowest price) first.
+};
+
+/// @brief Single market depth level change.
+struct DepthChange
+{
+   bool bid;              ///< True if bid level changed, false if ask level changed.
+   Price price;           ///< Level price.
+   Volume volume;         ///< New level volume, zero if level is removed.
+};
+
+/// @brief Market depth changes since previous update of the symbol.
+struct DepthUpdate
+{
+   enum { MaxChanges = 4 * MarketDepth::MaxLevels };   ///< Every level of both sides removed & added.
+
+   SymbolId symbolId;                 ///< Symbol identifier.
+   unsigned count;                    ///< Number of valid changes.
+   DepthChange changes[MaxChanges];   ///< Changes, removed levels go first.
+};
+
+/// @brief Symbol market data subscription level, see IAPIFacade::SetSubscriptionLevel().
+enum SubscriptionLevel
+{
+   NoQuotesLevel,         ///< Symbol stays subscribed, but no market data is received.
+   TradesLevel,           ///< Trades only.
+   TradesAndBBALevel,     ///< Trades & best bid/ask, default.
+   TradesAndDOMLevel      ///< Trades, best bid/ask & market depth, default if FacadeSettings::marketDepth is set.
+};
+
+/// @brief What to do with new quote update when dispatch queue is full, see FacadeSettings::dispatchThreads.
+///        Other events are queued separately and CQGCEL thread always waits for free space for them.
+enum OverflowPolicy
+{
+   BlockOnOverflow,       ///< CQGCEL thread waits until queue has free space.
+   DropOldestOnOverflow,  ///< The oldest queued quote update is dropped.
+   ConflateOnOverflow     ///< Quote updates are conflated per symbol, so queue never overflows.
+};
+
+/// @brief Facade behavior settings, see IAPIFacade::Initialize().
+struct FacadeSettings
+{
+   FacadeSettings():
+      quoteEvents(false),
+      deltaQuotes(false),
+      conflateQuotes(false),
+      marketDepth(false),
+      dispatchThreads(0),
+      dispatchQueueSize(65536),
+      overflowPolicy(BlockOnOverflow),
+      barMemoryCacheSize(0),
+      maxBarsRequests(0),
+      baseBarPeriodInMinutes(0),
+      fillEvents(false)
+   {}
+
+   /// True to deliver quote updates via IAPIEvents::OnQuoteEvent() instead of
+   /// IAPIEvents::OnSymbolQuote(), it avoids any heap allocations per quote update.
+   bool quoteEvents;
+
+   /// True to report only quotes which price or volume differ from last known symbol quotes,
+   /// trade quotes are reported if trade time differs too. Updates without any changes are not reported at all.
+   /// Use IAPIFacade::GetSymbolQuotes() to get full symbol quotes.
+   bool deltaQuotes;
+
+   /// True to conflate quote updates instead of delivering them from CQGCEL event handler.
+   /// Each symbol keeps at most one pending update merged from all updates received since
+   /// symbol was drained last time. Consumer is notified by IAPIEvents::OnQuotesPending()
+   /// and drains updates at its own pace by IAPIFacade::DrainQuotes(), so slow quote
+   /// processing never backs up CQGCEL & order events.
+   bool conflateQuotes;
+
+   /// True to subscribe symbols to market depth (DOM) besides BBA & trades. Facade maintains
+   /// order book of each symbol, reports its changes via IAPIEvents::OnDepthUpdate()
+   /// and provides current snapshot via IAPIFacade::GetMarketDepth().
+   bool marketDepth;
+
+   /// Number of worker threads delivering events to IAPIEvents, zero to deliver events directly
+   /// from CQGCEL event handlers (default). If set, CQGCEL handlers just convert & queue events,
+   /// so slow IAPIEvents implementation doesn't stall CQGCEL. Symbol subscription & quote updates of each symbol
+   /// are delivered by the same worker in order, all other events are delivered in order by the first worker
+   /// ahead of quote updates queued before them. Symbol subscription isn't ordered against events of other workers.
+   /// @note IAPIFacade methods still must be called from the thread which called IAPIFacade::Initialize().
+   unsigned dispatchThreads;
+
+   /// Capacity of each worker queue, rounded up to power of 2.
+   unsigned dispatchQueueSize;
+
+   /// What to do when worker events queue is full.
+   OverflowPolicy overflowPolicy;
+
+   /// Directory of timed bars cache, empty to disable cache (default). Bars received for requests
+   /// without BarsRequest::subscribe are kept in memory mapped file per symbol, intraday period & sessions filter.
+   /// Requests of already cached range get only bars since the last cached bar from CQGCEL, the rest is
+   /// served from cache, see Bars::cachedCount. Directory is created if it doesn't exist.
+   CString barCacheDirectory;
+
+   /// Max number of timed bars kept in memory, zero to disable memory cache (default).
+   /// Bars received for requests without BarsRequest::subscribe are kept as intervals per symbol,
+   /// intraday period & sessions filter. Requests of complete cached bars are served without CQGCEL,
+   /// requests contained in outstanding CQGCEL request wait for it instead of making new one,
+   /// see IAPIFacade::GetBarsCacheStats(). Least recently used series are dropped first.
+   unsigned barMemoryCacheSize;
+
+   /// Max number of outstanding CQGCEL timed bars requests, zero for no limit (default).
+   /// Requests over limit wait in facade queue, interactive ones ahead of backfill ones, see BarsRequest::priority.
+   /// Requests identical to outstanding or queued one share its result. Bars::queueMs & Bars::serviceMs
+   /// report time spent in queue & in CQGCEL. Subscribed requests are never queued, but count as outstanding.
+   unsigned maxBarsRequests;
+
+   /// Intraday period in minutes bars of coarser periods are derived from, zero to disable derivation (default).
+   /// Subscribed index range requests ending at the current bar with period multiple of this one share
+   /// single subscribed base period request per symbol & sessions filter. Their bars are aggregated
+   /// by facade and kept updated as base bars change, coarse bars never span session boundary.
+   /// Session boundary is base bars gap crossing a day or lasting an hour at least, shorter gaps keep bars alignment.
+   /// Request needing more bars than resolved base request has makes new bigger base request.
+   long baseBarPeriodInMinutes;
+
+   /// True to report order changes via IAPIEvents::OnFill() & IAPIEvents::OnOrderState() instead of
+   /// IAPIEvents::OnOrderChanged(). Only new & canceled fills are reported, numbered per order, and order state
+   /// carries changing fields only. Use IAPIFacade::GetOrder() to get full order state.
+   bool fillEvents;
+};
+
+/// @brief Events dispatching counters, see FacadeSettings::dispatchThreads.
+struct DispatchStats
+{
+   unsigned long long queued;     ///< Events put to queues.
+   unsigned long long delivered;  ///< Events delivered to IAPIEvents.
+   unsigned long long dropped;    ///< Events dropped on queue overflow.
+   unsigned long long conflated;  ///< Quote updates merged into already pending ones.
+   unsigned long long waits;      ///< Number of times CQGCEL thread waited for queue space.
+   unsigned depth;                ///< Current number of queued events.
+   unsigned maxDepth;             ///< Maximum number of queued events in single queue.
+   double avgLatencyUs;           ///< Average time from queueing to delivery start, microseconds.
+   double maxLatencyUs;           ///< Maximum time from queueing to delivery start, microseconds.
+};
+
+/// @brief Timed bars caching counters, see FacadeSettings::barMemoryCacheSize.
+struct BarsCacheStats
+{
+   unsigned long long requests;   ///< Bars requests served via memory cache.
+   unsigned long long hits;       ///< Requests served from memory without CQGCEL.
+   unsigned long long coalesced;  ///< Requests served by outstanding CQGCEL request made for other request.
+   unsigned long long misses;     ///< Requests which needed own CQGCEL request.
+   unsigned long long upstream;   ///< CQGCEL timed bars requests made, including retries of whole range & base requests.
+   unsigned long long derived;    ///< Requests derived from base period bars, see FacadeSettings::baseBarPeriodInMinutes.
+   unsigned bars;                 ///< Bars kept in memory.
+   unsigned series;               ///< Series kept in memory.
+};
+
 /// @brief Account information.
 struct AccountInfo
 {
@@ -71,6 +267,16 @@ struct PositionInfo
    MoneyAmount profitLoss; ///< Position Profit/Loss.
 };
 
+/// @brief Account totals of positions, see IAPIFacade::GetLocalAccountsProfitLoss().
+struct AccountProfitLoss
+{
+   ID gwAccountID;          ///< CQG Gateway account ID.
+   MoneyAmount ote;         ///< Open Trade Equity of all account positions.
+   MoneyAmount profitLoss;  ///< Realized Profit/Loss of all account positions.
+};
+
+typedef std::vector<AccountProfitLoss> AccountsProfitLoss;
+
 /// @brief Order fill information.
 struct FillInfo
 {
@@ -92,17 +298,60 @@ struct OrderInfo
    ID gwAccountID;          ///< CQG Gateway account ID of order.
    bool buy;                ///< True if order side is buy.
    bool final;              ///< True if order is not working anymore (completelly filled, cancelled or rejected).
+   bool modifyPending;      ///< True if order modification is sent but not acknowledged by gateway yet.
    Quantity quantity;       ///< Order quantity.
    Quantity filledQty;      ///< Order filled quantity.
    CString error;           ///< Last order error description, empty if no error.
-   Fills orderFills;        ///< Last order fills.
+   Fills orderFills;        ///< Legs of new or canceled order fill, empty if order change has no such fill.
    CString description;     ///< Order description, provided by user. Will be kept by CQG Gateway.
+   unsigned fillSeq;        ///< Sequence number of the last order fill, see FillEvent::fillSeq.
+};
+
+/// @brief New or canceled order fill leg, see FacadeSettings::fillEvents.
+struct FillEvent
+{
+   CString orderGuid;       ///< Order guid.
+   unsigned fillSeq;        ///< Order fill sequence number, 1 for the first fill. Legs of spread fill share it.
+   unsigned leg;            ///< Leg index of spread fill, 0 for outright fill.
+   FillInfo fill;           ///< Fill leg.
+};
+
+/// @brief Order state change without fills & order properties which never change, see FacadeSettings::fillEvents.
+struct OrderStateEvent
+{
+   CString orderGuid;       ///< Order guid.
+   GWOrderID gwOrderID;     ///< Gateway order ID, empty until gateway accepts order.
+   bool final;              ///< True if order is not working anymore.
+   bool modifyPending;      ///< True if order modification is not acknowledged yet.
+   Quantity quantity;       ///< Order quantity.
+   Quantity filledQty;      ///< Order filled quantity.
+   unsigned fillSeq;        ///< Sequence number of the last order fill reported by IAPIEvents::OnFill().
+   CString error;           ///< Last order error description, empty if no error.
 };
 
 /// @brief Used containers.
 typedef std::vector<AccountInfo> Accounts;
 typedef std::vector<PositionInfo> Positions;
 typedef std::vector<SymbolInfo> Symbols;
+typedef std::vector<CString> SymbolNames;
+
+/// @brief Symbols batch resolution result, see IAPIFacade::RequestSymbols().
+struct SymbolsBatch
+{
+   unsigned batchId;          ///< Batch identifier returned by IAPIFacade::RequestSymbols().
+   SymbolNames requested;     ///< Requested names of resolved symbols, in resolution order.
+   Symbols resolved;          ///< Resolved symbols, resolved[i] is resolution of requested[i].
+   SymbolNames failed;        ///< Symbols failed resolution.
+   double issueMs;            ///< Time spent requesting all symbols from CQGCEL, milliseconds.
+   double elapsedMs;          ///< Time from batch request to the last symbol resolution, milliseconds.
+};
+
+/// @brief Timed bars request priority, see FacadeSettings::maxBarsRequests.
+enum BarsPriority
+{
+   InteractiveBars,   ///< Bars user waits for, e.g. chart, default.
+   BackfillBars       ///< Bulk history loading, sent once no interactive requests are queued.
+};
 
 /// @brief Timed bars request definition.
 struct BarsRequest
@@ -117,6 +366,10 @@ struct BarsRequest
    long endIndex;                ///< Bars range end index.
    long intradayPeriodInMinutes; ///< Intraday period in minutes for bars, e.g. 60 for hourly bars.
    long sessionsFilter;          ///< Sessions filter. Special value 31 means all sessions, 0 means primary only.
+   bool subscribe;               ///< True to keep bars updated after request is resolved, see IAPIEvents::OnBarsUpdated().
+                                 ///< Bars without trades have InvalidPrice prices then, so indexes stay stable.
+                                 ///< Zero initialized if omitted in aggregate initialization.
+   BarsPriority priority;        ///< Request priority, InteractiveBars if omitted in aggregate initialization.
 };
 
 /// @brief Timed bar information.
@@ -127,6 +380,7 @@ struct BarInfo
    Price high;              ///< High price.
    Price low;               ///< Low price.
    Price close;             ///< Close price.
+   Volume volume;           ///< Actual traded volume.
 };
 
 typedef std::vector<BarInfo> BarInfos;
@@ -134,10 +388,52 @@ typedef std::vector<BarInfo> BarInfos;
 /// @brief Timed bars request result.
 struct Bars
 {
+   Bars(): requestedCount(0), cachedCount(0), queueMs(0.0), serviceMs(0.0)
+   {}
+
    CString requestGuid; ///< Timed bars request guid.
    CString error;       ///< Error description, empty if no error.
    long requestedCount; ///< Number of bars requested, may be greater than actually rceeived.
    BarInfos bars;       ///< Received bars.
+   long cachedCount;    ///< Number of leading bars served from bar cache, see FacadeSettings::barCacheDirectory.
+   double queueMs;      ///< Time request waited in facade queue, milliseconds, see FacadeSettings::maxBarsRequests.
+   double serviceMs;    ///< Time from sending request to CQGCEL to its result, milliseconds.
+};
+
+/// @brief Kind of subscribed bars change.
+enum BarsChange
+{
+   BarAdded,     ///< New bar appended to the end.
+   BarUpdated,   ///< Existing bar changed.
+   BarInserted,  ///< Bar inserted before existing bar with the same index.
+   BarRemoved    ///< Bar removed.
+};
+
+/// @brief Subscribed timed bars change, see BarsRequest::subscribe.
+struct BarsUpdate
+{
+   CString requestGuid; ///< Timed bars request guid.
+   BarsChange change;   ///< Kind of change.
+   long index;          ///< Index of changed bar in Bars::bars.
+   BarInfo bar;         ///< Added, updated or inserted bar, not set for removed bar.
+};
+
+/// @brief Kind of bars built by facade from trades, see IAPIFacade::RequestTradeBars().
+enum TradeBarsType
+{
+   TimeTradeBars,     ///< Bars of fixed time period, size is period in minutes.
+   TickTradeBars,     ///< Bars of fixed number of trades, size is number of trades.
+   VolumeTradeBars,   ///< Bars of fixed traded volume, size is volume.
+   RangeTradeBars     ///< Bars of fixed high - low range, size is range in price units.
+};
+
+/// @brief Trade bars request definition.
+struct TradeBarsRequest
+{
+   SymbolId symbolId;    ///< Subscribed symbol identifier.
+   TradeBarsType type;   ///< Kind of bars.
+   double size;          ///< Bar size, its meaning depends on type.
+   long maxBars;         ///< Max number of closed bars kept for IAPIFacade::GetTradeBars(), the oldest are dropped.
 };
 
 /// @class IAPIEvents
@@ -167,10 +463,27 @@ struct IAPIEvents
    /// @param symbol [in] symbol failed resolution.
    virtual void OnSymbolError(const CString& symbol) = 0;
 
+   /// @brief Called when all symbols of batch requested by IAPIFacade::RequestSymbols() are resolved or failed.
+   ///        Called after OnSymbolSubscribed() or OnSymbolError() of the last batch symbol.
+   /// @param batch [in] batch resolution result.
+   virtual void OnSymbolsBatchCompleted(const SymbolsBatch& /*batch*/) {}
+
    /// @brief Called when subscribed symbol quote update occured.
    /// @param symbol [in] symbol info.
    virtual void OnSymbolQuote(const SymbolInfo& symbol) = 0;
 
+   /// @brief Called when subscribed symbol quote update occured and FacadeSettings::quoteEvents is set.
+   /// @param quotes [in] changed quotes.
+   virtual void OnQuoteEvent(const QuoteEvent& /*quotes*/) {}
+
+   /// @brief Called when conflated quote updates become pending after all previous ones were drained,
+   ///        see FacadeSettings::conflateQuotes. Typically consumer schedules IAPIFacade::DrainQuotes() call.
+   virtual void OnQuotesPending() {}
+
+   /// @brief Called when subscribed symbol market depth changed and FacadeSettings::marketDepth is set.
+   /// @param update [in] changed levels, apply them in order to keep local copy of the book.
+   virtual void OnDepthUpdate(const DepthUpdate& /*update*/) {}
+
    /// @brief Called when general accounts reloading occured.
    ///        Note: usually it's occurred on startup after connection to Gateway is up.
    virtual void OnAccountsReloaded() = 0;
@@ -196,10 +509,28 @@ struct IAPIEvents
    /// @param order [in] order info.
    virtual void OnOrderChanged(const OrderInfo& order) = 0;
 
+   /// @brief Called when order gets new fill or its fill is canceled and FacadeSettings::fillEvents is set.
+   ///        Each leg of spread fill is reported separately, all legs precede order state change of the fill.
+   /// @param fill [in] fill leg.
+   virtual void OnFill(const FillEvent& /*fill*/) {}
+
+   /// @brief Called when order status update occurred and FacadeSettings::fillEvents is set.
+   /// @param state [in] order state.
+   virtual void OnOrderState(const OrderStateEvent& /*state*/) {}
+
    /// @brief Called when order status update occurred.
    /// @param bars [in] received bars info.
    virtual void OnBarsReceived(const Bars& bars) = 0;
 
+   /// @brief Called when subscribed bars changed after they had been received.
+   /// @param update [in] bars change, apply them in order to keep received bars in sync.
+   virtual void OnBarsUpdated(const BarsUpdate& /*update*/) {}
+
+   /// @brief Called when trade bar is closed, see IAPIFacade::RequestTradeBars().
+   /// @param requestGuid [in] trade bars request guid.
+   /// @param bar [in] closed bar.
+   virtual void OnTradeBarClosed(const CString& /*requestGuid*/, const BarInfo& /*bar*/) {}
+
    /// @brief Destructor, must be virtual.
    virtual ~IAPIEvents() {}
 };
@@ -250,6 +581,84 @@ private:
 /// @brief Available order types
 enum OrderType { Market, Limit, Stop, StopLimit };
 
+/// @brief Order ticket identifier, see IAPIFacade::PrepareOrderTicket().
+typedef unsigned OrderTicketId;
+static const OrderTicketId InvalidOrderTicketId = 0;
+
+/// @brief Order parameters resolved once & used by many orders, see IAPIFacade::PrepareOrderTicket().
+struct OrderTicket
+{
+   OrderTicket(): type(Limit), gwAccountID(0), buy(true), quantity(1)
+   {}
+
+   OrderType type;           ///< Order type.
+   ID gwAccountID;           ///< Gateway account ID to place orders.
+   CString symbolFullName;   ///< CQG symbol full name to place orders.
+   bool buy;                 ///< True if orders side is buy.
+   Quantity quantity;        ///< Default order quantity.
+   CString description;      ///< Orders user description.
+};
+
+/// @brief Order of orders batch, see IAPIFacade::PlaceOrders().
+struct OrderRequest
+{
+   OrderRequest(): type(Limit), gwAccountID(0), buy(true), quantity(1)
+   {}
+
+   OrderType type;              ///< Order type.
+   ID gwAccountID;              ///< Gateway account ID to place order.
+   CString symbolFullName;      ///< CQG symbol full name to place order.
+   bool buy;                    ///< True if order side is buy.
+   Quantity quantity;           ///< Order quantity.
+   CString description;         ///< Order user description.
+   OrderPrice price;            ///< Limit or stop price, see IAPIFacade::PlaceOrder().
+   OrderPrice stopLimitPrice;   ///< Limit price of stop limit order.
+};
+
+typedef std::vector<OrderRequest> OrderRequests;
+typedef std::vector<CString> OrderGuids;
+
+/// @brief Result of single order of orders batch.
+struct OrderResult
+{
+   CString orderGuid;   ///< Order guid, empty if order placing failed.
+   CString error;       ///< Error description, empty if no error.
+};
+
+typedef std::vector<OrderResult> OrderResults;
+
+/// @brief Order batches latency counters of one batch kind.
+struct OrderBatchLatency
+{
+   unsigned long long batches;   ///< Number of batches.
+   unsigned long long orders;    ///< Number of orders in batches.
+   unsigned long long failed;    ///< Number of orders failed.
+   double lastBatchUs;           ///< The last batch time, microseconds.
+   double avgBatchUs;            ///< Average batch time, microseconds.
+   double maxBatchUs;            ///< Maximum batch time, microseconds.
+   double avgOrderUs;            ///< Average time per order, microseconds.
+};
+
+/// @brief Order batches latency counters, see IAPIFacade::GetOrderBatchStats().
+struct OrderBatchStats
+{
+   OrderBatchLatency place;    ///< IAPIFacade::PlaceOrders() batches.
+   OrderBatchLatency cancel;   ///< IAPIFacade::CancelOrders() batches.
+};
+
+/// @brief Order modifications counters, see IAPIFacade::GetOrderModifyStats().
+struct OrderModifyStats
+{
+   unsigned long long requested;      ///< Number of modifications sent.
+   unsigned long long acknowledged;   ///< Number of modifications acknowledged, including rejected ones
+                                      ///< and ones of orders became final meanwhile.
+   unsigned long long rejected;       ///< Number of modifications acknowledged with order error.
+   unsigned pending;                  ///< Number of modifications not acknowledged yet.
+   double lastAckUs;                  ///< The last modify-to-ack time, microseconds.
+   double avgAckUs;                   ///< Average modify-to-ack time, microseconds.
+   double maxAckUs;                   ///< Maximum modify-to-ack time, microseconds.
+};
+
 /// @brief facade version numbers.
 struct FacadeVersion
 {
@@ -257,6 +666,29 @@ struct FacadeVersion
    unsigned char m_minor;
 };
 
+/// @brief Simulated CQGCEL backend settings, see IAPIFacade::CreateSimulated().
+///        Simulation is deterministic: same settings and same calls produce the same events.
+struct SimulationSettings
+{
+   SimulationSettings():
+      seed(1),
+      accountsCount(1),
+      startPrice(100.0),
+      tickSize(0.01),
+      tradeRatio(4),
+      quoteIntervalMs(10),
+      startTime(42048.375) // 13-Feb-2015 09:00
+   {}
+
+   unsigned seed;            ///< Pseudo random generator seed.
+   unsigned accountsCount;   ///< Number of simulated Gateway accounts.
+   Price startPrice;         ///< Initial price of every simulated instrument.
+   Price tickSize;           ///< Price tick size of every simulated instrument.
+   unsigned tradeRatio;      ///< Every n-th simulated quote update is trade, others are best bid/ask.
+   unsigned quoteIntervalMs; ///< Line Time advance per simulated quote update in milliseconds.
+   COleDateTime startTime;   ///< Initial simulated Line Time.
+};
+
 /// @brief Checks is date/time object has valid status.
 inline bool IsValidDateTime(const COleDateTime& dateTime)
 {
@@ -271,6 +703,12 @@ struct IAPIFacade
    /// @return IAPIFacade instance.
    static IAPIFacadePtr Create();
 
+   /// @brief Creates IAPIFacade instance working on top of simulated in-process CQGCEL.
+   ///        Doesn't need CQGIC, can be used for benchmarking & load testing on any platform.
+   /// @param settings [in] simulation settings.
+   /// @return IAPIFacade instance.
+   static IAPIFacadePtr CreateSimulated(const SimulationSettings& settings = SimulationSettings());
+
    /// @brief Gets IAPIFacade version.
    /// @return IAPIFacade version.
    static FacadeVersion GetVersion();
@@ -285,18 +723,128 @@ struct IAPIFacade
 
    /// @brief Initializes & starts CQG API, then subscribes to events.
    /// @param events [in] events listener.
-   virtual bool Initialize(IAPIEvents* events) = 0;
+   /// @param settings [in] facade behavior settings.
+   virtual bool Initialize(IAPIEvents* events, const FacadeSettings& settings = FacadeSettings()) = 0;
+
+   /// @brief Delivers pending CQGCEL events to events listener.
+   ///        Real CQGCEL delivers events via thread message loop, so it's no-op for instance
+   ///        created by Create(). Simulated CQGCEL generates market data on each call.
+   /// @param maxEvents [in] maximum number of events to deliver.
+   /// @return Number of events delivered.
+   virtual unsigned PumpEvents(unsigned maxEvents) = 0;
+
+   /// @brief Delivers pending conflated quote updates, see FacadeSettings::conflateQuotes.
+   ///        Updates are delivered via OnQuoteEvent() or OnSymbolQuote() on calling thread,
+   ///        in order symbols received their first update since previous drain.
+   /// @param maxSymbols [in] maximum number of symbols to deliver updates for.
+   /// @return Number of delivered updates.
+   /// @note Can be called from any thread, but not concurrently.
+   virtual unsigned DrainQuotes(unsigned maxSymbols) = 0;
+
+   /// @brief Gets events dispatching counters.
+   /// @param stats [out] counters, all zero if events are delivered directly.
+   virtual void GetDispatchStats(DispatchStats& stats) = 0;
 
    /// @brief Requests symbol resolution & market data.
    /// @param symbol [in] symbol to resolve
    ///        Note: it can differ from full name, e.g. "EP" will be re.solved to something like "F.US.EPH5".
    virtual bool RequestSymbol(const CString& symbol) = 0;
 
+   /// @brief Requests resolution & market data of several symbols at once.
+   ///        All symbols are requested without waiting for resolution of previous ones,
+   ///        OnSymbolSubscribed() or OnSymbolError() is called per each symbol as usual
+   ///        and OnSymbolsBatchCompleted() is called once all of them are done.
+   ///        Duplicate symbols are requested once.
+   /// @param symbols [in] symbols to resolve.
+   /// @return Batch identifier or zero if failed. If some symbols can't be requested, they're
+   ///         reported as failed and the last error describes the failure.
+   virtual unsigned RequestSymbols(const SymbolNames& symbols) = 0;
+
+   /// @brief Releases symbol subscription. Every resolved symbol request made by RequestSymbol()
+   ///        or RequestSymbols() holds one reference to symbol subscription, market data is stopped
+   ///        once the last reference is released. Symbol identifier stays the same if symbol is requested again.
+   /// @param symbolId [in] symbol identifier.
+   /// @return False if symbol is not subscribed or CQGCEL failed to remove it.
+   virtual bool UnsubscribeSymbol(const SymbolId symbolId) = 0;
+
+   /// @brief Changes market data subscription level of subscribed symbol, it's shared by all references.
+   ///        Market depth is maintained for symbols subscribed at TradesAndDOMLevel only.
+   /// @param symbolId [in] symbol identifier.
+   /// @param level [in] new subscription level.
+   /// @return False if symbol is not subscribed or CQGCEL failed to change the level.
+   virtual bool SetSubscriptionLevel(const SymbolId symbolId, const SubscriptionLevel level) = 0;
+
+   /// @brief Gets number of symbols having at least one subscription reference.
+   virtual unsigned GetSubscribedSymbolsCount() = 0;
+
+   /// @brief Gets identifier of subscribed symbol.
+   /// @param symbolFullName [in] CQG symbol full name.
+   /// @return Symbol identifier or InvalidSymbolId if symbol is not subscribed.
+   virtual SymbolId GetSymbolId(const CString& symbolFullName) = 0;
+
+   /// @brief Gets full name of subscribed symbol.
+   /// @param symbolId [in] symbol identifier.
+   /// @return CQG symbol full name or empty string if identifier is unknown.
+   virtual CString GetSymbolName(const SymbolId symbolId) = 0;
+
+   /// @brief Gets last known quotes of subscribed symbol, all quote types received so far.
+   /// @param symbolId [in] symbol identifier.
+   /// @param quotes [out] symbol quotes, changedMask has bits of all present quote types.
+   /// @return True if symbol identifier is known.
+   virtual bool GetSymbolQuotes(const SymbolId symbolId, QuoteEvent& quotes) = 0;
+
+   /// @brief Gets current market depth of subscribed symbol, see FacadeSettings::marketDepth.
+   ///        Snapshot is kept ready, so it's just a copy of fixed size arrays.
+   /// @param symbolId [in] symbol identifier.
+   /// @param depth [out] market depth snapshot.
+   /// @return True if symbol market depth is known.
+   /// @note Can be called from any thread, e.g. from dispatch worker thread.
+   virtual bool GetMarketDepth(const SymbolId symbolId, MarketDepth& depth) = 0;
+
    /// @brief Requests timed bars.
    /// @param barsRequest [in] bars request definition.
    /// @return Placed bar request guid or empty string if failed.
    virtual CString RequestBars(const BarsRequest& barsRequest) = 0;
 
+   /// @brief Gets current bars of subscribed bars request, see BarsRequest::subscribe.
+   ///        Facade keeps bars in sync with all changes reported via IAPIEvents::OnBarsUpdated().
+   /// @param requestGuid [in] bars request guid.
+   /// @param bars [out] current bars.
+   /// @return False if request is not subscribed or not resolved yet.
+   /// @note Can be called from any thread, e.g. from dispatch worker thread.
+   virtual bool GetBars(const CString& requestGuid, Bars& bars) = 0;
+
+   /// @brief Stops updates of subscribed bars request and releases its bars.
+   /// @param requestGuid [in] bars request guid.
+   virtual bool CancelBars(const CString& requestGuid) = 0;
+
+   /// @brief Gets timed bars caching counters.
+   /// @param stats [out] counters, all zero if memory cache is disabled.
+   virtual void GetBarsCacheStats(BarsCacheStats& stats) = 0;
+
+   /// @brief Starts building bars from trades of subscribed symbol, no CQGCEL bars request is made.
+   ///        Request holds symbol subscription reference until CancelTradeBars(), see UnsubscribeSymbol().
+   ///        Each new trade of symbol quote updates is added to its bars in O(1), closed bars are reported
+   ///        via IAPIEvents::OnTradeBarClosed(). Time bars start at multiples of period since midnight,
+   ///        they are closed by the first trade after their end, periods without trades have no bars.
+   ///        Volume bar is closed by trade reaching its volume, the trade is not split between bars.
+   ///        Range bar is closed by trade which would exceed its range, the trade opens the next bar.
+   /// @param request [in] trade bars request definition.
+   /// @return Trade bars request guid or empty string if failed.
+   /// @note Consecutive trades of the same price, volume & time are not distinguishable in quote updates.
+   virtual CString RequestTradeBars(const TradeBarsRequest& request) = 0;
+
+   /// @brief Gets kept closed bars followed by current bar, if any.
+   /// @param requestGuid [in] trade bars request guid.
+   /// @param bars [out] bars.
+   /// @return False if request is unknown.
+   /// @note Can be called from any thread, e.g. from dispatch worker thread.
+   virtual bool GetTradeBars(const CString& requestGuid, Bars& bars) = 0;
+
+   /// @brief Stops building trade bars and releases them.
+   /// @param requestGuid [in] trade bars request guid.
+   virtual bool CancelTradeBars(const CString& requestGuid) = 0;
+
    /// @brief Performs logon to CQG Gateway with given user and password.
    /// @param user [in] user name.
    /// @param password [in] password.
@@ -316,9 +864,32 @@ struct IAPIFacade
    /// @param positions [out] open positions.
    virtual bool GetPositions(const ID& gwAccountID, Positions& positions) = 0;
 
+   /// @brief Gets account positions kept by facade without CQGCEL, can be called from any thread.
+   ///        Positions are loaded when CQGCEL reloads them, then updated by order fills and marked to market
+   ///        on each bid, ask or trade update of subscribed position symbol. Long positions are marked at bid,
+   ///        short ones at ask. Until symbol quotes arrive, positions are marked at the last fill price
+   ///        or at price implied by reloaded OTE. OTE & P/L are in money by symbol tick value. P/L of fills booked
+   ///        before symbol is subscribed is kept in price points until symbol tick value is known.
+   /// @param gwAccountID [in] Gateway account ID to get positions.
+   /// @param positions [out] positions including flat ones with realized P/L.
+   /// @return False if account has no positions.
+   virtual bool GetLocalPositions(const ID& gwAccountID, Positions& positions) = 0;
+
+   /// @brief Gets account totals of positions GetLocalPositions() returns, can be called from any thread.
+   /// @param ote [out] Open Trade Equity of all account positions.
+   /// @param profitLoss [out] realized Profit/Loss of all account positions.
+   /// @return False if account has no positions.
+   virtual bool GetLocalProfitLoss(const ID& gwAccountID, MoneyAmount& ote, MoneyAmount& profitLoss) = 0;
+
+   /// @brief Gets totals of all accounts having local positions by single vectorized pass over positions,
+   ///        can be called from any thread.
+   /// @param accounts [out] OTE & P/L of each account.
+   virtual void GetLocalAccountsProfitLoss(AccountsProfitLoss& accounts) = 0;
+
    /// @brief Requests number of all working orders for given account.
    /// @param gwAccountID [in] account ID. If zero orders for all accounts are counted.
    /// @return Number of all working orders.
+   /// @note Orders are counted as they change state, so counting takes constant time.
    virtual int GetAllWorkingOrdersCount(const ID& gwAccountID = ID()) = 0;
 
    /// @brief Requests number of working orders placed by this CQG API instance for given account.
@@ -326,6 +897,12 @@ struct IAPIFacade
    /// @return Number of internal working orders.
    virtual int GetInternalWorkingOrdersCount(const ID& gwAccountID = ID()) = 0;
 
+   /// @brief Requests number of working orders of given symbol.
+   /// @param symbolFullName [in] symbol full name.
+   /// @param internalOnly [in] true to count orders placed by this CQG API instance only.
+   /// @return Number of working orders.
+   virtual int GetSymbolWorkingOrdersCount(const CString& symbolFullName, bool internalOnly = false) = 0;
+
    /// @brief Places DAY order.
    /// @param gwAccountID [in] Gateway account ID to place order.
    /// @param symbol [in] CQG symbol full name to place order.
@@ -343,11 +920,79 @@ struct IAPIFacade
       const OrderPrice& price = OrderPrice(),
       const OrderPrice& stopLimitPrice = OrderPrice()) = 0;
 
+   /// @brief Prepares order ticket: checks parameters, resolves account & symbol and converts description once,
+   ///        so orders are submitted with price & quantity only, e.g. right from IAPIEvents::OnSymbolQuote().
+   /// @param ticket [in] orders parameters.
+   /// @return Ticket identifier or InvalidOrderTicketId if failed.
+   virtual OrderTicketId PrepareOrderTicket(const OrderTicket& ticket) = 0;
+
+   /// @brief Places order of prepared ticket.
+   /// @param ticketId [in] ticket identifier.
+   /// @param price [in] limit or stop price, not used by market orders.
+   /// @param quantity [in] order quantity, zero for ticket quantity.
+   /// @param stopLimitPrice [in] limit price of stop limit order.
+   /// @return Placed order guid or empty string if failed.
+   virtual CString SubmitOrderTicket(
+      OrderTicketId ticketId,
+      const OrderPrice& price,
+      Quantity quantity = 0,
+      const OrderPrice& stopLimitPrice = OrderPrice()) = 0;
+
+   /// @brief Drops prepared ticket, orders placed by it are not affected.
+   ///        Slot of released ticket is reused by tickets prepared later, but under new identifier,
+   ///        so released identifier stays unknown.
+   /// @return False if ticket is unknown.
+   virtual bool ReleaseOrderTicket(OrderTicketId ticketId) = 0;
+
+   /// @brief Places batch of orders by single call, accounts, symbols & descriptions shared by orders
+   ///        are resolved & converted once per batch.
+   /// @param orders [in] orders to place.
+   /// @param results [out] one result per order, in orders order.
+   /// @return Number of orders placed.
+   virtual unsigned PlaceOrders(const OrderRequests& orders, OrderResults& results) = 0;
+
+   /// @brief Cancels batch of orders by single call.
+   /// @param orderGuids [in] guids of orders to cancel.
+   /// @param results [out] one result per order, in guids order.
+   /// @return Number of orders cancel was requested for.
+   virtual unsigned CancelOrders(const OrderGuids& orderGuids, OrderResults& results) = 0;
+
+   /// @brief Gets PlaceOrders() & CancelOrders() latency counters.
+   virtual void GetOrderBatchStats(OrderBatchStats& stats) = 0;
+
    /// @brief Cancels order with given guid.
    /// @param orderGuid [in] order guid.
    /// @return True if order can be canceled, false otherwise.
    virtual bool CancelOrder(const CString& orderGuid) = 0;
 
+   /// @brief Modifies working order in place, without cancel & replace, so order keeps its queue position
+   ///        where exchange allows it. Order reports OrderInfo::modifyPending until gateway acknowledges
+   ///        modification, another modification can't be sent meanwhile.
+   /// @param orderGuid [in] order guid.
+   /// @param price [in] new limit or stop price, not initialized to keep current one.
+   /// @param stopLimitPrice [in] new limit price of stop limit order, not initialized to keep current one.
+   /// @param quantity [in] new order quantity exceeding filled quantity, zero to keep current one.
+   /// @return True if modification is sent, false otherwise.
+   virtual bool ModifyOrder(
+      const CString& orderGuid,
+      const OrderPrice& price,
+      const OrderPrice& stopLimitPrice = OrderPrice(),
+      Quantity quantity = 0) = 0;
+
+   /// @brief Gets ModifyOrder() counters & modify-to-ack latency.
+   virtual void GetOrderModifyStats(OrderModifyStats& stats) = 0;
+
+   /// @brief Gets the last known state of order placed by this instance or reported by IAPIEvents::OnOrderChanged().
+   /// @param orderGuid [in] order guid.
+   /// @param order [out] order state.
+   /// @return False if order is unknown, only the latest 10000 final orders are known.
+   /// @note Can be called from any thread, e.g. from dispatch worker thread.
+   virtual bool GetOrder(const CString& orderGuid, OrderInfo& order) = 0;
+
+   /// @brief Gets the last known state of order by its gateway order ID, see GetOrder().
+   /// @return False if order is unknown or not accepted by gateway yet.
+   virtual bool GetOrderByGwOrderID(const GWOrderID& gwOrderID, OrderInfo& order) = 0;
+
    /// @brief Cancels all orders within given account and symbol.
    /// @param gwAccountID [in] account ID. If zero orders for all accounts are canceled.
    /// @param symbolFullName [in] symbol name. If empty orders for all symbols are canceled.
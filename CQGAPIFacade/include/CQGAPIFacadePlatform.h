@@ -0,0 +1,171 @@
+/// @file CQGAPIFacadePlatform.h
+/// @brief Simple C++ facade for CQG API - platform dependent types.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+///
+/// Windows builds use MFC CString & COleDateTime as before.
+/// Other platforms (or Windows builds with CQGAPIFACADE_PORTABLE defined) get minimal
+/// stand-ins implementing the subset of CString & COleDateTime used by the facade,
+/// so facade core & simulated CQGCEL backend can be built and profiled without MFC/ATL.
+
+#pragma once
+
+#if defined(_WIN32) && !defined(CQGAPIFACADE_PORTABLE)
+#define CQGAPIFACADE_USE_MFC 1
+#endif
+
+#ifdef CQGAPIFACADE_USE_MFC
+
+#include <afx.h>
+#include <atlcomtime.h>
+
+namespace cqg
+{
+
+using ::CString;
+using ::COleDateTime;
+using ::DATE;
+
+} // namespace cqg
+
+#else // CQGAPIFACADE_USE_MFC
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+namespace cqg
+{
+
+/// @brief OLE Automation date, days since 30-Dec-1899.
+typedef double DATE;
+
+/// @class CString
+/// @brief Portable stand-in for MFC CString, only members used by facade are provided.
+class CString
+{
+public:
+
+   CString()
+   {}
+
+   explicit CString(const char* str): m_str(str ? str : "")
+   {}
+
+   explicit CString(const std::string& str): m_str(str)
+   {}
+
+   CString& operator=(const char* str)
+   {
+      m_str = str ? str : "";
+      return *this;
+   }
+
+   CString& operator+=(const CString& rhs)
+   {
+      m_str += rhs.m_str;
+      return *this;
+   }
+
+   CString& operator+=(const char* rhs)
+   {
+      m_str += rhs;
+      return *this;
+   }
+
+   bool operator==(const CString& rhs) const { return m_str == rhs.m_str; }
+   bool operator==(const char* rhs) const { return m_str == rhs; }
+   bool operator!=(const CString& rhs) const { return m_str != rhs.m_str; }
+   bool operator!=(const char* rhs) const { return m_str != rhs; }
+   bool operator<(const CString& rhs) const { return m_str < rhs.m_str; }
+
+   operator const char*() const { return m_str.c_str(); }
+
+   const char* GetString() const { return m_str.c_str(); }
+
+   int GetLength() const { return static_cast<int>(m_str.size()); }
+
+   bool IsEmpty() const { return m_str.empty(); }
+
+   int Find(char ch) const
+   {
+      const std::string::size_type pos = m_str.find(ch);
+      return pos == std::string::npos ? -1 : static_cast<int>(pos);
+   }
+
+   void Empty() { m_str.clear(); }
+
+   void Format(const char* format, ...)
+   {
+      char buffer[512];
+
+      va_list args;
+      va_start(args, format);
+      const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+      va_end(args);
+
+      if(length < 0)
+      {
+         m_str.clear();
+      }
+      else if(static_cast<size_t>(length) < sizeof(buffer))
+      {
+         m_str.assign(buffer, length);
+      }
+      else
+      {
+         m_str.resize(length + 1);
+
+         va_start(args, format);
+         vsnprintf(&m_str[0], m_str.size(), format, args);
+         va_end(args);
+
+         m_str.resize(length);
+      }
+   }
+
+   friend CString operator+(const CString& lhs, const CString& rhs)
+   {
+      return CString(lhs.m_str + rhs.m_str);
+   }
+
+   friend CString operator+(const CString& lhs, const char* rhs)
+   {
+      return CString(lhs.m_str + rhs);
+   }
+
+   friend CString operator+(const char* lhs, const CString& rhs)
+   {
+      return CString(lhs + rhs.m_str);
+   }
+
+private:
+   std::string m_str;
+};
+
+/// @class COleDateTime
+/// @brief Portable stand-in for ATL COleDateTime, only members used by facade are provided.
+class COleDateTime
+{
+public:
+
+   enum DateTimeStatus { valid = 0, invalid = 1, null = 2 };
+
+   COleDateTime(): m_dt(0.0), m_status(valid)
+   {}
+
+   COleDateTime(DATE dt): m_dt(dt), m_status(valid)
+   {}
+
+   DateTimeStatus GetStatus() const { return m_status; }
+
+   void SetStatus(DateTimeStatus status) { m_status = status; }
+
+   DATE m_dt;               ///< Date/time value.
+   DateTimeStatus m_status; ///< Date/time status.
+};
+
+} // namespace cqg
+
+#endif // CQGAPIFACADE_USE_MFC
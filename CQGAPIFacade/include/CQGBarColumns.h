@@ -0,0 +1,188 @@
+/// @file CQGBarColumns.h
+/// @brief Simple C++ facade for CQG API - columnar timed bars & vectorized bar kernels.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+///
+/// BarInfos keep every bar field together, so scanning single field (e.g. all closes)
+/// loads whole bars. BarColumns keep each field in its own contiguous aligned array,
+/// kernels below process them with SSE2 where available.
+/// Kernels expect valid prices, filter out bars with InvalidPrice prices first.
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace cqg
+{
+
+/// @class AlignedAllocator
+/// @brief Allocator giving memory aligned by Alignment bytes, so SIMD loads never split cache lines.
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+   typedef T value_type;
+   typedef T* pointer;
+   typedef const T* const_pointer;
+   typedef T& reference;
+   typedef const T& const_reference;
+   typedef size_t size_type;
+   typedef ptrdiff_t difference_type;
+
+   template <typename U>
+   struct rebind
+   {
+      typedef AlignedAllocator<U, Alignment> other;
+   };
+
+   AlignedAllocator()
+   {}
+
+   template <typename U>
+   AlignedAllocator(const AlignedAllocator<U, Alignment>&)
+   {}
+
+   T* allocate(size_t count)
+   {
+      // Original block address is kept just before aligned memory.
+      char* block = static_cast<char*>(::operator new(count * sizeof(T) + Alignment + sizeof(void*)));
+      const size_t address = reinterpret_cast<size_t>(block + sizeof(void*));
+      char* aligned = block + sizeof(void*) + (Alignment - address % Alignment) % Alignment;
+      reinterpret_cast<void**>(aligned)[-1] = block;
+      return reinterpret_cast<T*>(aligned);
+   }
+
+   void deallocate(T* ptr, size_t /*count*/)
+   {
+      if(ptr)
+      {
+         ::operator delete(reinterpret_cast<void**>(ptr)[-1]);
+      }
+   }
+
+   void construct(T* ptr, const T& value)
+   {
+      new(ptr) T(value);
+   }
+
+   void destroy(T* ptr)
+   {
+      ptr->~T();
+   }
+
+   size_t max_size() const
+   {
+      return (static_cast<size_t>(-1) - Alignment - sizeof(void*)) / sizeof(T);
+   }
+
+   bool operator==(const AlignedAllocator&) const { return true; }
+   bool operator!=(const AlignedAllocator&) const { return false; }
+};
+
+/// @brief Column of bar values.
+typedef std::vector<double, AlignedAllocator<double> > BarColumn;
+
+/// @class BarColumns
+/// @brief Timed bars stored as structure of arrays: timestamps, open, high, low, close & volume columns.
+class BarColumns
+{
+public:
+
+   BarColumns()
+   {}
+
+   /// @brief Creates columns of given bars.
+   explicit BarColumns(const BarInfos& bars)
+   {
+      Assign(bars);
+   }
+
+   /// @brief Replaces columns with given bars.
+   void Assign(const BarInfos& bars);
+
+   /// @brief Appends bar to the end.
+   void Append(const BarInfo& bar);
+
+   /// @brief Replaces bar at given index, see IAPIEvents::OnBarsUpdated().
+   void Set(size_t index, const BarInfo& bar);
+
+   /// @brief Gets bar at given index.
+   BarInfo Get(size_t index) const;
+
+   /// @brief Reserves memory for given number of bars.
+   void Reserve(size_t count);
+
+   /// @brief Removes all bars.
+   void Clear();
+
+   /// @brief Gets number of bars.
+   size_t Size() const
+   {
+      return m_close.size();
+   }
+
+   /// @name Column data, each has Size() values.
+   /// @{
+
+   const DATE* Timestamps() const { return data(m_timestamps); }
+   const Price* Open() const { return data(m_open); }
+   const Price* High() const { return data(m_high); }
+   const Price* Low() const { return data(m_low); }
+   const Price* Close() const { return data(m_close); }
+   const double* Volumes() const { return data(m_volume); }
+
+   /// @}
+
+private:
+
+   static const double* data(const BarColumn& column)
+   {
+      return column.empty() ? NULL : &column[0];
+   }
+
+   BarColumn m_timestamps;   ///< Bar timestamps.
+   BarColumn m_open;         ///< Open prices.
+   BarColumn m_high;         ///< High prices.
+   BarColumn m_low;          ///< Low prices.
+   BarColumn m_close;        ///< Close prices.
+   BarColumn m_volume;       ///< Volumes.
+};
+
+/// @brief Gets the highest high & the lowest low of bars range.
+/// @param bars [in] bars.
+/// @param first [in] first bar index.
+/// @param count [in] number of bars.
+/// @param high [out] the highest high.
+/// @param low [out] the lowest low.
+/// @return False if range is empty or out of bars.
+bool GetHighLow(const BarColumns& bars, size_t first, size_t count, Price& high, Price& low);
+
+/// @brief Calculates simple returns, returns[i] = values[i + 1] / values[i] - 1.
+/// @param values [in] values, e.g. close prices.
+/// @param count [in] number of values.
+/// @param returns [out] count - 1 returns.
+void GetReturns(const double* values, size_t count, double* returns);
+
+/// @brief Calculates rolling maximum over window of values ending at each value.
+///        The first window - 1 results cover all values so far. Takes O(count) for any window.
+/// @param values [in] values, e.g. high prices.
+/// @param count [in] number of values.
+/// @param window [in] window length, must be positive.
+/// @param result [out] count rolling maximums.
+void GetRollingMax(const double* values, size_t count, size_t window, double* result);
+
+/// @brief Calculates rolling minimum, see GetRollingMax().
+void GetRollingMin(const double* values, size_t count, size_t window, double* result);
+
+/// @brief Calculates true ranges, max(high, previous close) - min(low, previous close).
+///        The first bar true range is its high - low.
+/// @param bars [in] bars.
+/// @param result [out] bars.Size() true ranges.
+void GetTrueRanges(const BarColumns& bars, double* result);
+
+} // namespace cqg
@@ -0,0 +1,268 @@
+/// @file CQGIndicators.h
+/// @brief Simple C++ facade for CQG API - streaming technical indicators.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+///
+/// Indicators keep fixed memory and are updated in O(1) per bar or trade: Add() appends value,
+/// ReplaceLast() changes the last one, e.g. current bar updated by IAPIEvents::OnBarsUpdated().
+/// Init() computes state of bars history by vectorized kernels. Exponential averages need
+/// the most recent values only, as older values weigh less than double precision, so Init() cost
+/// doesn't grow with history length beyond that. Init() expects valid prices like BarColumns kernels,
+/// Add() & ReplaceLast() take bars without trades (InvalidPrice) as flat bars at the previous close.
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "CQGBarColumns.h"
+
+#include <vector>
+
+namespace cqg
+{
+
+/// @class RollingWindow
+/// @brief The latest values of fixed window with their sum & sum of squares.
+class RollingWindow
+{
+public:
+
+   /// @brief Creates window of given length, must be positive.
+   explicit RollingWindow(size_t period);
+
+   /// @brief Replaces values with the last window values of given ones.
+   void Init(const double* values, size_t count);
+
+   /// @brief Appends value, the oldest one leaves full window.
+   void Add(double value);
+
+   /// @brief Replaces the last value.
+   void ReplaceLast(double value);
+
+   /// @brief Removes all values.
+   void Clear();
+
+   /// @brief Gets number of values added since Init() or Clear(), including ones left window.
+   size_t Count() const { return m_count; }
+
+   /// @brief Gets number of values in window.
+   size_t Size() const { return m_count < m_values.size() ? m_count : m_values.size(); }
+
+   /// @brief Gets window length.
+   size_t Period() const { return m_values.size(); }
+
+   double Sum() const { return m_sum; }
+   double SumSquares() const { return m_sumSquares; }
+
+private:
+
+   /// @brief Recalculates sums, so rounding errors of running updates don't accumulate.
+   void recalculate();
+
+   std::vector<double> m_values;   ///< Ring buffer of window values.
+   size_t m_next;                  ///< Index of the next value in ring buffer.
+   size_t m_count;                 ///< Number of values added.
+   size_t m_updates;               ///< Number of running updates since sums were recalculated.
+   double m_sum;                   ///< Sum of window values.
+   double m_sumSquares;            ///< Sum of window values squares.
+};
+
+/// @class SMA
+/// @brief Simple moving average of close prices or any values.
+class SMA
+{
+public:
+
+   explicit SMA(size_t period): m_window(period), m_lastValue(0.0), m_previousValue(0.0)
+   {}
+
+   void Init(const double* values, size_t count);
+   void Init(const BarColumns& bars) { Init(bars.Close(), bars.Size()); }
+
+   void Add(double value);
+   void Add(const BarInfo& bar) { Add(bar.close != InvalidPrice ? bar.close : m_lastValue); }
+
+   void ReplaceLast(double value);
+   void ReplaceLast(const BarInfo& bar) { ReplaceLast(bar.close != InvalidPrice ? bar.close : m_previousValue); }
+
+   /// @brief Gets number of values added.
+   size_t Count() const { return m_window.Count(); }
+
+   /// @brief Checks whether full period of values is added.
+   bool IsReady() const { return m_window.Count() >= m_window.Period(); }
+
+   /// @brief Gets average of values so far, zero if there are none.
+   double Value() const;
+
+   /// @brief Gets window values.
+   const RollingWindow& Window() const { return m_window; }
+
+private:
+
+   RollingWindow m_window;   ///< Averaged values.
+   double m_lastValue;       ///< The last value.
+   double m_previousValue;   ///< Value before the last one.
+};
+
+/// @class EMA
+/// @brief Exponential moving average, smoothing 2 / (period + 1), seeded by the first value.
+class EMA
+{
+public:
+
+   explicit EMA(size_t period);
+
+   void Init(const double* values, size_t count);
+   void Init(const BarColumns& bars) { Init(bars.Close(), bars.Size()); }
+
+   void Add(double value);
+   void Add(const BarInfo& bar) { Add(bar.close != InvalidPrice ? bar.close : m_lastValue); }
+
+   void ReplaceLast(double value);
+   void ReplaceLast(const BarInfo& bar) { ReplaceLast(bar.close != InvalidPrice ? bar.close : m_previousValue); }
+
+   size_t Count() const { return m_count; }
+   bool IsReady() const { return m_count >= m_period; }
+   double Value() const { return m_value; }
+
+private:
+
+   size_t m_period;          ///< Averaging period.
+   double m_alpha;           ///< Smoothing factor.
+   size_t m_count;           ///< Number of values added.
+   double m_value;           ///< Current average.
+   double m_previous;        ///< Average before the last value.
+   double m_lastValue;       ///< The last value.
+   double m_previousValue;   ///< Value before the last one.
+};
+
+/// @class BollingerBands
+/// @brief Simple moving average of close prices with bands at given number of standard deviations.
+class BollingerBands
+{
+public:
+
+   BollingerBands(size_t period, double width): m_average(period), m_width(width)
+   {}
+
+   void Init(const double* values, size_t count) { m_average.Init(values, count); }
+   void Init(const BarColumns& bars) { m_average.Init(bars); }
+
+   void Add(double value) { m_average.Add(value); }
+   void Add(const BarInfo& bar) { m_average.Add(bar); }
+
+   void ReplaceLast(double value) { m_average.ReplaceLast(value); }
+   void ReplaceLast(const BarInfo& bar) { m_average.ReplaceLast(bar); }
+
+   size_t Count() const { return m_average.Count(); }
+   bool IsReady() const { return m_average.IsReady(); }
+
+   /// @brief Gets simple moving average.
+   double Middle() const { return m_average.Value(); }
+
+   /// @brief Gets population standard deviation of window values.
+   double Deviation() const;
+
+   double Upper() const { return Middle() + m_width * Deviation(); }
+   double Lower() const { return Middle() - m_width * Deviation(); }
+
+private:
+
+   SMA m_average;    ///< Moving average & its window.
+   double m_width;   ///< Bands width in standard deviations.
+};
+
+/// @class ATR
+/// @brief Average true range by Wilder's smoothing 1 / period, seeded by the first true range.
+class ATR
+{
+public:
+
+   explicit ATR(size_t period);
+
+   void Init(const BarColumns& bars);
+
+   void Add(const BarInfo& bar);
+   void ReplaceLast(const BarInfo& bar);
+
+   size_t Count() const { return m_count; }
+   bool IsReady() const { return m_count >= m_period; }
+   double Value() const { return m_value; }
+
+private:
+
+   /// @brief Gets true range of bar following bar with given close.
+   double getTrueRange(const BarInfo& bar, double previousClose) const;
+
+   size_t m_period;          ///< Averaging period.
+   double m_alpha;           ///< Smoothing factor.
+   size_t m_count;           ///< Number of bars added.
+   double m_value;           ///< Current average.
+   double m_previous;        ///< Average before the last bar.
+   double m_lastClose;       ///< The last bar close.
+   double m_previousClose;   ///< Close of bar before the last one.
+};
+
+/// @class VWAP
+/// @brief Volume weighted average price of trades or bar typical prices (high + low + close) / 3.
+///        Accumulates since Init() or Reset(), e.g. since session start.
+class VWAP
+{
+public:
+
+   VWAP()
+   {
+      Reset();
+   }
+
+   /// @brief Starts new accumulation.
+   void Reset();
+
+   void Init(const BarColumns& bars);
+
+   void Add(const BarInfo& bar);
+   void ReplaceLast(const BarInfo& bar);
+
+   /// @brief Adds trade, e.g. from trade quote update.
+   void AddTrade(Price price, Volume volume);
+
+   size_t Count() const { return m_count; }
+   bool IsReady() const { return m_volume > 0.0; }
+
+   /// @brief Gets average price, zero if there is no volume yet.
+   double Value() const { return m_volume > 0.0 ? m_priceVolume / m_volume : 0.0; }
+
+private:
+
+   size_t m_count;             ///< Number of bars or trades added.
+   double m_priceVolume;       ///< Sum of price * volume.
+   double m_volume;            ///< Sum of volume.
+   double m_lastPriceVolume;   ///< The last bar price * volume.
+   double m_lastVolume;        ///< The last bar volume.
+};
+
+/// @brief Applies subscribed bars change to bar indicator: adds new bar, replaces updated last bar
+///        or initializes indicator again for any other change.
+/// @param indicator [in, out] indicator following bars.
+/// @param update [in] bars change, see IAPIEvents::OnBarsUpdated().
+/// @param bars [in] bars with change already applied, see BarColumns::Append() & BarColumns::Set().
+template <typename Indicator>
+void ApplyBarsUpdate(Indicator& indicator, const BarsUpdate& update, const BarColumns& bars)
+{
+   const size_t index = static_cast<size_t>(update.index);
+
+   if(update.change == BarAdded && update.index >= 0 && index == indicator.Count())
+   {
+      indicator.Add(update.bar);
+   }
+   else if(update.change == BarUpdated && update.index >= 0 && index + 1 == indicator.Count())
+   {
+      indicator.ReplaceLast(update.bar);
+   }
+   else
+   {
+      indicator.Init(bars);
+   }
+}
+
+} // namespace cqg
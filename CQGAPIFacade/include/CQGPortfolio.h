@@ -0,0 +1,170 @@
+/// @file CQGPortfolio.h
+/// @brief Simple C++ facade for CQG API - columnar positions & vectorized portfolio mark-to-market.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+///
+/// PositionInfo keeps every position field together, so revaluing portfolio one position at a time
+/// loads whole positions with their symbol strings and writes new mark price into each of them.
+/// PortfolioColumns keep signed quantity, average price & realized P/L of all positions in their own aligned
+/// arrays with positions of the same account in adjacent rows. Mark prices & point values are kept once
+/// per symbol, each row refers to price its side is marked at, so quote update changes single price
+/// whatever number of positions symbol has, and totals of each account are single SSE2 pass over its rows
+/// gathering prices of their symbols. Kernels expect finite values, keep average prices of flat positions finite.
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "CQGBarColumns.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace cqg
+{
+
+/// @brief Column of positions or symbols values.
+typedef std::vector<double, AlignedAllocator<double> > PortfolioColumn;
+
+/// @brief Column of rows mark price indexes.
+typedef std::vector<unsigned, AlignedAllocator<unsigned> > PortfolioIndexColumn;
+
+/// @brief Position identifier in PortfolioColumns, see PortfolioColumns::Add().
+typedef size_t PositionHandle;
+
+/// @class PortfolioColumns
+/// @brief Positions of many accounts stored as structure of arrays, rows grouped by account.
+///        Symbols have two mark prices: one of long positions, e.g. bid, and one of short positions, e.g. ask.
+class PortfolioColumns
+{
+public:
+
+   PortfolioColumns()
+   {}
+
+   /// @brief Adds position row next to rows of the same account. Rows of accounts added later move,
+   ///        so adding takes O(rows), but positions are added rarely and updated in O(1).
+   /// @param symbolId [in] position symbol identifier.
+   /// @param quantity [in] signed position quantity, negative for short position.
+   /// @param averagePrice [in] position average price.
+   /// @return Position handle, valid until Clear().
+   PositionHandle Add(const ID& gwAccountID, SymbolId symbolId, double quantity, Price averagePrice);
+
+   /// @brief Sets position after fill, position side selects symbol price it's marked at.
+   /// @param profitLoss [in] realized position P/L.
+   void SetPosition(PositionHandle position, double quantity, Price averagePrice, MoneyAmount profitLoss);
+
+   /// @brief Sets prices symbol positions are marked to market at.
+   /// @param longMarkPrice [in] price of long positions.
+   /// @param shortMarkPrice [in] price of short positions.
+   void SetSymbolPrices(SymbolId symbolId, Price longMarkPrice, Price shortMarkPrice)
+   {
+      const size_t index = getMarkIndex(symbolId, false);
+      m_markPrice[index] = longMarkPrice;
+      m_markPrice[index + 1] = shortMarkPrice;
+   }
+
+   /// @brief Sets money value of one price point of symbol, 1 by default.
+   void SetSymbolPointValue(SymbolId symbolId, double pointValue)
+   {
+      const size_t index = getMarkIndex(symbolId, false);
+      m_pointValue[index] = pointValue;
+      m_pointValue[index + 1] = pointValue;
+   }
+
+   /// @name Single position values.
+   /// @{
+
+   SymbolId GetSymbolId(PositionHandle position) const { return m_markIndex[m_rows[position]] / 2; }
+   double GetQuantity(PositionHandle position) const { return m_quantity[m_rows[position]]; }
+   Price GetAveragePrice(PositionHandle position) const { return m_averagePrice[m_rows[position]]; }
+   Price GetMarkPrice(PositionHandle position) const { return m_markPrice[m_markIndex[m_rows[position]]]; }
+   double GetPointValue(PositionHandle position) const { return m_pointValue[m_markIndex[m_rows[position]]]; }
+   MoneyAmount GetProfitLoss(PositionHandle position) const { return m_profitLoss[m_rows[position]]; }
+
+   /// @brief Gets position Open Trade Equity.
+   MoneyAmount GetOte(PositionHandle position) const;
+
+   /// @}
+
+   /// @brief Gets account OTE & P/L totals by single vectorized pass over account rows.
+   /// @return False if account has no positions.
+   bool GetAccountProfitLoss(const ID& gwAccountID, AccountProfitLoss& result) const;
+
+   /// @brief Gets OTE & P/L totals of all accounts, in order accounts were added.
+   void GetAccountsProfitLoss(AccountsProfitLoss& result) const;
+
+   /// @brief Removes all positions, accounts & symbols.
+   void Clear();
+
+   /// @brief Gets number of positions.
+   size_t Size() const
+   {
+      return m_quantity.size();
+   }
+
+   /// @name Column data, position columns have Size() rows, rows of each account are adjacent.
+   ///       Row is marked at MarkPrices()[MarkIndexes()[row]] with PointValues()[MarkIndexes()[row]],
+   ///       symbol mark prices are at 2 * symbol identifier for long & the next index for short positions.
+   /// @{
+
+   const double* Quantities() const { return data(m_quantity); }
+   const Price* AveragePrices() const { return data(m_averagePrice); }
+   const unsigned* MarkIndexes() const { return m_markIndex.empty() ? NULL : &m_markIndex[0]; }
+   const MoneyAmount* ProfitLosses() const { return data(m_profitLoss); }
+   const Price* MarkPrices() const { return data(m_markPrice); }
+   const double* PointValues() const { return data(m_pointValue); }
+
+   /// @}
+
+private:
+
+   /// @brief Rows range of account.
+   struct AccountRows
+   {
+      ID gwAccountID;   ///< Gateway account ID.
+      size_t begin;     ///< The first account row.
+      size_t end;       ///< Row after the last account row.
+   };
+
+   typedef std::unordered_map<ID, size_t> AccountIndex;
+
+   static const double* data(const PortfolioColumn& column)
+   {
+      return column.empty() ? NULL : &column[0];
+   }
+
+   /// @brief Gets index of symbol mark price of position side, adds symbol if needed.
+   unsigned getMarkIndex(SymbolId symbolId, bool shortPosition);
+
+   /// @brief Gets account totals of rows range.
+   void getProfitLoss(const AccountRows& rows, AccountProfitLoss& result) const;
+
+   std::vector<AccountRows> m_accounts;       ///< Accounts rows in order accounts were added.
+   AccountIndex m_accountIndex;               ///< Index in m_accounts by gateway account ID.
+   std::vector<size_t> m_rows;                ///< Rows by position handle.
+   std::vector<PositionHandle> m_handles;     ///< Position handles by row.
+   PortfolioColumn m_quantity;                ///< Signed quantities.
+   PortfolioColumn m_averagePrice;            ///< Average prices.
+   PortfolioIndexColumn m_markIndex;          ///< Indexes of mark price & point value.
+   PortfolioColumn m_profitLoss;              ///< Realized P/L.
+   PortfolioColumn m_markPrice;               ///< Symbols long & short mark prices.
+   PortfolioColumn m_pointValue;              ///< Symbols point values, twice per symbol.
+};
+
+/// @brief Calculates Open Trade Equity of positions, sum of (mark - average) * quantity * point value.
+/// @param quantity [in] signed quantities.
+/// @param averagePrice [in] average prices.
+/// @param markIndex [in] indexes of position mark price & point value.
+/// @param markPrice [in] mark prices gathered by markIndex.
+/// @param pointValue [in] point values gathered by markIndex.
+/// @param count [in] number of positions.
+MoneyAmount GetOpenTradeEquity(
+   const double* quantity,
+   const Price* averagePrice,
+   const unsigned* markIndex,
+   const Price* markPrice,
+   const double* pointValue,
+   size_t count);
+
+} // namespace cqg
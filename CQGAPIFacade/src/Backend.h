@@ -0,0 +1,225 @@
+/// @file Backend.h
+/// @brief Simple C++ facade for CQG API - CQGCEL backend interface.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+
+#include <functional>
+#include <memory>
+
+namespace cqg
+{
+
+/// @brief Identity of the order last fill. CQGCEL reports the last fill with every order change,
+///        so fill is new only if its identity differs from one of previous change.
+struct FillKey
+{
+   FillKey(): id(0), status(0)
+   {}
+
+   FillKey(long fillId, int fillStatus): id(fillId), status(fillStatus)
+   {}
+
+   bool operator==(const FillKey& other) const
+   {
+      return id == other.id && status == other.status;
+   }
+
+   long id;       ///< Fill ID unique within order.
+   int status;    ///< Fill status, fill is reported again once it's canceled or busted.
+};
+
+/// @class IBackendEvents
+/// @brief CQGCEL events already converted to facade types.
+/// @note Implemented by facade core, backend must call it from single (CQGCEL) thread.
+struct IBackendEvents
+{
+   /// @brief CQGCEL data error or startup failure.
+   virtual void OnDataError(const CString& error) = 0;
+
+   /// @brief Market data connection state changed.
+   virtual void OnDataConnectionStatusChanged(const bool connected) = 0;
+
+   /// @brief CQG Gateway connection state changed.
+   virtual void OnGWConnectionStatusChanged(const bool connected) = 0;
+
+   /// @brief All accounts reloaded.
+   virtual void OnAccountsReloaded() = 0;
+
+   /// @brief All positions reloaded.
+   virtual void OnPositionsReloaded() = 0;
+
+   /// @brief Account summary changed.
+   virtual void OnAccountChanged(const AccountInfo& account) = 0;
+
+   /// @brief Account position added or changed.
+   virtual void OnPositionChanged(
+      const AccountInfo& account,
+      const PositionInfo& position,
+      const bool newPosition) = 0;
+
+   /// @brief Requested symbol resolved and subscribed.
+   /// @param requestedSymbol [in] symbol passed to IBackend::NewInstrument().
+   /// @param fullName [in] resolved symbol full name.
+   /// @param tickSize [in] instrument tick size, zero if unknown.
+   /// @param tickValue [in] money value of one tick, zero if unknown.
+   /// @param quotes [in] current instrument quotes, symbolId is not set.
+   /// @return Symbol identifier backend shall use for this instrument quote updates.
+   virtual SymbolId OnInstrumentSubscribed(
+      const CString& requestedSymbol,
+      const CString& fullName,
+      const Price tickSize,
+      const MoneyAmount tickValue,
+      const QuoteEvent& quotes) = 0;
+
+   /// @brief Subscribed instrument quotes changed.
+   /// @param quotes [in] changed quotes of instrument identified as OnInstrumentSubscribed() returned.
+   virtual void OnInstrumentChanged(const QuoteEvent& quotes) = 0;
+
+   /// @brief Subscribed instrument market depth changed.
+   /// @param depth [in] new top levels of instrument identified as OnInstrumentSubscribed() returned.
+   virtual void OnInstrumentDOMChanged(const MarketDepth& depth) = 0;
+
+   /// @brief Requested symbol failed resolution.
+   virtual void OnIncorrectSymbol(const CString& symbol) = 0;
+
+   /// @brief Order added, changed or removed.
+   /// @param order [in, out] order state, OrderInfo::orderFills holds the last fill only, if any.
+   ///        Facade core drops already reported fill and sets OrderInfo::fillSeq.
+   /// @param lastFill [in] identity of fill in OrderInfo::orderFills.
+   virtual void OnOrderChanged(OrderInfo& order, const FillKey& lastFill) = 0;
+
+   /// @brief Timed bars request completed.
+   virtual void OnTimedBarsResolved(const Bars& bars) = 0;
+
+   /// @brief Subscribed timed bars changed.
+   virtual void OnTimedBarsChanged(const BarsUpdate& update) = 0;
+
+   /// @brief Destructor, must be virtual.
+   virtual ~IBackendEvents() {}
+};
+
+/// @class IBackend
+/// @brief CQGCEL operations used by facade core.
+/// @note Methods returning bool or string report failure details via error parameter.
+struct IBackend
+{
+   /// @brief Starts CQGCEL and subscribes to its events.
+   /// @param events [in] events listener.
+   /// @param settings [in] facade settings, e.g. market data subscription level.
+   /// @throw std::exception if CQGCEL can't be started.
+   virtual void Startup(IBackendEvents* events, const FacadeSettings& settings) = 0;
+
+   /// @brief Unsubscribes from events and shuts down CQGCEL, can be called several times.
+   virtual void Shutdown() throw() = 0;
+
+   /// @brief Delivers pending events, see IAPIFacade::PumpEvents().
+   virtual unsigned PumpEvents(unsigned maxEvents) = 0;
+
+   /// @brief Calls function later from CQGCEL thread, in order with CQGCEL events.
+   ///        Lets facade core report results it has without CQGCEL asynchronously as well.
+   virtual void Post(const std::function<void()>& call) = 0;
+
+   /// @brief Requests symbol resolution & market data.
+   virtual bool NewInstrument(const CString& symbol, CString& error) = 0;
+
+   /// @brief Stops instrument market data, see IAPIFacade::UnsubscribeSymbol().
+   /// @param id [in] instrument identifier as IBackendEvents::OnInstrumentSubscribed() returned.
+   virtual bool RemoveInstrument(const SymbolId id, CString& error) = 0;
+
+   /// @brief Changes instrument market data subscription level.
+   /// @param id [in] instrument identifier as IBackendEvents::OnInstrumentSubscribed() returned.
+   virtual bool SetSubscriptionLevel(const SymbolId id, const SubscriptionLevel level, CString& error) = 0;
+
+   /// @brief Requests timed bars.
+   /// @return Request guid or empty string if failed.
+   virtual CString RequestTimedBars(const BarsRequest& barsRequest, CString& error) = 0;
+
+   /// @brief Stops updates of subscribed timed bars.
+   virtual bool RemoveTimedBars(const CString& requestGuid, CString& error) = 0;
+
+   /// @brief Performs logon to CQG Gateway.
+   virtual bool GWLogon(const CString& user, const CString& password, CString& error) = 0;
+
+   /// @brief Gets current Line Time, invalid date/time if not available.
+   virtual COleDateTime GetLineTime(CString& error) = 0;
+
+   /// @brief Gets all available accounts.
+   virtual bool GetAccounts(Accounts& accounts, CString& error) = 0;
+
+   /// @brief Gets all positions of given account.
+   virtual bool GetPositions(const ID& gwAccountID, Positions& positions, CString& error) = 0;
+
+   /// @brief Places order, see IAPIFacade::PlaceOrder().
+   /// @return Placed order guid or empty string if failed.
+   virtual CString PlaceOrder(
+      OrderType type,
+      const ID& gwAccountID,
+      const CString& symbolFullName,
+      bool buy,
+      Quantity quantity,
+      const CString& description,
+      const OrderPrice& price,
+      const OrderPrice& stopLimitPrice,
+      CString& error) = 0;
+
+   /// @brief Resolves order ticket, see IAPIFacade::PrepareOrderTicket().
+   /// @param ticketId [in] ticket slot given by facade core, small index reused once ticket is released.
+   virtual bool PrepareOrderTicket(OrderTicketId ticketId, const OrderTicket& ticket, CString& error) = 0;
+
+   /// @brief Places order of prepared ticket, see IAPIFacade::SubmitOrderTicket().
+   /// @param quantity [in] order quantity, always set.
+   /// @return Placed order guid or empty string if failed.
+   virtual CString SubmitOrderTicket(
+      OrderTicketId ticketId,
+      const OrderPrice& price,
+      Quantity quantity,
+      const OrderPrice& stopLimitPrice,
+      CString& error) = 0;
+
+   /// @brief Drops prepared ticket.
+   virtual void ReleaseOrderTicket(OrderTicketId ticketId) = 0;
+
+   /// @brief Places batch of orders, see IAPIFacade::PlaceOrders().
+   /// @param results [out] one result per order.
+   virtual void PlaceOrders(const OrderRequests& orders, OrderResults& results) = 0;
+
+   /// @brief Modifies working order, see IAPIFacade::ModifyOrder().
+   /// @note Order changes must report OrderInfo::modifyPending until modification is acknowledged.
+   virtual bool ModifyOrder(
+      const CString& orderGuid,
+      const OrderPrice& price,
+      const OrderPrice& stopLimitPrice,
+      Quantity quantity,
+      CString& error) = 0;
+
+   /// @brief Cancels batch of orders, see IAPIFacade::CancelOrders().
+   /// @param results [in, out] one result per guid, orders already having error are skipped.
+   virtual void CancelOrders(const OrderGuids& orderGuids, OrderResults& results) = 0;
+
+   /// @brief Cancels order with given guid.
+   virtual bool CancelOrder(const CString& orderGuid, CString& error) = 0;
+
+   /// @brief Cancels all orders within given account and symbol.
+   virtual bool CancelAllOrders(const ID& gwAccountID, const CString& symbolFullName, CString& error) = 0;
+
+   /// @brief Destructor, must be virtual.
+   virtual ~IBackend() {}
+};
+
+/// @brief Smart pointer holding backend instance.
+typedef std::auto_ptr<IBackend> IBackendPtr;
+
+#ifdef CQGAPIFACADE_USE_MFC
+/// @brief Creates backend working on top of CQGCEL COM object.
+IBackendPtr CreateCQGCELBackend();
+#endif
+
+/// @brief Creates deterministic in-process simulated backend.
+IBackendPtr CreateSimulatedBackend(const SimulationSettings& settings);
+
+} // namespace cqg
@@ -0,0 +1,336 @@
+/// @file BarCache.cpp
+/// @brief Simple C++ facade for CQG API - persistent timed bars history implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "BarCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+
+namespace cqg
+{
+
+namespace
+{
+
+const char FileMagic[8] = { 'C', 'Q', 'G', 'B', 'A', 'R', 'S', '1' };
+const unsigned FileVersion = 1;
+
+/// @brief Minimal number of bars file has room for.
+const size_t MinCapacity = 1024;
+
+/// @brief Timestamps of the same bar received by different requests may differ by rounding, 1 millisecond.
+const double TimeEpsilon = 1.0 / (24.0 * 60.0 * 60.0 * 1000.0);
+
+/// @brief Series file header, followed by bar records.
+struct FileHeader
+{
+   char magic[8];              ///< FileMagic.
+   unsigned version;           ///< FileVersion.
+   unsigned recordSize;        ///< Size of BarRecord.
+   unsigned long long count;   ///< Number of bars in series, file may have room for more.
+   DATE coveredFrom;           ///< Series coverage start.
+};
+
+/// @brief Bar stored in series file.
+struct BarRecord
+{
+   DATE timestamp;
+   Price open;
+   Price high;
+   Price low;
+   Price close;
+   long long volume;
+};
+
+FileHeader* GetHeader(const MappedFile& file)
+{
+   return reinterpret_cast<FileHeader*>(file.Data());
+}
+
+BarRecord* GetRecords(const MappedFile& file)
+{
+   return reinterpret_cast<BarRecord*>(file.Data() + sizeof(FileHeader));
+}
+
+/// @brief Gets number of bars file has room for.
+size_t GetCapacity(const MappedFile& file)
+{
+   return file.Size() < sizeof(FileHeader) ? 0 : (file.Size() - sizeof(FileHeader)) / sizeof(BarRecord);
+}
+
+/// @brief Checks whether file holds series written by this version.
+bool IsValidFile(const MappedFile& file)
+{
+   if(file.Size() < sizeof(FileHeader))
+   {
+      return false;
+   }
+
+   const FileHeader* header = GetHeader(file);
+   return std::memcmp(header->magic, FileMagic, sizeof(FileMagic)) == 0 &&
+      header->version == FileVersion &&
+      header->recordSize == sizeof(BarRecord) &&
+      header->count <= GetCapacity(file);
+}
+
+/// @brief Compares record timestamp with time.
+struct EarlierThan
+{
+   bool operator()(const BarRecord& record, const DATE time) const
+   {
+      return record.timestamp < time;
+   }
+};
+
+/// @brief Gets index of the first record at or after given time.
+size_t LowerBound(const BarRecord* records, const size_t count, const DATE time)
+{
+   return std::lower_bound(records, records + count, time - TimeEpsilon, EarlierThan()) - records;
+}
+
+/// @brief Gets index of the first record after given time.
+size_t UpperBound(const BarRecord* records, const size_t count, const DATE time)
+{
+   return std::lower_bound(records, records + count, time + TimeEpsilon, EarlierThan()) - records;
+}
+
+BarRecord ToRecord(const BarInfo& bar)
+{
+   BarRecord record;
+   record.timestamp = bar.timestamp.m_dt;
+   record.open = bar.open;
+   record.high = bar.high;
+   record.low = bar.low;
+   record.close = bar.close;
+   record.volume = bar.volume;
+   return record;
+}
+
+BarInfo ToBar(const BarRecord& record)
+{
+   BarInfo bar;
+   bar.timestamp = COleDateTime(record.timestamp);
+   bar.open = record.open;
+   bar.high = record.high;
+   bar.low = record.low;
+   bar.close = record.close;
+   bar.volume = static_cast<Volume>(record.volume);
+   return bar;
+}
+
+/// @brief Gets series file name of request, e.g. "F.US.EPZ5_30_31.bars".
+CString GetFileName(const BarsRequest& request)
+{
+   std::string symbol;
+   for(const char* ch = request.symbol.GetString(); *ch; ++ch)
+   {
+      const bool safe = std::isalnum(static_cast<unsigned char>(*ch)) || *ch == '.' || *ch == '-';
+      symbol += safe ? *ch : '_';
+   }
+
+   CString name;
+   name.Format("%s_%ld_%ld.bars", symbol.c_str(), request.intradayPeriodInMinutes, request.sessionsFilter);
+   return name;
+}
+
+} // namespace
+
+bool BarCache::Open(const CString& directory, CString& error)
+{
+   m_files.clear();
+   m_directory.Empty();
+
+   if(directory.IsEmpty())
+   {
+      return true;
+   }
+
+   if(!MappedFile::MakeDirectory(directory, error))
+   {
+      return false;
+   }
+
+   m_directory = directory;
+   return true;
+}
+
+bool BarCache::GetRange(const BarsRequest& request, DATE& coveredFrom, DATE& lastBar)
+{
+   CString error;
+   const MappedFile* file = getFile(request, error);
+   if(!file || !GetHeader(*file)->count)
+   {
+      return false;
+   }
+
+   const FileHeader* header = GetHeader(*file);
+   coveredFrom = header->coveredFrom;
+   lastBar = GetRecords(*file)[header->count - 1].timestamp;
+   return true;
+}
+
+bool BarCache::Load(const BarsRequest& request, BarInfos& bars)
+{
+   bars.clear();
+
+   CString error;
+   const MappedFile* file = getFile(request, error);
+   if(!file)
+   {
+      return false;
+   }
+
+   const FileHeader* header = GetHeader(*file);
+   const BarRecord* records = GetRecords(*file);
+   const size_t count = static_cast<size_t>(header->count);
+
+   size_t first = 0;
+   size_t end = 0;
+
+   if(request.useIndexRange)
+   {
+      // Index 0 is the last bar, older bars have negative indexes.
+      const long newest = std::max(request.startIndex, request.endIndex);
+      const long oldest = std::min(request.startIndex, request.endIndex);
+      if(newest > 0 || static_cast<unsigned long>(1 - oldest) > count)
+      {
+         return false;
+      }
+
+      first = count - 1 + oldest;
+      end = count + newest;
+   }
+   else
+   {
+      if(!count || request.startDate.m_dt < header->coveredFrom - TimeEpsilon)
+      {
+         return false;
+      }
+
+      first = LowerBound(records, count, request.startDate.m_dt);
+      end = std::max(first, UpperBound(records, count, request.endDate.m_dt));
+   }
+
+   bars.reserve(end - first);
+   for(size_t i = first; i < end; ++i)
+   {
+      bars.push_back(ToBar(records[i]));
+   }
+
+   return true;
+}
+
+bool BarCache::Store(const BarsRequest& request, const DATE coveredFrom, const BarInfos& bars, CString& error)
+{
+   if(bars.empty())
+   {
+      return true;
+   }
+
+   MappedFile* file = getFile(request, error);
+   if(!file)
+   {
+      return false;
+   }
+
+   const DATE lastBar = bars.back().timestamp.m_dt;
+   const size_t count = static_cast<size_t>(GetHeader(*file)->count);
+
+   // Bars replace cached bars of their range. Series which doesn't overlap with bars is dropped,
+   // since bars between them are unknown.
+   size_t prefix = 0;
+   size_t suffix = count;
+   DATE seriesFrom = coveredFrom;
+
+   if(count)
+   {
+      const FileHeader* header = GetHeader(*file);
+      const BarRecord* records = GetRecords(*file);
+
+      if(coveredFrom <= records[count - 1].timestamp + TimeEpsilon && lastBar >= header->coveredFrom - TimeEpsilon)
+      {
+         prefix = LowerBound(records, count, coveredFrom);
+         suffix = UpperBound(records, count, lastBar);
+         seriesFrom = std::min(coveredFrom, header->coveredFrom);
+      }
+   }
+
+   const size_t newCount = prefix + bars.size() + (count - suffix);
+
+   const size_t capacity = GetCapacity(*file);
+   if(newCount > capacity)
+   {
+      const size_t newCapacity = std::max(std::max(newCount, capacity * 2), MinCapacity);
+      if(!file->Resize(sizeof(FileHeader) + newCapacity * sizeof(BarRecord), error))
+      {
+         m_files.erase(GetFileName(request));
+         return false;
+      }
+   }
+
+   BarRecord* records = GetRecords(*file);
+   std::memmove(records + prefix + bars.size(), records + suffix, (count - suffix) * sizeof(BarRecord));
+
+   for(size_t i = 0; i < bars.size(); ++i)
+   {
+      records[prefix + i] = ToRecord(bars[i]);
+   }
+
+   // Header is updated last, so interrupted update leaves bars count of the previous series.
+   FileHeader* header = GetHeader(*file);
+   header->count = newCount;
+   header->coveredFrom = seriesFrom;
+   return true;
+}
+
+MappedFile* BarCache::getFile(const BarsRequest& request, CString& error)
+{
+   if(!IsEnabled())
+   {
+      error = "Bar cache is disabled";
+      return NULL;
+   }
+
+   const CString name = GetFileName(request);
+
+   const FilesMap::const_iterator it = m_files.find(name);
+   if(it != m_files.end())
+   {
+      return it->second.get();
+   }
+
+   MappedFilePtr file(new MappedFile());
+   if(!file->Open(m_directory + "/" + name, error))
+   {
+      return NULL;
+   }
+
+   if(!IsValidFile(*file))
+   {
+      // New file or file of other version, series starts empty.
+      if(!file->Resize(sizeof(FileHeader), error))
+      {
+         return NULL;
+      }
+
+      FileHeader* header = GetHeader(*file);
+      std::memcpy(header->magic, FileMagic, sizeof(FileMagic));
+      header->version = FileVersion;
+      header->recordSize = sizeof(BarRecord);
+      header->count = 0;
+      header->coveredFrom = 0.0;
+   }
+
+   MappedFile* result = file.get();
+   m_files[name] = std::move(file);
+   return result;
+}
+
+} // namespace cqg
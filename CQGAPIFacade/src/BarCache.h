@@ -0,0 +1,66 @@
+/// @file BarCache.h
+/// @brief Simple C++ facade for CQG API - persistent timed bars history.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "MappedFile.h"
+#include "SymbolTable.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace cqg
+{
+
+/// @class BarCache
+/// @brief Timed bars history kept in memory mapped files, see FacadeSettings::barCacheDirectory.
+///        Each symbol, intraday period & sessions filter has its own file holding bars sorted by time.
+///        Series has every bar from its coverage start to its last bar, the last bar may be incomplete.
+class BarCache
+{
+public:
+
+   /// @brief Enables cache in given directory, creates directory if needed.
+   /// @param directory [in] cache directory, empty to disable cache.
+   bool Open(const CString& directory, CString& error);
+
+   /// @brief Checks whether cache is enabled.
+   bool IsEnabled() const
+   {
+      return !m_directory.IsEmpty();
+   }
+
+   /// @brief Gets cached series range of request symbol, intraday period & sessions filter.
+   /// @param coveredFrom [out] series coverage start.
+   /// @param lastBar [out] the last bar timestamp.
+   /// @return False if nothing is cached.
+   bool GetRange(const BarsRequest& request, DATE& coveredFrom, DATE& lastBar);
+
+   /// @brief Gets cached bars of request range.
+   /// @return False if series doesn't cover whole range.
+   bool Load(const BarsRequest& request, BarInfos& bars);
+
+   /// @brief Merges received bars into series.
+   /// @param request [in] request bars received for.
+   /// @param coveredFrom [in] time since which bars contain every bar.
+   /// @param bars [in] bars sorted by time, invalid bars must be skipped.
+   bool Store(const BarsRequest& request, const DATE coveredFrom, const BarInfos& bars, CString& error);
+
+private:
+
+   typedef std::unique_ptr<MappedFile> MappedFilePtr;
+   typedef std::unordered_map<CString, MappedFilePtr, CStringHash> FilesMap;
+
+   /// @brief Gets open series file of request, opens or creates it if needed.
+   /// @return NULL if file can't be opened.
+   MappedFile* getFile(const BarsRequest& request, CString& error);
+
+   CString m_directory;   ///< Cache directory, empty if cache is disabled.
+   FilesMap m_files;      ///< Open series files by file name.
+};
+
+} // namespace cqg
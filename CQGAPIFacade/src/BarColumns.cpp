@@ -0,0 +1,282 @@
+/// @file BarColumns.cpp
+/// @brief Simple C++ facade for CQG API - columnar timed bars & vectorized bar kernels implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "CQGBarColumns.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CQGAPIFACADE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace cqg
+{
+
+namespace
+{
+
+/// @brief Rolling extremum by van Herk/Gil-Werman algorithm: values are split into blocks of window length,
+///        running extremum from block start (prefix) and to block end (suffix) give any window extremum
+///        as extremum of suffix at window start and prefix at window end. Both scans are sequential,
+///        the final merge is vectorized.
+template <typename Select>
+void GetRollingExtremum(const double* values, size_t count, size_t window, double* result, Select select)
+{
+   if(!count)
+   {
+      return;
+   }
+
+   window = std::max<size_t>(window, 1);
+
+   std::vector<double> suffix(count);
+
+   for(size_t blockStart = 0; blockStart < count; blockStart += window)
+   {
+      const size_t blockEnd = std::min(blockStart + window, count);
+
+      result[blockStart] = values[blockStart];
+      for(size_t i = blockStart + 1; i < blockEnd; ++i)
+      {
+         result[i] = select(result[i - 1], values[i]);
+      }
+
+      suffix[blockEnd - 1] = values[blockEnd - 1];
+      for(size_t i = blockEnd - 1; i > blockStart; --i)
+      {
+         suffix[i - 1] = select(suffix[i], values[i - 1]);
+      }
+   }
+
+   // The first window covers values so far, it's just block prefix.
+   // Later windows [i - window + 1, i] span two adjacent blocks or match single block.
+   const size_t first = std::min(window, count);
+   size_t i = first;
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   for(; i + 2 <= count; i += 2)
+   {
+      const __m128d prefix = _mm_loadu_pd(result + i);
+      const __m128d start = _mm_loadu_pd(&suffix[i + 1 - window]);
+      _mm_storeu_pd(result + i, select(prefix, start));
+   }
+#endif
+
+   for(; i < count; ++i)
+   {
+      result[i] = select(result[i], suffix[i + 1 - window]);
+   }
+}
+
+/// @brief Maximum of scalars & SSE2 vectors.
+struct SelectMax
+{
+   double operator()(double a, double b) const { return a > b ? a : b; }
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   __m128d operator()(__m128d a, __m128d b) const { return _mm_max_pd(a, b); }
+#endif
+};
+
+/// @brief Minimum of scalars & SSE2 vectors.
+struct SelectMin
+{
+   double operator()(double a, double b) const { return a < b ? a : b; }
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   __m128d operator()(__m128d a, __m128d b) const { return _mm_min_pd(a, b); }
+#endif
+};
+
+} // namespace
+
+void BarColumns::Assign(const BarInfos& bars)
+{
+   Clear();
+   Reserve(bars.size());
+
+   for(BarInfos::const_iterator it = bars.begin(); it != bars.end(); ++it)
+   {
+      Append(*it);
+   }
+}
+
+void BarColumns::Append(const BarInfo& bar)
+{
+   m_timestamps.push_back(bar.timestamp.m_dt);
+   m_open.push_back(bar.open);
+   m_high.push_back(bar.high);
+   m_low.push_back(bar.low);
+   m_close.push_back(bar.close);
+   m_volume.push_back(static_cast<double>(bar.volume));
+}
+
+void BarColumns::Set(size_t index, const BarInfo& bar)
+{
+   ATLASSERT(index < Size());
+
+   m_timestamps[index] = bar.timestamp.m_dt;
+   m_open[index] = bar.open;
+   m_high[index] = bar.high;
+   m_low[index] = bar.low;
+   m_close[index] = bar.close;
+   m_volume[index] = static_cast<double>(bar.volume);
+}
+
+BarInfo BarColumns::Get(size_t index) const
+{
+   ATLASSERT(index < Size());
+
+   BarInfo bar;
+   bar.timestamp = COleDateTime(m_timestamps[index]);
+   bar.open = m_open[index];
+   bar.high = m_high[index];
+   bar.low = m_low[index];
+   bar.close = m_close[index];
+   bar.volume = static_cast<Volume>(m_volume[index]);
+   return bar;
+}
+
+void BarColumns::Reserve(size_t count)
+{
+   m_timestamps.reserve(count);
+   m_open.reserve(count);
+   m_high.reserve(count);
+   m_low.reserve(count);
+   m_close.reserve(count);
+   m_volume.reserve(count);
+}
+
+void BarColumns::Clear()
+{
+   m_timestamps.clear();
+   m_open.clear();
+   m_high.clear();
+   m_low.clear();
+   m_close.clear();
+   m_volume.clear();
+}
+
+bool GetHighLow(const BarColumns& bars, size_t first, size_t count, Price& high, Price& low)
+{
+   if(!count || first >= bars.Size() || count > bars.Size() - first)
+   {
+      return false;
+   }
+
+   const Price* highs = bars.High() + first;
+   const Price* lows = bars.Low() + first;
+
+   high = highs[0];
+   low = lows[0];
+
+   size_t i = 0;
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   if(count >= 4)
+   {
+      // Two accumulators per column hide max/min latency.
+      __m128d high0 = _mm_loadu_pd(highs);
+      __m128d high1 = high0;
+      __m128d low0 = _mm_loadu_pd(lows);
+      __m128d low1 = low0;
+
+      for(; i + 4 <= count; i += 4)
+      {
+         high0 = _mm_max_pd(high0, _mm_loadu_pd(highs + i));
+         high1 = _mm_max_pd(high1, _mm_loadu_pd(highs + i + 2));
+         low0 = _mm_min_pd(low0, _mm_loadu_pd(lows + i));
+         low1 = _mm_min_pd(low1, _mm_loadu_pd(lows + i + 2));
+      }
+
+      high0 = _mm_max_pd(high0, high1);
+      low0 = _mm_min_pd(low0, low1);
+      high = std::max(_mm_cvtsd_f64(high0), _mm_cvtsd_f64(_mm_unpackhi_pd(high0, high0)));
+      low = std::min(_mm_cvtsd_f64(low0), _mm_cvtsd_f64(_mm_unpackhi_pd(low0, low0)));
+   }
+#endif
+
+   for(; i < count; ++i)
+   {
+      high = std::max(high, highs[i]);
+      low = std::min(low, lows[i]);
+   }
+
+   return true;
+}
+
+void GetReturns(const double* values, size_t count, double* returns)
+{
+   if(count < 2)
+   {
+      return;
+   }
+
+   const size_t n = count - 1;
+   size_t i = 0;
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   const __m128d one = _mm_set1_pd(1.0);
+   for(; i + 2 <= n; i += 2)
+   {
+      const __m128d from = _mm_loadu_pd(values + i);
+      const __m128d to = _mm_loadu_pd(values + i + 1);
+      _mm_storeu_pd(returns + i, _mm_sub_pd(_mm_div_pd(to, from), one));
+   }
+#endif
+
+   for(; i < n; ++i)
+   {
+      returns[i] = values[i + 1] / values[i] - 1.0;
+   }
+}
+
+void GetRollingMax(const double* values, size_t count, size_t window, double* result)
+{
+   GetRollingExtremum(values, count, window, result, SelectMax());
+}
+
+void GetRollingMin(const double* values, size_t count, size_t window, double* result)
+{
+   GetRollingExtremum(values, count, window, result, SelectMin());
+}
+
+void GetTrueRanges(const BarColumns& bars, double* result)
+{
+   const size_t count = bars.Size();
+   if(!count)
+   {
+      return;
+   }
+
+   const Price* highs = bars.High();
+   const Price* lows = bars.Low();
+   const Price* closes = bars.Close();
+
+   result[0] = highs[0] - lows[0];
+
+   size_t i = 1;
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   for(; i + 2 <= count; i += 2)
+   {
+      const __m128d previous = _mm_loadu_pd(closes + i - 1);
+      const __m128d high = _mm_max_pd(_mm_loadu_pd(highs + i), previous);
+      const __m128d low = _mm_min_pd(_mm_loadu_pd(lows + i), previous);
+      _mm_storeu_pd(result + i, _mm_sub_pd(high, low));
+   }
+#endif
+
+   for(; i < count; ++i)
+   {
+      result[i] = std::max(highs[i], closes[i - 1]) - std::min(lows[i], closes[i - 1]);
+   }
+}
+
+} // namespace cqg
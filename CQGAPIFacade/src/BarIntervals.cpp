@@ -0,0 +1,275 @@
+/// @file BarIntervals.cpp
+/// @brief Simple C++ facade for CQG API - in-memory timed bars intervals cache implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "BarIntervals.h"
+
+#include <algorithm>
+
+namespace cqg
+{
+
+namespace
+{
+
+/// @brief Timestamps of the same bar received by different requests may differ by rounding, 1 millisecond.
+const double TimeEpsilon = 1.0 / (24.0 * 60.0 * 60.0 * 1000.0);
+
+/// @brief Compares bar timestamp with time.
+struct EarlierThan
+{
+   bool operator()(const BarInfo& bar, const DATE time) const
+   {
+      return bar.timestamp.m_dt < time;
+   }
+};
+
+/// @brief Gets the first bar at or after given time.
+BarInfos::const_iterator LowerBound(const BarInfos& bars, const DATE time)
+{
+   return std::lower_bound(bars.begin(), bars.end(), time - TimeEpsilon, EarlierThan());
+}
+
+/// @brief Gets the first bar after given time.
+BarInfos::const_iterator UpperBound(const BarInfos& bars, const DATE time)
+{
+   return std::lower_bound(bars.begin(), bars.end(), time + TimeEpsilon, EarlierThan());
+}
+
+/// @brief Gets key of request symbol, intraday period & sessions filter.
+CString GetSeriesKey(const BarsRequest& request)
+{
+   CString key;
+   key.Format("%s|%ld|%ld", request.symbol.GetString(), request.intradayPeriodInMinutes, request.sessionsFilter);
+   return key;
+}
+
+/// @brief Gets the last bar time of interval.
+DATE GetLastBar(const BarInfos& bars)
+{
+   return bars.back().timestamp.m_dt;
+}
+
+} // namespace
+
+bool CoversBarsRange(const BarsRequest& outer, const BarsRequest& inner)
+{
+   if(outer.symbol != inner.symbol ||
+      outer.intradayPeriodInMinutes != inner.intradayPeriodInMinutes ||
+      outer.sessionsFilter != inner.sessionsFilter ||
+      outer.useIndexRange != inner.useIndexRange)
+   {
+      return false;
+   }
+
+   if(outer.useIndexRange)
+   {
+      return std::min(outer.startIndex, outer.endIndex) <= std::min(inner.startIndex, inner.endIndex) &&
+         std::max(inner.startIndex, inner.endIndex) <= std::max(outer.startIndex, outer.endIndex);
+   }
+
+   return outer.startDate.m_dt <= inner.startDate.m_dt && inner.endDate.m_dt <= outer.endDate.m_dt;
+}
+
+void GetCoveredBars(const BarsRequest& outer, const BarInfos& bars, const BarsRequest& inner, BarInfos& result)
+{
+   result.clear();
+
+   if(inner.useIndexRange)
+   {
+      // Bars end at outer newest index, older bars may be missing if history is shorter than requested.
+      const long outerNewest = std::max(outer.startIndex, outer.endIndex);
+      const long size = static_cast<long>(bars.size());
+      const long last = size - 1 - (outerNewest - std::max(inner.startIndex, inner.endIndex));
+      const long first = std::max(0L, size - 1 - (outerNewest - std::min(inner.startIndex, inner.endIndex)));
+
+      if(first <= last)
+      {
+         result.assign(bars.begin() + first, bars.begin() + last + 1);
+      }
+   }
+   else
+   {
+      const BarInfos::const_iterator first = LowerBound(bars, inner.startDate.m_dt);
+      result.assign(first, std::max(first, UpperBound(bars, inner.endDate.m_dt)));
+   }
+}
+
+void BarIntervals::SetMaxBars(const size_t maxBars)
+{
+   m_maxBars = maxBars;
+   evict();
+}
+
+bool BarIntervals::Load(const BarsRequest& request, const DATE lineTime, BarInfos& bars)
+{
+   bars.clear();
+
+   const SeriesMap::iterator itSeries = m_series.find(GetSeriesKey(request));
+   if(itSeries == m_series.end())
+   {
+      return false;
+   }
+
+   Series& series = itSeries->second;
+   series.lastUse = ++m_uses;
+
+   const double period = request.intradayPeriodInMinutes / (24.0 * 60.0);
+
+   if(request.useIndexRange)
+   {
+      // Index 0 is the current bar which is never complete. Once Line Time passes it,
+      // new bar may appear and shift all indexes.
+      const long newest = std::max(request.startIndex, request.endIndex);
+      const long oldest = std::min(request.startIndex, request.endIndex);
+      if(newest >= 0 || !series.hasHead || lineTime >= series.head + period - TimeEpsilon)
+      {
+         return false;
+      }
+
+      for(Intervals::const_iterator it = series.intervals.begin(); it != series.intervals.end(); ++it)
+      {
+         if(it->from > series.head + TimeEpsilon || GetLastBar(it->bars) < series.head - TimeEpsilon)
+         {
+            continue;
+         }
+
+         const long head = static_cast<long>(LowerBound(it->bars, series.head) - it->bars.begin());
+         if(head + oldest < 0)
+         {
+            return false;
+         }
+
+         bars.assign(it->bars.begin() + head + oldest, it->bars.begin() + head + newest + 1);
+         return true;
+      }
+
+      return false;
+   }
+
+   for(Intervals::const_iterator it = series.intervals.begin(); it != series.intervals.end(); ++it)
+   {
+      if(it->from <= request.startDate.m_dt + TimeEpsilon && request.endDate.m_dt <= it->to + TimeEpsilon)
+      {
+         const BarInfos::const_iterator first = LowerBound(it->bars, request.startDate.m_dt);
+         bars.assign(first, std::max(first, UpperBound(it->bars, request.endDate.m_dt)));
+         return true;
+      }
+   }
+
+   return false;
+}
+
+void BarIntervals::Store(const BarsRequest& request, const DATE lineTime, const BarInfos& bars)
+{
+   if(!IsEnabled() || bars.empty())
+   {
+      return;
+   }
+
+   const double period = request.intradayPeriodInMinutes / (24.0 * 60.0);
+
+   // Bar is complete once Line Time reaches its end.
+   Interval received;
+   received.bars = bars;
+
+   bool head = false;
+   if(request.useIndexRange)
+   {
+      head = std::max(request.startIndex, request.endIndex) == 0;
+      received.from = bars.front().timestamp.m_dt;
+      received.to = std::min(head ? lineTime : GetLastBar(bars), lineTime - period);
+   }
+   else
+   {
+      head = request.endDate.m_dt >= lineTime;
+      received.from = request.startDate.m_dt;
+      received.to = std::min(request.endDate.m_dt, lineTime - period);
+   }
+
+   Series& series = m_series[GetSeriesKey(request)];
+   series.lastUse = ++m_uses;
+
+   if(head)
+   {
+      series.head = GetLastBar(bars);
+      series.hasHead = true;
+   }
+
+   // Received bars absorb all intervals they overlap.
+   Intervals intervals;
+   for(Intervals::iterator it = series.intervals.begin(); it != series.intervals.end(); ++it)
+   {
+      const bool overlaps = it->from <= GetLastBar(received.bars) + TimeEpsilon &&
+         received.from <= GetLastBar(it->bars) + TimeEpsilon;
+
+      if(overlaps)
+      {
+         merge(*it, received);
+         received.from = it->from;
+         received.to = it->to;
+         received.bars.swap(it->bars);
+      }
+      else
+      {
+         intervals.push_back(Interval());
+         intervals.back().from = it->from;
+         intervals.back().to = it->to;
+         intervals.back().bars.swap(it->bars);
+      }
+   }
+
+   intervals.push_back(received);
+   std::sort(intervals.begin(), intervals.end(), StartsEarlier());
+
+   m_barsCount -= series.barsCount;
+   series.barsCount = 0;
+   for(Intervals::const_iterator it = intervals.begin(); it != intervals.end(); ++it)
+   {
+      series.barsCount += it->bars.size();
+   }
+   m_barsCount += series.barsCount;
+
+   series.intervals.swap(intervals);
+   evict();
+}
+
+void BarIntervals::merge(Interval& older, const Interval& newer)
+{
+   const BarInfos::const_iterator before = LowerBound(older.bars, newer.from);
+   const BarInfos::const_iterator after = UpperBound(older.bars, GetLastBar(newer.bars));
+
+   BarInfos bars;
+   bars.reserve((before - older.bars.begin()) + newer.bars.size() + (older.bars.end() - after));
+   bars.insert(bars.end(), older.bars.cbegin(), before);
+   bars.insert(bars.end(), newer.bars.begin(), newer.bars.end());
+   bars.insert(bars.end(), after, older.bars.cend());
+
+   older.from = std::min(older.from, newer.from);
+   older.to = std::max(older.to, newer.to);
+   older.bars.swap(bars);
+}
+
+void BarIntervals::evict()
+{
+   while(m_barsCount > m_maxBars && !m_series.empty())
+   {
+      SeriesMap::iterator oldest = m_series.begin();
+      for(SeriesMap::iterator it = m_series.begin(); it != m_series.end(); ++it)
+      {
+         if(it->second.lastUse < oldest->second.lastUse)
+         {
+            oldest = it;
+         }
+      }
+
+      m_barsCount -= oldest->second.barsCount;
+      m_series.erase(oldest);
+   }
+}
+
+} // namespace cqg
@@ -0,0 +1,117 @@
+/// @file BarIntervals.h
+/// @brief Simple C++ facade for CQG API - in-memory timed bars intervals cache.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "SymbolTable.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace cqg
+{
+
+/// @brief Checks whether requests are of the same symbol, intraday period & sessions filter
+///        and outer request range contains inner one. Ranges of different kinds never contain each other.
+bool CoversBarsRange(const BarsRequest& outer, const BarsRequest& inner);
+
+/// @brief Gets bars of inner request from bars received for outer request containing it, see CoversBarsRange().
+void GetCoveredBars(const BarsRequest& outer, const BarInfos& bars, const BarsRequest& inner, BarInfos& result);
+
+/// @class BarIntervals
+/// @brief Received timed bars kept in memory as disjoint intervals per symbol, intraday period & sessions filter,
+///        see FacadeSettings::barMemoryCacheSize. Only complete bars are served, so requests including
+///        the current bar always go to CQGCEL.
+class BarIntervals
+{
+public:
+
+   BarIntervals(): m_maxBars(0), m_barsCount(0), m_uses(0)
+   {}
+
+   /// @brief Sets max number of kept bars, least recently used series are dropped first.
+   /// @param maxBars [in] max number of bars, zero disables cache.
+   void SetMaxBars(const size_t maxBars);
+
+   /// @brief Checks whether cache is enabled.
+   bool IsEnabled() const
+   {
+      return m_maxBars != 0;
+   }
+
+   /// @brief Gets bars of request range if they are cached and complete.
+   ///        Index ranges are served only while Line Time stays within the last known bar,
+   ///        so indexes refer to the same bars as CQGCEL ones.
+   /// @param lineTime [in] current Line Time.
+   /// @return False if request range is not cached.
+   bool Load(const BarsRequest& request, const DATE lineTime, BarInfos& bars);
+
+   /// @brief Merges bars received for request into cache.
+   /// @param lineTime [in] Line Time when bars were received.
+   void Store(const BarsRequest& request, const DATE lineTime, const BarInfos& bars);
+
+   /// @brief Gets number of cached bars.
+   size_t GetBarsCount() const
+   {
+      return m_barsCount;
+   }
+
+   /// @brief Gets number of cached series.
+   size_t GetSeriesCount() const
+   {
+      return m_series.size();
+   }
+
+private:
+
+   /// @brief Contiguous bars, every bar from interval start to the last bar is present.
+   struct Interval
+   {
+      DATE from;        ///< Interval start.
+      DATE to;          ///< Bars starting at or before it are complete.
+      BarInfos bars;    ///< Bars sorted by time, the last ones may be incomplete.
+   };
+
+   typedef std::vector<Interval> Intervals;
+
+   /// @brief Cached bars of symbol, intraday period & sessions filter.
+   struct Series
+   {
+      Series(): head(0.0), hasHead(false), lastUse(0), barsCount(0)
+      {}
+
+      Intervals intervals;        ///< Disjoint intervals sorted by time.
+      DATE head;                  ///< The last bar known to CQGCEL, index 0 of index ranges.
+      bool hasHead;               ///< True if head is known.
+      unsigned long long lastUse; ///< Last use sequence number.
+      size_t barsCount;           ///< Number of bars in all intervals.
+   };
+
+   typedef std::unordered_map<CString, Series, CStringHash> SeriesMap;
+
+   /// @brief Orders intervals by start.
+   struct StartsEarlier
+   {
+      bool operator()(const Interval& lhs, const Interval& rhs) const
+      {
+         return lhs.from < rhs.from;
+      }
+   };
+
+   /// @brief Merges newer interval into older overlapping one.
+   static void merge(Interval& older, const Interval& newer);
+
+   /// @brief Drops least recently used series until bars count fits max.
+   void evict();
+
+   size_t m_maxBars;           ///< Max number of bars, zero if cache is disabled.
+   size_t m_barsCount;         ///< Number of bars in all series.
+   unsigned long long m_uses;  ///< Use sequence number.
+   SeriesMap m_series;         ///< Cached series by key.
+};
+
+} // namespace cqg
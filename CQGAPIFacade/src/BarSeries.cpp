@@ -0,0 +1,99 @@
+/// @file BarSeries.cpp
+/// @brief Simple C++ facade for CQG API - subscribed timed bars series implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "BarSeries.h"
+
+namespace cqg
+{
+
+void BarSeries::Add(const CString& requestGuid)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+   m_series[requestGuid] = Bars();
+}
+
+bool BarSeries::Remove(const CString& requestGuid)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+   return m_series.erase(requestGuid) != 0;
+}
+
+bool BarSeries::Resolve(const Bars& bars)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const SeriesMap::iterator it = m_series.find(bars.requestGuid);
+   if(it == m_series.end())
+   {
+      return false;
+   }
+
+   it->second = bars;
+   return true;
+}
+
+bool BarSeries::Apply(const BarsUpdate& update)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const SeriesMap::iterator it = m_series.find(update.requestGuid);
+   if(it == m_series.end() || it->second.requestGuid.IsEmpty())
+   {
+      return false;
+   }
+
+   if(update.index < 0)
+   {
+      return false;
+   }
+
+   BarInfos& bars = it->second.bars;
+   const size_t size = bars.size();
+   const size_t index = static_cast<size_t>(update.index);
+
+   switch(update.change)
+   {
+   case BarAdded:
+      if(index != size) return false;
+      bars.push_back(update.bar);
+      break;
+
+   case BarUpdated:
+      if(index >= size) return false;
+      bars[index] = update.bar;
+      break;
+
+   case BarInserted:
+      if(index > size) return false;
+      bars.insert(bars.begin() + index, update.bar);
+      break;
+
+   case BarRemoved:
+      if(index >= size) return false;
+      bars.erase(bars.begin() + index);
+      break;
+   }
+
+   return true;
+}
+
+bool BarSeries::Get(const CString& requestGuid, Bars& bars) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const SeriesMap::const_iterator it = m_series.find(requestGuid);
+   if(it == m_series.end() || it->second.requestGuid.IsEmpty())
+   {
+      return false;
+   }
+
+   bars = it->second;
+   return true;
+}
+
+} // namespace cqg
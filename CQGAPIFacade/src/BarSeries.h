@@ -0,0 +1,53 @@
+/// @file BarSeries.h
+/// @brief Simple C++ facade for CQG API - subscribed timed bars series.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "SymbolTable.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace cqg
+{
+
+/// @class BarSeries
+/// @brief Bars of subscribed timed bars requests kept in sync with CQGCEL bar changes.
+///        Updated from CQGCEL thread, bars can be read from any thread.
+class BarSeries
+{
+public:
+
+   /// @brief Registers subscribed request, its bars are kept once request is resolved.
+   void Add(const CString& requestGuid);
+
+   /// @brief Drops request bars.
+   /// @return False if request is not subscribed.
+   bool Remove(const CString& requestGuid);
+
+   /// @brief Sets resolved request bars.
+   /// @return False if request is not subscribed.
+   bool Resolve(const Bars& bars);
+
+   /// @brief Applies bars change.
+   /// @return False if request is not subscribed, not resolved or change doesn't fit bars.
+   bool Apply(const BarsUpdate& update);
+
+   /// @brief Gets current request bars.
+   /// @return False if request is not subscribed or not resolved yet.
+   bool Get(const CString& requestGuid, Bars& bars) const;
+
+private:
+
+   /// @brief Bars by request guid, bars guid is empty until request is resolved.
+   typedef std::unordered_map<CString, Bars, CStringHash> SeriesMap;
+
+   mutable std::mutex m_lock;   ///< Guards series.
+   SeriesMap m_series;          ///< Subscribed requests bars.
+};
+
+} // namespace cqg
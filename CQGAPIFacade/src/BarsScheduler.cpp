@@ -0,0 +1,216 @@
+/// @file BarsScheduler.cpp
+/// @brief Simple C++ facade for CQG API - timed bars requests scheduling implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "BarsScheduler.h"
+
+#include <algorithm>
+
+namespace cqg
+{
+
+namespace
+{
+
+/// @brief Checks whether not subscribed requests ask for the same bars.
+bool IsSameRequest(const BarsRequest& lhs, const BarsRequest& rhs)
+{
+   if(lhs.subscribe || rhs.subscribe ||
+      lhs.symbol != rhs.symbol ||
+      lhs.useIndexRange != rhs.useIndexRange ||
+      lhs.intradayPeriodInMinutes != rhs.intradayPeriodInMinutes ||
+      lhs.sessionsFilter != rhs.sessionsFilter)
+   {
+      return false;
+   }
+
+   return lhs.useIndexRange ?
+      lhs.startIndex == rhs.startIndex && lhs.endIndex == rhs.endIndex :
+      lhs.startDate.m_dt == rhs.startDate.m_dt && lhs.endDate.m_dt == rhs.endDate.m_dt;
+}
+
+/// @brief Gets milliseconds between given moments.
+template <typename TimePoint>
+double GetMs(const TimePoint& from, const TimePoint& to)
+{
+   return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+/// @brief Gets valid priority of request, unknown priorities are treated as backfill.
+BarsPriority GetPriority(const BarsRequest& request)
+{
+   return request.priority == InteractiveBars ? InteractiveBars : BackfillBars;
+}
+
+} // namespace
+
+CString BarsScheduler::Request(IBackend& backend, const BarsRequest& request, CString& error)
+{
+   const Clock::time_point now = Clock::now();
+
+   const CString duplicateGuid = addDuplicate(request, now);
+   if(!duplicateGuid.IsEmpty())
+   {
+      return duplicateGuid;
+   }
+
+   Pending pending;
+   pending.request = request;
+   pending.requested = now;
+
+   const bool free = (!m_maxActive || m_active.size() < m_maxActive) && !GetQueuedCount();
+   if(!request.subscribe && !free)
+   {
+      pending.requestGuid = NewGuid();
+      m_queues[GetPriority(request)].push_back(pending);
+      return pending.requestGuid;
+   }
+
+   const CString requestGuid = backend.RequestTimedBars(request, error);
+   if(!requestGuid.IsEmpty())
+   {
+      pending.requestGuid = requestGuid;
+      pending.sent = now;
+      m_active[requestGuid] = pending;
+   }
+
+   return requestGuid;
+}
+
+void BarsScheduler::OnResolved(IBackend& backend, const Bars& bars, std::vector<Bars>& resolved)
+{
+   resolved.clear();
+
+   const ActiveMap::iterator it = m_active.find(bars.requestGuid);
+   if(it == m_active.end())
+   {
+      resolved.push_back(bars);
+   }
+   else
+   {
+      const Pending pending = it->second;
+      m_active.erase(it);
+      addResults(pending, bars, resolved);
+   }
+
+   sendQueued(backend, resolved);
+}
+
+void BarsScheduler::OnCanceled(IBackend& backend, const CString& requestGuid, std::vector<Bars>& resolved)
+{
+   resolved.clear();
+
+   if(m_active.erase(requestGuid))
+   {
+      sendQueued(backend, resolved);
+   }
+}
+
+CString BarsScheduler::NewGuid()
+{
+   CString requestGuid;
+   requestGuid.Format("{FACADE-BARS-%08u}", ++m_guidsCount);
+   return requestGuid;
+}
+
+CString BarsScheduler::addDuplicate(const BarsRequest& request, const Clock::time_point requested)
+{
+   if(request.subscribe)
+   {
+      return CString();
+   }
+
+   Duplicate duplicate;
+   duplicate.requested = requested;
+
+   for(ActiveMap::iterator it = m_active.begin(); it != m_active.end(); ++it)
+   {
+      if(IsSameRequest(it->second.request, request))
+      {
+         duplicate.requestGuid = NewGuid();
+         it->second.duplicates.push_back(duplicate);
+         return duplicate.requestGuid;
+      }
+   }
+
+   for(int priority = InteractiveBars; priority <= BackfillBars; ++priority)
+   {
+      Queue& queue = m_queues[priority];
+      for(Queue::iterator it = queue.begin(); it != queue.end(); ++it)
+      {
+         if(!IsSameRequest(it->request, request))
+         {
+            continue;
+         }
+
+         duplicate.requestGuid = NewGuid();
+         it->duplicates.push_back(duplicate);
+
+         // Queued backfill needed interactively is moved to the end of interactive queue.
+         if(priority == BackfillBars && GetPriority(request) == InteractiveBars)
+         {
+            Pending pending = *it;
+            pending.request.priority = InteractiveBars;
+            queue.erase(it);
+            m_queues[InteractiveBars].push_back(pending);
+         }
+
+         return duplicate.requestGuid;
+      }
+   }
+
+   return CString();
+}
+
+void BarsScheduler::sendQueued(IBackend& backend, std::vector<Bars>& resolved)
+{
+   for(int priority = InteractiveBars; priority <= BackfillBars; ++priority)
+   {
+      Queue& queue = m_queues[priority];
+
+      while(!queue.empty() && (!m_maxActive || m_active.size() < m_maxActive))
+      {
+         Pending pending = queue.front();
+         queue.pop_front();
+
+         Bars failed;
+         pending.sent = Clock::now();
+
+         const CString requestGuid = backend.RequestTimedBars(pending.request, failed.error);
+         if(requestGuid.IsEmpty())
+         {
+            addResults(pending, failed, resolved);
+            continue;
+         }
+
+         m_active[requestGuid] = pending;
+      }
+   }
+}
+
+void BarsScheduler::addResults(const Pending& pending, const Bars& bars, std::vector<Bars>& resolved)
+{
+   const Clock::time_point now = Clock::now();
+
+   resolved.push_back(bars);
+   resolved.back().requestGuid = pending.requestGuid;
+   resolved.back().queueMs = GetMs(pending.requested, pending.sent);
+   resolved.back().serviceMs = GetMs(pending.sent, now);
+
+   // Duplicate made after request was sent waits for its result only.
+   for(std::vector<Duplicate>::const_iterator it = pending.duplicates.begin(); it != pending.duplicates.end(); ++it)
+   {
+      const Clock::time_point sent = std::max(it->requested, pending.sent);
+
+      resolved.push_back(bars);
+      resolved.back().requestGuid = it->requestGuid;
+      resolved.back().queueMs = GetMs(it->requested, sent);
+      resolved.back().serviceMs = GetMs(sent, now);
+   }
+}
+
+} // namespace cqg
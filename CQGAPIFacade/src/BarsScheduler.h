@@ -0,0 +1,108 @@
+/// @file BarsScheduler.h
+/// @brief Simple C++ facade for CQG API - timed bars requests scheduling.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "Backend.h"
+#include "SymbolTable.h"
+
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace cqg
+{
+
+/// @class BarsScheduler
+/// @brief Sends timed bars requests to CQGCEL keeping number of outstanding requests within limit,
+///        see FacadeSettings::maxBarsRequests. Requests over limit wait in queue per BarsPriority,
+///        requests identical to outstanding or queued one share its result.
+///        Subscribed requests are sent at once, but count as outstanding until resolved.
+class BarsScheduler
+{
+public:
+
+   BarsScheduler(): m_maxActive(0), m_guidsCount(0)
+   {}
+
+   /// @brief Sets max number of outstanding requests, zero for no limit.
+   void SetMaxActive(const unsigned maxActive)
+   {
+      m_maxActive = maxActive;
+   }
+
+   /// @brief Sends request to CQGCEL or queues it.
+   /// @return Request guid, CQGCEL one if request is sent at once. Empty string if sending failed.
+   CString Request(IBackend& backend, const BarsRequest& request, CString& error);
+
+   /// @brief Completes resolved CQGCEL request and sends queued requests freed slot allows.
+   /// @param bars [in] CQGCEL request result.
+   /// @param resolved [out] results to report, bars of request and its duplicates under their guids
+   ///        with queue & service times set, followed by failures of queued requests sent.
+   void OnResolved(IBackend& backend, const Bars& bars, std::vector<Bars>& resolved);
+
+   /// @brief Frees slot of canceled CQGCEL request, which is never resolved then.
+   /// @param resolved [out] failures of queued requests sent, see OnResolved().
+   void OnCanceled(IBackend& backend, const CString& requestGuid, std::vector<Bars>& resolved);
+
+   /// @brief Gets number of outstanding CQGCEL requests.
+   size_t GetActiveCount() const
+   {
+      return m_active.size();
+   }
+
+   /// @brief Gets number of queued requests.
+   size_t GetQueuedCount() const
+   {
+      return m_queues[InteractiveBars].size() + m_queues[BackfillBars].size();
+   }
+
+   /// @brief Creates guid of bars request not sent to CQGCEL yet.
+   CString NewGuid();
+
+private:
+
+   typedef std::chrono::steady_clock Clock;
+
+   /// @brief Request sharing result of identical request.
+   struct Duplicate
+   {
+      CString requestGuid;          ///< Request guid returned to user.
+      Clock::time_point requested;  ///< Time of request.
+   };
+
+   /// @brief Queued or outstanding request.
+   struct Pending
+   {
+      BarsRequest request;               ///< Request definition.
+      CString requestGuid;               ///< Request guid returned to user.
+      Clock::time_point requested;       ///< Time of request.
+      Clock::time_point sent;            ///< Time request was sent to CQGCEL.
+      std::vector<Duplicate> duplicates; ///< Identical requests made later.
+   };
+
+   typedef std::deque<Pending> Queue;
+   typedef std::unordered_map<CString, Pending, CStringHash> ActiveMap;
+
+   /// @brief Adds duplicate to outstanding or queued request identical to given one.
+   /// @return Duplicate request guid, empty if there is no such request.
+   CString addDuplicate(const BarsRequest& request, const Clock::time_point requested);
+
+   /// @brief Sends queued requests while limit allows.
+   void sendQueued(IBackend& backend, std::vector<Bars>& resolved);
+
+   /// @brief Adds result of request & its duplicates.
+   static void addResults(const Pending& pending, const Bars& bars, std::vector<Bars>& resolved);
+
+   unsigned m_maxActive;               ///< Max number of outstanding requests, zero for no limit.
+   unsigned m_guidsCount;              ///< Number of guids created.
+   ActiveMap m_active;                 ///< Outstanding requests by CQGCEL guid.
+   Queue m_queues[BackfillBars + 1];   ///< Queued requests by priority.
+};
+
+} // namespace cqg
@@ -0,0 +1,152 @@
+/// @file BoundedQueue.h
+/// @brief Simple C++ facade for CQG API - bounded lock-free queue.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace cqg
+{
+
+/// @class BoundedQueue
+/// @brief Bounded multi-producer multi-consumer lock-free ring (D. Vyukov's algorithm).
+///        Every cell has sequence number telling whether it's ready for push or pop,
+///        so producers & consumers synchronize on cells only, not on the whole queue.
+/// @note Any thread can pop, e.g. producer can drop the oldest item when queue is full.
+template <typename T>
+class BoundedQueue
+{
+public:
+
+   /// @brief Creates queue.
+   /// @param capacity [in] maximum number of items, rounded up to power of 2.
+   explicit BoundedQueue(size_t capacity): m_mask(RoundUp(capacity) - 1), m_cells(m_mask + 1)
+   {
+      for(size_t i = 0; i < m_cells.size(); ++i)
+      {
+         m_cells[i].sequence.store(i, std::memory_order_relaxed);
+      }
+
+      m_pushPos.store(0, std::memory_order_relaxed);
+      m_popPos.store(0, std::memory_order_relaxed);
+   }
+
+   /// @brief Pushes item to queue tail.
+   /// @return False if queue is full, item is untouched then.
+   bool TryPush(T& item)
+   {
+      size_t pos = m_pushPos.load(std::memory_order_relaxed);
+
+      for(;;)
+      {
+         Cell& cell = m_cells[pos & m_mask];
+         const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+         const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+         if(diff == 0)
+         {
+            if(m_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+               cell.data = std::move(item);
+               cell.sequence.store(pos + 1, std::memory_order_release);
+               return true;
+            }
+         }
+         else if(diff < 0)
+         {
+            return false;
+         }
+         else
+         {
+            pos = m_pushPos.load(std::memory_order_relaxed);
+         }
+      }
+   }
+
+   /// @brief Pops item from queue head.
+   /// @return False if queue is empty.
+   bool TryPop(T& item)
+   {
+      size_t pos = m_popPos.load(std::memory_order_relaxed);
+
+      for(;;)
+      {
+         Cell& cell = m_cells[pos & m_mask];
+         const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+         const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+         if(diff == 0)
+         {
+            if(m_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+               item = std::move(cell.data);
+               cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+               return true;
+            }
+         }
+         else if(diff < 0)
+         {
+            return false;
+         }
+         else
+         {
+            pos = m_popPos.load(std::memory_order_relaxed);
+         }
+      }
+   }
+
+   /// @brief Gets approximate number of queued items.
+   size_t Size() const
+   {
+      const size_t pushPos = m_pushPos.load(std::memory_order_relaxed);
+      const size_t popPos = m_popPos.load(std::memory_order_relaxed);
+      return pushPos > popPos ? pushPos - popPos : 0;
+   }
+
+   /// @brief Gets queue capacity.
+   size_t Capacity() const
+   {
+      return m_cells.size();
+   }
+
+private:
+
+   struct Cell
+   {
+      std::atomic<size_t> sequence;
+      T data;
+
+      Cell(): sequence(0)
+      {}
+
+      Cell(const Cell& rhs): sequence(rhs.sequence.load()), data(rhs.data)
+      {}
+   };
+
+   static size_t RoundUp(size_t capacity)
+   {
+      size_t result = 2;
+      while(result < capacity) result <<= 1;
+      return result;
+   }
+
+   BoundedQueue(const BoundedQueue&);
+   BoundedQueue& operator=(const BoundedQueue&);
+
+   const size_t m_mask;               ///< Capacity - 1, capacity is power of 2.
+   std::vector<Cell> m_cells;         ///< Ring cells.
+
+   // Positions are kept on separate cache lines, so producers & consumers don't false share.
+   char m_pad0[64];
+   std::atomic<size_t> m_pushPos;     ///< Next position to push.
+   char m_pad1[64];
+   std::atomic<size_t> m_popPos;      ///< Next position to pop.
+   char m_pad2[64];
+};
+
+} // namespace cqg
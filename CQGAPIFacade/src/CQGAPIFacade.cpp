@@ -7,1252 +7,1517 @@
 #include "stdafx.h"
 
 #include "CQGAPIFacade.h"
-
+#include "Backend.h"
+#include "BarCache.h"
+#include "BarIntervals.h"
+#include "BarSeries.h"
+#include "BarsScheduler.h"
+#include "DerivedBars.h"
+#include "EventDispatcher.h"
+#include "OrderBook.h"
+#include "OrderRegistry.h"
+#include "PositionBook.h"
+#include "QuoteCache.h"
+#include "QuoteConflator.h"
+#include "SymbolBatches.h"
+#include "SymbolTable.h"
+#include "Subscriptions.h"
+#include "TradeBars.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <exception>
+#include <functional>
 #include <stdexcept>
-
-#include <afx.h>
-#include <atlbase.h>
-#include <atlcom.h>
-
-#pragma message ("Please make sure that the path of CQGCEL-4_0.dll on your system corresponds to the one given in CQGAPIFacade.cpp file.")
-#import "D:\CQGIC\CQGNet\Bin\CQGCEL-4_0.dll" raw_interfaces_only, raw_native_types, no_namespace, named_guids, auto_search
+#include <vector>
 
 namespace cqg
 {
 
-/// @class CCOMInitializer
-/// @brief COM subsystem initialization & finalization wrapper
-static struct CCOMInitializer
-{
-   CCOMInitializer()
-   {
-      // Initialize COM
-      ::CoInitialize(NULL);
-   }
+/// @brief Bar timestamps tolerance, 1 millisecond.
+const double BarTimeEpsilon = 1.0 / (24.0 * 60.0 * 60.0 * 1000.0);
 
-   ~CCOMInitializer()
-   {
-      // Finalize COM
-      ::CoUninitialize();
-   }
-} sc_initCOM;
+/// @brief Order ticket identifier keeps ticket slot in low bits & slot generation in high bits,
+///        so identifier of released ticket never matches ticket prepared later in the same slot.
+const unsigned TicketSlotBits = 16;
+const OrderTicketId TicketSlotMask = (1u << TicketSlotBits) - 1;
+const unsigned TicketGenerationMask = ~0u >> TicketSlotBits;
 
-/// @brief Returns latest COM error description
-/// @param spClass [in] - Pointer to COM object which raised error
-/// @param descr [out] - Error description
-/// @return Result code
-template <class IFaceT>
-STDMETHODIMP GetCOMErrorString(
-   const ATL::CComPtr<IFaceT>& spIFace,
-   CString& error)
+/// @brief Copies quotes of quote event to quotes container.
+void GetQuotes(const QuoteEvent& quotes, Quotes& result)
 {
-   error.Empty();
+   result.assign(quotes.quotes, quotes.quotes + quotes.count);
+}
 
-   ATL::CComPtr<ISupportErrorInfo> spSupportErrorInfo;
-   HRESULT hr = spIFace->QueryInterface(__uuidof(ISupportErrorInfo), (void**)&spSupportErrorInfo);
+#define CHECK_CEL_INIT(res)                 \
+m_lastError.Empty();                        \
+if(!IsValid())                              \
+{                                           \
+   ATLASSERT(0);                            \
+   m_lastError = "CQGCVEL not initialized"; \
+   return res;                              \
+}
 
-   if(SUCCEEDED(hr))
+/// @class IAPIFacadeImpl
+/// @brief Facade core, translates backend events to user events and user calls to backend.
+struct IAPIFacadeImpl: IAPIFacade, IBackendEvents, IBaseBarsSource
+{
+   /// @brief Creates facade over given backend.
+   /// @param backend [in] backend instance, NULL if there is no backend available.
+   IAPIFacadeImpl(IBackendPtr backend):
+      m_backend(backend),
+      m_events(NULL),
+      m_userEvents(NULL),
+      m_started(false),
+      m_orderBatchStats(),
+      m_barsCacheStats()
+   {}
+
+   ~IAPIFacadeImpl()
    {
-      hr = spSupportErrorInfo->InterfaceSupportsErrorInfo(__uuidof(IFaceT));
-      if(SUCCEEDED(hr))
+      if(m_started)
       {
-         ATL::CComPtr<IErrorInfo> spErrorInfo;
-         hr = GetErrorInfo(0, &spErrorInfo);
-
-         if(SUCCEEDED(hr))
-         {
-            ATL::CComBSTR errDesc;
-            hr = spErrorInfo->GetDescription(&errDesc);
-            error = errDesc;
-         }
+         m_backend->Shutdown();
       }
+
+      // Delivers all queued events, so it must be stopped after CQGCEL.
+      m_dispatcher.reset();
    }
 
-   return hr;
-}
+   /// @name IAPIFacade implementation.
+   /// @{
 
-/// @brief Gets COM error description depending on passed result code
-/// @param spIFace [in] pointer to object which is the source of the result code
-/// @param hr [in] result code
-/// @return COM error string
-template <class IFaceT>
-CString GetCOMError(const ATL::CComPtr<IFaceT>& spIFace, HRESULT hr)
-{
-   if(SUCCEEDED(hr))
+   virtual bool IsValid()
    {
-      return CString();
+      return m_started;
    }
 
-   CString errMessage;
-   HRESULT hres = GetCOMErrorString(spIFace, errMessage);
-
-   if(SUCCEEDED(hres))
+   virtual CString GetLastError()
    {
-      errMessage.Insert(0, "COM error occurred. Description: ");
+      return m_lastError;
    }
-   else
+
+   virtual bool Initialize(IAPIEvents* events, const FacadeSettings& settings)
    {
-      char* errDesc = NULL;
+      m_lastError.Empty();
 
-      ::FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM,
-         NULL,
-         hr,
-         MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-         (LPTSTR)&errDesc,
-         0,
-         NULL);
+      if(m_started)
+      {
+         ATLASSERT(0);
+         m_lastError = "CQGCEL already initialized";
+         return false;
+      }
 
-      errMessage = errDesc;
-      ::LocalFree(errDesc);
-   }
+      if(!m_backend.get())
+      {
+         m_lastError = "Unable to initialize CQGCEL: CQGCEL is not available on this platform";
+         return false;
+      }
 
-   return errMessage;
-}
+      CString cacheError;
+      if(!m_barCache.Open(settings.barCacheDirectory, cacheError))
+      {
+         m_lastError = CString("Unable to open bar cache: ") + cacheError;
+         return false;
+      }
 
-/// @brief Throws runtime exception depending on passed result code
-/// @param spIFace - Pointer to object which is the source of the result code
-/// @param hr - Result code
-template <class IFaceT>
-void CheckCOMError(const ATL::CComPtr<IFaceT>& spIFace, HRESULT hr)
-{
-   if(SUCCEEDED(hr))
+      m_barIntervals.SetMaxBars(settings.barMemoryCacheSize);
+      m_barsScheduler.SetMaxActive(settings.maxBarsRequests);
+      m_derivedBars.SetBasePeriod(settings.baseBarPeriodInMinutes);
+      m_barsCacheStats = BarsCacheStats();
+
+      m_userEvents = events;
+      m_events = events;
+      m_settings = settings;
+
+      if(events && settings.dispatchThreads > 0)
+      {
+         m_dispatcher.reset(new EventDispatcher(events, settings));
+         m_events = m_dispatcher.get();
+      }
+
+      try
+      {
+         m_backend->Startup(this, settings);
+      }
+      catch(std::exception& ex)
+      {
+         m_backend->Shutdown();
+         m_dispatcher.reset();
+         m_lastError = CString("Unable to initialize CQGCEL: ") + ex.what();
+         return false;
+      }
+      catch(...)
+      {
+         m_backend->Shutdown();
+         m_dispatcher.reset();
+         m_lastError = "Unable to initialize CQGCEL: Unknown exception";
+         return false;
+      }
+
+      m_started = true;
+      return true;
+   }
+
+   virtual unsigned PumpEvents(unsigned maxEvents)
    {
-      return;
+      CHECK_CEL_INIT(0);
+      return m_backend->PumpEvents(maxEvents);
    }
 
-   throw std::runtime_error(std::string(GetCOMError(spIFace, hr).GetString()));
-}
+   virtual unsigned DrainQuotes(unsigned maxSymbols)
+   {
+      // May be called from consumer thread, so m_lastError is not touched.
+      if(!m_started || !m_userEvents)
+      {
+         return 0;
+      }
 
-template <class ICollectionT, typename ItemT>
-class CComCollection
-{
-public:
+      m_conflator.Take(m_drained, maxSymbols);
 
-   CComCollection(ICollectionT* collection): m_isEnd(true)
-   {
-      if(collection)
+      for(size_t i = 0; i < m_drained.size(); ++i)
       {
-         HRESULT hr = collection->get__NewEnum(&m_collection);
-         CheckCOMError<ICollectionT>(collection, hr);
+         const QuoteEvent& quotes = m_drained[i];
 
-         Reset();
+         if(m_settings.quoteEvents)
+         {
+            m_userEvents->OnQuoteEvent(quotes);
+         }
+         else
+         {
+            SymbolInfo symInfo;
+            symInfo.id = quotes.symbolId;
+            symInfo.fullName = m_conflator.GetName(quotes.symbolId);
+            GetQuotes(quotes, symInfo.lastQuotes);
+
+            m_userEvents->OnSymbolQuote(symInfo);
+         }
       }
+
+      return static_cast<unsigned>(m_drained.size());
    }
 
-   bool IsEnd() const
+   virtual void GetDispatchStats(DispatchStats& stats)
    {
-      return m_isEnd;
+      stats = DispatchStats();
+
+      if(m_dispatcher.get())
+      {
+         m_dispatcher->GetStats(stats);
+      }
    }
 
-   void Reset()
+   virtual bool RequestSymbol(const CString& symbol)
    {
-      if(m_collection)
+      CHECK_CEL_INIT(false);
+      return m_backend->NewInstrument(symbol, m_lastError);
+   }
+
+   virtual unsigned RequestSymbols(const SymbolNames& symbols)
+   {
+      CHECK_CEL_INIT(0);
+
+      if(symbols.empty())
       {
-         HRESULT hr = m_collection->Reset();
-         CheckCOMError(m_collection, hr);
-         m_isEnd = false;
+         m_lastError = "No symbols requested";
+         return 0;
       }
+
+      SymbolNames unique;
+      const unsigned batchId = m_batches.Start(symbols, unique);
+
+      SymbolsBatches completed;
+      for(SymbolNames::const_iterator it = unique.begin(); it != unique.end(); ++it)
+      {
+         CString error;
+         if(!m_backend->NewInstrument(*it, error))
+         {
+            m_lastError = error;
+            m_batches.OnFailed(*it, completed);
+         }
+      }
+
+      m_batches.Issued(batchId, completed);
+      fireBatchesCompleted(completed);
+
+      return batchId;
    }
 
-   ATL::CComVariant GetNext()
+   virtual bool UnsubscribeSymbol(const SymbolId symbolId)
    {
-      m_isEnd = true;
+      CHECK_CEL_INIT(false);
 
-      ATL::CComVariant result;
-      if(m_collection)
+      if(!m_subscriptions.IsSubscribed(symbolId))
       {
-         HRESULT hr = m_collection->Next(1, &result, NULL);
-         CheckCOMError(m_collection, hr);
-         m_isEnd = (hr == S_FALSE);
+         m_lastError = "Symbol is not subscribed";
+         return false;
       }
 
-      return result;
+      return releaseSymbol(symbolId, m_lastError);
    }
 
-private:
-   bool m_isEnd;
-   ATL::CComPtr<IEnumVARIANT> m_collection;
-};
-
-bool GetQuote(ICQGQuote* quote, QuoteInfo& quoteInfo)
-{
-   if(!quote)
+   virtual bool SetSubscriptionLevel(const SymbolId symbolId, const SubscriptionLevel level)
    {
-      ATLASSERT(0);
-      return false;
-   }
+      CHECK_CEL_INIT(false);
 
-   VARIANT_BOOL valid = VARIANT_FALSE;
-   quote->get_IsValid(&valid);
+      if(!m_subscriptions.IsSubscribed(symbolId))
+      {
+         m_lastError = "Symbol is not subscribed";
+         return false;
+      }
 
-   if(valid == VARIANT_FALSE)
-   {
-      return false;
+      const SubscriptionLevel previous = m_subscriptions.GetLevel(symbolId);
+      if(level == previous)
+      {
+         return true;
+      }
+
+      if(!m_backend->SetSubscriptionLevel(symbolId, level, m_lastError))
+      {
+         return false;
+      }
+
+      m_subscriptions.SetLevel(symbolId, level);
+
+      if(level == TradesAndDOMLevel)
+      {
+         m_books.AddSymbol(symbolId, m_subscriptions.GetTickSize(symbolId));
+      }
+      else if(previous == TradesAndDOMLevel)
+      {
+         m_books.RemoveSymbol(symbolId);
+      }
+
+      return true;
    }
 
-   eQuoteType type;
-   quote->get_Type(&type);
+   virtual unsigned GetSubscribedSymbolsCount()
+   {
+      return m_subscriptions.GetSubscribedCount();
+   }
 
-   quoteInfo.type = QuoteInfo::Unknown;
-   if(type == qtAsk) quoteInfo.type = QuoteInfo::Ask;
-   else if(type == qtBid) quoteInfo.type = QuoteInfo::Bid;
-   else if(type == qtTrade) quoteInfo.type = QuoteInfo::Trade;
-   else if(type == qtYesterdaySettlement) quoteInfo.type = QuoteInfo::Close;
-   else if(type == qtDayHigh) quoteInfo.type = QuoteInfo::High;
-   else if(type == qtDayLow) quoteInfo.type = QuoteInfo::Low;
-   else
+   virtual SymbolId GetSymbolId(const CString& symbolFullName)
    {
-      return false;
+      return m_symbols.Find(symbolFullName);
    }
 
-   quote->get_Price(&quoteInfo.price);
-   quote->get_Volume(&quoteInfo.volume);
+   virtual CString GetSymbolName(const SymbolId symbolId)
+   {
+      return m_symbols.GetName(symbolId);
+   }
 
-   return true;
-}
+   virtual bool GetSymbolQuotes(const SymbolId symbolId, QuoteEvent& quotes)
+   {
+      return m_quotes.Get(symbolId, quotes);
+   }
 
-void GetAllQuotes(ICQGQuotes* quotes, SymbolInfo& symInfo)
-{
-   if(!quotes)
+   virtual bool GetMarketDepth(const SymbolId symbolId, MarketDepth& depth)
    {
-      return;
+      return m_books.Get(symbolId, depth);
    }
 
-   CComCollection<ICQGQuotes, ICQGQuote> q(quotes);
-   while(!q.IsEnd())
+   virtual CString RequestBars(const BarsRequest& barsRequest)
    {
-      ATL::CComVariant v = q.GetNext();
-      if(q.IsEnd()) break;
+      CHECK_CEL_INIT(CString());
 
-      ATL::CComQIPtr<ICQGQuote> spQuote = v.pdispVal;
+      if(m_derivedBars.CanDerive(barsRequest))
+      {
+         const CString requestGuid = m_derivedBars.Request(*this, barsRequest);
+         ++m_barsCacheStats.derived;
+         m_bars.Add(requestGuid);
+
+         // Requests made together share base request sent later. Base request may be resolved already,
+         // then bars are reported as if CQGCEL resolved them.
+         m_backend->Post(std::bind(&IAPIFacadeImpl::sendBaseBars, this));
+         m_backend->Post(std::bind(&IAPIFacadeImpl::resolveDerivedBars, this, requestGuid));
+         return requestGuid;
+      }
 
-      QuoteInfo quote;
-      if(GetQuote(spQuote, quote))
+      // Subscribed bars indexes must match CQGCEL ones, so subscribed requests bypass caches.
+      if((m_barCache.IsEnabled() || m_barIntervals.IsEnabled()) && !barsRequest.subscribe)
       {
-         symInfo.lastQuotes.push_back(quote);
+         return requestCachedBars(barsRequest);
       }
+
+      const CString requestGuid = m_barsScheduler.Request(*m_backend, barsRequest, m_lastError);
+      if(!requestGuid.IsEmpty() && barsRequest.subscribe)
+      {
+         m_bars.Add(requestGuid);
+      }
+
+      return requestGuid;
    }
-}
 
-int GetWorkingOrders(ICQGOrders* orders)
-{
-   if(!orders)
+   virtual bool GetBars(const CString& requestGuid, Bars& bars)
    {
-      return 0;
+      return m_bars.Get(requestGuid, bars);
    }
 
-   int count = 0;
-   CComCollection<ICQGOrders, ICQGOrder> q(orders);
-   while(!q.IsEnd())
+   virtual bool CancelBars(const CString& requestGuid)
    {
-      ATL::CComVariant v = q.GetNext();
-      if(q.IsEnd()) break;
+      CHECK_CEL_INIT(false);
 
-      ATL::CComQIPtr<ICQGOrder> spOrder = v.pdispVal;
-      VARIANT_BOOL state = VARIANT_FALSE;
-      spOrder->get_IsFinal(&state);
+      if(!m_bars.Remove(requestGuid))
+      {
+         m_lastError = "Bars request is not subscribed";
+         return false;
+      }
 
-      if(state == VARIANT_FALSE) ++count;
-   }
+      if(m_derivedBars.Cancel(*this, requestGuid))
+      {
+         return true;
+      }
 
-   return count;
-}
+      return cancelTimedBars(requestGuid, m_lastError);
+   }
 
-void GetAccountInfo(ICQGAccount* acc, ICQGAccountSummary* accSum, AccountInfo& account)
-{
-   if(!acc)
+   virtual CString RequestTradeBars(const TradeBarsRequest& request)
    {
-      ATLASSERT(0);
-      return;
-   }
+      CHECK_CEL_INIT(CString());
 
-   acc->get_FcmID(&account.fcmID);
+      if(!m_subscriptions.IsSubscribed(request.symbolId))
+      {
+         m_lastError = "Symbol is not subscribed";
+         return CString();
+      }
 
-   ATL::CComBSTR strFcmAccountID;
-   acc->get_FcmAccountID(&strFcmAccountID);
-   account.fcmAccountID = strFcmAccountID;
+      QuoteEvent lastQuotes;
+      m_quotes.Get(request.symbolId, lastQuotes);
 
-   acc->get_GWAccountID(&account.gwAccountID);
+      const CString requestGuid = m_tradeBars.Add(request, lastQuotes, m_lastError);
+      if(requestGuid.IsEmpty())
+      {
+         return CString();
+      }
 
-   ATL::CComBSTR strGWAccountName;
-   acc->get_GWAccountName(&strGWAccountName);
-   account.gwAccountName = strGWAccountName;
+      // Bars keep symbol subscribed even if user unsubscribes it.
+      m_subscriptions.AddRef(request.symbolId, 1, m_subscriptions.GetTickSize(request.symbolId),
+         m_subscriptions.GetLevel(request.symbolId));
 
-   ATL::CComBSTR strCurrency;
-   acc->get_ReportingCurrency(&strCurrency);
-   account.currency = strCurrency;
+      return requestGuid;
+   }
 
-   account.balance = 0.0;
-   account.ote = 0.0;
-   account.profitLoss = 0.0;
+   virtual bool GetTradeBars(const CString& requestGuid, Bars& bars)
+   {
+      return m_tradeBars.Get(requestGuid, bars);
+   }
 
-   accSum->Balance(0, &account.balance);
-   accSum->OTE(0, &account.ote);
-   accSum->ProfitLoss(0, &account.profitLoss);
-}
+   virtual bool CancelTradeBars(const CString& requestGuid)
+   {
+      CHECK_CEL_INIT(false);
 
-void GetPositionInfo(ICQGPosition* pos, PositionInfo& position)
-{
-   if(!pos)
+      SymbolId symbolId = InvalidSymbolId;
+      if(!m_tradeBars.Remove(requestGuid, symbolId))
+      {
+         m_lastError = "Trade bars request is not found";
+         return false;
+      }
+
+      return releaseSymbol(symbolId, m_lastError);
+   }
+
+   virtual void GetBarsCacheStats(BarsCacheStats& stats)
    {
-      ATLASSERT(0);
-      return;
+      stats = m_barsCacheStats;
+      stats.bars = static_cast<unsigned>(m_barIntervals.GetBarsCount());
+      stats.series = static_cast<unsigned>(m_barIntervals.GetSeriesCount());
    }
 
-   ATL::CComBSTR strSymbol;
-   pos->get_InstrumentName(&strSymbol);
-   position.symbol = strSymbol;
+   virtual bool LogonToGateway(const CString& user, const CString& password)
+   {
+      CHECK_CEL_INIT(false);
+      return m_backend->GWLogon(user, password, m_lastError);
+   }
 
-   eOrderSide side = osdUndefined;
-   pos->get_Side(&side);
-   position.longPosition = side == osdBuy;
+   virtual COleDateTime GetLineTime()
+   {
+      COleDateTime invalidTime;
+      invalidTime.SetStatus(COleDateTime::invalid);
 
-   long qty = 0;
-   pos->get_Quantity(&qty);
-   position.quantity = qty;
+      CHECK_CEL_INIT(invalidTime);
+      return m_backend->GetLineTime(m_lastError);
+   }
 
-   position.averagePrice = InvalidPrice;
-   position.ote = 0.0;
-   position.profitLoss = 0.0;
+   virtual bool GetAccounts(Accounts& accounts)
+   {
+      accounts.clear();
 
-   pos->get_AveragePrice(&position.averagePrice);
-   pos->get_OTE(&position.ote);
-   pos->get_ProfitLoss(&position.profitLoss);
-}
+      CHECK_CEL_INIT(false);
+      return m_backend->GetAccounts(accounts, m_lastError);
+   }
 
-class CQGCELWrapper;
+   virtual bool GetPositions(const ID& gwAccountID, Positions& positions)
+   {
+      positions.clear();
 
-typedef ATL::IDispEventImpl<1, CQGCELWrapper,
-   &__uuidof(_ICQGCELEvents), &__uuidof(__CQG), 4, 0> ICQGCELDispEventImpl;
+      CHECK_CEL_INIT(false);
+      return m_backend->GetPositions(gwAccountID, positions, m_lastError);
+   }
 
-/// @class CCQGCELWrapper
-class CQGCELWrapper : public ICQGCELDispEventImpl
-{
-public:
+   virtual bool GetLocalPositions(const ID& gwAccountID, Positions& positions)
+   {
+      // May be called from any thread, so m_lastError is not touched.
+      return m_positions.GetPositions(gwAccountID, positions);
+   }
 
-   friend struct IAPIFacadeImpl;
+   virtual bool GetLocalProfitLoss(const ID& gwAccountID, MoneyAmount& ote, MoneyAmount& profitLoss)
+   {
+      return m_positions.GetProfitLoss(gwAccountID, ote, profitLoss);
+   }
 
-   /// @brief Initializes CQG API Facade
-   CQGCELWrapper(IAPIEvents* events): m_events(events)
+   virtual void GetLocalAccountsProfitLoss(AccountsProfitLoss& accounts)
    {
-      initializeCQGCEL();
+      m_positions.GetAccountsProfitLoss(accounts);
    }
 
-   /// @brief Finalizes CQG API Facade
-   ~CQGCELWrapper()
+   virtual int GetAllWorkingOrdersCount(const ID& gwAccountID)
    {
-      finalizeCQGCEL();
+      CHECK_CEL_INIT(0);
+      return m_orders.GetWorkingCount(gwAccountID, false);
    }
 
-   /// @brief This map is used to declare handler function for specified event.
-   ///        You can use "OLE/COM Object Viewer" to open CQGCEL-4_0.dll and get event ids.
-   ///        The handler signature as well as the event ids can be found in the type library
-   ///        or shown by "OLE/COM Object Viewer".
-   BEGIN_SINK_MAP(CQGCELWrapper)
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 10, OnDataError)
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 2,  OnGWConnectionStatusChanged)
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 3,  OnDataConnectionStatusChanged)
+   virtual int GetInternalWorkingOrdersCount(const ID& gwAccountID)
+   {
+      CHECK_CEL_INIT(0);
+      return m_orders.GetWorkingCount(gwAccountID, true);
+   }
 
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 7,  OnAccountChanged)
+   virtual int GetSymbolWorkingOrdersCount(const CString& symbolFullName, bool internalOnly)
+   {
+      CHECK_CEL_INIT(0);
+      return m_orders.GetSymbolWorkingCount(symbolFullName, internalOnly);
+   }
 
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 4,  OnInstrumentSubscribed)
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 5,  OnInstrumentChanged)
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 12, OnIncorrectSymbol)
+   virtual CString PlaceOrder(
+      OrderType type,
+      const ID& gwAccountID,
+      const CString& symbolFullName,
+      bool buy,
+      Quantity quantity,
+      const CString& description,
+      const OrderPrice& price,
+      const OrderPrice& stopLimitPrice)
+   {
+      CHECK_CEL_INIT((CString()));
 
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 17, OnOrderChanged)
+      const CString orderGuid = m_backend->PlaceOrder(type, gwAccountID, symbolFullName, buy, quantity,
+         description, price, stopLimitPrice, m_lastError);
 
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 24, OnTimedBarsResolved)
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 25, OnTimedBarsAdded)
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 26, OnTimedBarsUpdated)
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 57, OnTimedBarsInserted)
-      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 58, OnTimedBarsRemoved)
-   END_SINK_MAP()
+      if(!orderGuid.IsEmpty())
+      {
+         registerPlacedOrder(orderGuid, gwAccountID, symbolFullName, buy, quantity, description);
+      }
 
-private:
+      return orderGuid;
+   }
 
-   /// @brief Handle event of some abnormal discrepancy
-   ///        between data expected and data received from CQG.
-   ///        This event also can be fired when CQGCEL startup fails.
-   /// @param obj [in] Object where the error occurred
-   /// @param errorDescription [in] String describing the error
-   /// @return S_OK
-   STDMETHOD(OnDataError)(
-      LPDISPATCH /*obj*/,
-      BSTR errorDescription)
+   virtual unsigned PlaceOrders(const OrderRequests& orders, OrderResults& results)
    {
-      ATLTRACE("CQGCEL::OnDataError\n");
+      results.clear();
+      CHECK_CEL_INIT(0);
 
-      if(m_events)
+      const Clock::time_point start = Clock::now();
+      m_backend->PlaceOrders(orders, results);
+      const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+      unsigned placed = 0;
+      for(size_t i = 0; i < results.size(); ++i)
       {
-         m_events->OnError(CString(errorDescription));
+         if(!results[i].orderGuid.IsEmpty())
+         {
+            const OrderRequest& order = orders[i];
+            registerPlacedOrder(results[i].orderGuid, order.gwAccountID, order.symbolFullName, order.buy,
+               order.quantity, order.description);
+            ++placed;
+         }
       }
 
-      return S_OK;
+      addOrderBatch(m_orderBatchStats.place, orders.size(), orders.size() - placed, elapsed);
+      return placed;
    }
 
-   /// @brief Fired when some changes occurred
-   ///        in the connection with the CQG Gateway.
-   /// @param newStatus [in] New connection status
-   /// @return S_OK
-   STDMETHOD(OnGWConnectionStatusChanged)(
-      eConnectionStatus newStatus)
+   virtual unsigned CancelOrders(const OrderGuids& orderGuids, OrderResults& results)
    {
-      ATLTRACE("CQGCEL::OnGWConnectionStatusChanged\n");
+      results.clear();
+      CHECK_CEL_INIT(0);
+
+      const Clock::time_point start = Clock::now();
 
-      const bool connected = (newStatus == csConnectionUp);
-      if(connected)
+      // Final orders are refused without backend.
+      results.resize(orderGuids.size());
+      for(size_t i = 0; i < orderGuids.size(); ++i)
       {
-         // Subscribe to accounts, positions & order events
-         HRESULT hr = m_spCQGCEL->put_AccountSubscriptionLevel(aslAccountUpdatesAndOrders);
-         CheckCOMError(m_spCQGCEL, hr);
+         results[i].orderGuid = orderGuids[i];
+         if(m_orders.IsFinal(orderGuids[i]))
+         {
+            results[i].error = "Order cannot be cancelled";
+         }
       }
 
-      if(m_events)
+      m_backend->CancelOrders(orderGuids, results);
+      const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+      unsigned canceled = 0;
+      for(size_t i = 0; i < results.size(); ++i)
       {
-         m_events->OnTradingConnection(connected);
+         canceled += results[i].error.IsEmpty() ? 1 : 0;
       }
 
-      return S_OK;
+      addOrderBatch(m_orderBatchStats.cancel, orderGuids.size(), orderGuids.size() - canceled, elapsed);
+      return canceled;
    }
 
-   /// @brief Fired when some changes occurred
-   ///        in the connection with the CQG data server.
-   /// @param newStatus [in] New connection status
-   /// @return S_OK
-   STDMETHOD(OnDataConnectionStatusChanged)(
-      eConnectionStatus newStatus)
+   virtual void GetOrderBatchStats(OrderBatchStats& stats)
    {
-      ATLTRACE("CQGCEL::OnDataConnectionStatusChanged\n");
-
-      if(m_events)
-      {
-         m_events->OnMarketDataConnection(newStatus == csConnectionUp);
-      }
-
-      return S_OK;
+      stats = m_orderBatchStats;
    }
 
-   /// @brief Fired when new account is added, changed or removed.
-   /// @param change [in] Account change type
-   /// @param account [in] Changed account instance
-   /// @param position [in] Changed position instance
-   /// @return S_OK
-   STDMETHOD(OnAccountChanged)(
-      eAccountChangeType change,
-      ICQGAccount* account,
-      ICQGPosition* position)
+   virtual OrderTicketId PrepareOrderTicket(const OrderTicket& ticket)
    {
-      ATLTRACE("CQGCEL::OnAccountChanged\n");
+      CHECK_CEL_INIT(InvalidOrderTicketId);
 
-      if(!m_events)
+      if(ticket.quantity == 0 ||
+         (ticket.type != Market && ticket.type != Limit && ticket.type != Stop && ticket.type != StopLimit))
       {
-         return S_OK;
+         m_lastError = "Invalid order ticket parameters";
+         return InvalidOrderTicketId;
       }
 
-      if(change == actAccountsReloaded)
+      // Released slots are reused, so tickets prepared per signal don't grow tickets tables.
+      if(m_freeTickets.empty() && m_tickets.size() >= TicketSlotMask)
       {
-         m_events->OnAccountsReloaded();
+         m_lastError = "Too many order tickets";
+         return InvalidOrderTicketId;
       }
-      else if(change == actPositionsReloaded)
-      {
-         m_events->OnPositionsReloaded();
-      }
-      else if(change == actAccountChanged || change == actPositionAdded || change == actPositionChanged)
-      {
-         ATL::CComPtr<ICQGAccountSummary> spAccSum;
-         HRESULT hr = account->get_Summary(&spAccSum);
-         CheckCOMError<ICQGAccount>(account, hr);
 
-         AccountInfo accountInfo;
-         GetAccountInfo(account, spAccSum, accountInfo);
+      const OrderTicketId slot = m_freeTickets.empty() ?
+         static_cast<OrderTicketId>(m_tickets.size() + 1) : m_freeTickets.back();
 
-         if(change == actAccountChanged)
-         {
-            m_events->OnAccountChanged(accountInfo);
-         }
-         else
-         {
-            PositionInfo positionInfo;
-            GetPositionInfo(position, positionInfo);
+      if(!m_backend->PrepareOrderTicket(slot, ticket, m_lastError))
+      {
+         return InvalidOrderTicketId;
+      }
 
-            m_events->OnPositionChanged(accountInfo, positionInfo, change == actPositionAdded);
-         }
+      if(m_freeTickets.empty())
+      {
+         m_tickets.push_back(PreparedTicket());
+      }
+      else
+      {
+         m_freeTickets.pop_back();
       }
 
-      return S_OK;
+      PreparedTicket& prepared = m_tickets[slot - 1];
+      prepared.prepared = true;
+      prepared.quantity = ticket.quantity;
+      prepared.order.symbol = ticket.symbolFullName;
+      prepared.order.gwAccountID = ticket.gwAccountID;
+      prepared.order.buy = ticket.buy;
+      prepared.order.final = false;
+      prepared.order.modifyPending = false;
+      prepared.order.fillSeq = 0;
+      prepared.order.filledQty = 0;
+      prepared.order.description = ticket.description;
+
+      return (prepared.generation << TicketSlotBits) | slot;
    }
 
-   /// @brief Fired when new instrument is resolved and subscribed.
-   /// @param symbol [in] Requested symbol
-   /// @param instrument [in] Subscribed instrument object
-   /// @return S_OK
-   STDMETHOD(OnInstrumentSubscribed)(
-      BSTR symbol,
-      ICQGInstrument* instrument)
+   virtual CString SubmitOrderTicket(
+      OrderTicketId ticketId,
+      const OrderPrice& price,
+      Quantity quantity,
+      const OrderPrice& stopLimitPrice)
    {
-      ATLTRACE("CQGCEL::OnInstrumentSubscribed\n");
+      CHECK_CEL_INIT((CString()));
 
-      if(m_events)
+      PreparedTicket* ticket = findTicket(ticketId);
+      if(!ticket)
       {
-         ATL::CComBSTR strSymbol;
-         HRESULT hr = instrument->get_FullName(&strSymbol);
-         CheckCOMError<ICQGInstrument>(instrument, hr);
-
-         SymbolInfo symInfo;
-         symInfo.fullName = strSymbol;
+         m_lastError = "Order ticket is not found";
+         return CString();
+      }
 
-         ATL::CComPtr<ICQGQuotes> quotes;
-         hr = instrument->get_Quotes(&quotes);
-         CheckCOMError<ICQGInstrument>(instrument, hr);
+      const Quantity orderQuantity = quantity ? quantity : ticket->quantity;
 
-         GetAllQuotes(quotes, symInfo);
+      const CString orderGuid =
+         m_backend->SubmitOrderTicket(ticketId & TicketSlotMask, price, orderQuantity, stopLimitPrice, m_lastError);
 
-         m_events->OnSymbolSubscribed(CString(symbol), symInfo);
+      if(!orderGuid.IsEmpty())
+      {
+         ticket->order.orderGuid = orderGuid;
+         ticket->order.quantity = orderQuantity;
+         m_orders.OnPlaced(ticket->order);
       }
 
-      return S_OK;
+      return orderGuid;
    }
 
-   /// @brief Fired when any of instrument quotes or
-   ///        dynamic instrument properties are changed.
-   /// @param instrument [in] Changed instrument object
-   /// @param quotes [in] Changed quotes collection
-   /// @param props [in] Changed properties collection
-   /// @return S_OK
-   STDMETHOD(OnInstrumentChanged)(
-      ICQGInstrument* instrument,
-      ICQGQuotes* quotes,
-      ICQGInstrumentProperties* /*props*/)
+   virtual bool ReleaseOrderTicket(OrderTicketId ticketId)
    {
-      ATLTRACE("CQGCEL::OnInstrumentChanged\n");
+      CHECK_CEL_INIT(false);
 
-      if(m_events)
+      PreparedTicket* ticket = findTicket(ticketId);
+      if(!ticket)
       {
-         ATL::CComBSTR str;
-         HRESULT hr = instrument->get_FullName(&str);
-         CheckCOMError<ICQGInstrument>(instrument, hr);
-
-         SymbolInfo symInfo;
-         symInfo.fullName = str;
-
-         GetAllQuotes(quotes, symInfo);
-
-         m_events->OnSymbolQuote(symInfo);
+         m_lastError = "Order ticket is not found";
+         return false;
       }
 
-      return S_OK;
+      // The next generation makes identifiers of released ticket unknown.
+      const unsigned generation = (ticket->generation + 1) & TicketGenerationMask;
+      *ticket = PreparedTicket();
+      ticket->generation = generation;
+
+      const OrderTicketId slot = ticketId & TicketSlotMask;
+      m_freeTickets.push_back(slot);
+      m_backend->ReleaseOrderTicket(slot);
+      return true;
    }
 
-   /// @brief This event is fired when a not tradable symbol name has been 
-   ///         passed to the NewInstrument method.
-   /// @param wrongSymbol [in] Requested symbol
-   /// @return S_OK
-   STDMETHOD(OnIncorrectSymbol)(BSTR wrongSymbol)
+   virtual bool CancelOrder(const CString& orderGuid)
    {
-      ATLTRACE("CQGCEL::OnIncorrectSymbol\n");
+      CHECK_CEL_INIT(false);
 
-      if(m_events)
+      if(m_orders.IsFinal(orderGuid))
       {
-         m_events->OnSymbolError(CString(wrongSymbol));
+         m_lastError = "Order cannot be cancelled";
+         return false;
       }
 
-      return S_OK;
+      return m_backend->CancelOrder(orderGuid, m_lastError);
    }
 
-   /// @brief Fired when new order was added, order status was 
-   ///        changed or the order was removed.
-   /// @param change [in] The type of the occurred change
-   /// @param order [in] CQGOrder object representing the order to which the change refers
-   /// @param oldProperties [in] CQGOrderProperties collection representing 
-   ///        the old values of the changed order properties
-   /// @param fill [in] CQGFill object representing the last fill of the order
-   /// @param cqgerr [in] CQGError object to describe the last error, if any
-   /// @return S_OK
-   STDMETHOD(OnOrderChanged)(
-      eChangeType /*change*/,
-      ICQGOrder* order,
-      ICQGOrderProperties* /*oldProperties*/,
-      ICQGFill* fill,
-      ICQGError* cqgerr)
+   virtual bool ModifyOrder(
+      const CString& orderGuid,
+      const OrderPrice& price,
+      const OrderPrice& stopLimitPrice,
+      Quantity quantity)
    {
-      ATLTRACE("CQGCEL::OnOrderChanged\n");
+      CHECK_CEL_INIT(false);
 
-      if(m_events)
+      if(!price.initialized() && !stopLimitPrice.initialized() && quantity == 0)
       {
-         OrderInfo orderInfo;
-
-         ATL::CComBSTR strGuid;
-         order->get_GUID(&strGuid);
-         orderInfo.orderGuid = strGuid;
-
-         ATL::CComBSTR strSymbol;
-         order->get_InstrumentName(&strSymbol);
-         orderInfo.symbol = strSymbol;
-
-         ATL::CComPtr<ICQGAccount> spAcc;
-         order->get_Account(&spAcc);
-         spAcc->get_GWAccountID(&orderInfo.gwAccountID);
-
-         eOrderSide side = osdUndefined;
-         order->get_Side(&side);
-         orderInfo.buy = side == osdBuy;
-
-         VARIANT_BOOL state = VARIANT_FALSE;
-         order->get_IsFinal(&state);
-         orderInfo.final = state == VARIANT_TRUE;
-
-         long qty = 0;
-         order->get_Quantity(&qty);
-         orderInfo.quantity = qty;
-
-         long filledQty = 0;
-         order->get_FilledQuantity(&filledQty);
-         orderInfo.filledQty = filledQty;
+         m_lastError = "Nothing to modify";
+         return false;
+      }
 
-         ATL::CComBSTR description;
-         order->get_Description(&description);
-         orderInfo.description = description;
+      if(m_orders.IsFinal(orderGuid))
+      {
+         m_lastError = "Order cannot be modified";
+         return false;
+      }
 
-         ATL::CComBSTR originOrderID;
-         order->get_OriginalOrderID(&originOrderID);
-         orderInfo.gwOrderID = originOrderID;
+      if(m_orders.IsModifyPending(orderGuid))
+      {
+         m_lastError = "Order modification is pending";
+         return false;
+      }
 
-         if(checkValidPtr(fill))
-         {
-            long legCount = 0;
-            fill->get_LegCount(&legCount);
+      if(quantity != 0 && quantity <= m_orders.GetFilledQty(orderGuid))
+      {
+         m_lastError = "Order quantity must exceed filled quantity";
+         return false;
+      }
 
-            eFillStatus status = fsNormal;
-            fill->get_Status(&status);
+      const Clock::time_point sent = Clock::now();
+      if(!m_backend->ModifyOrder(orderGuid, price, stopLimitPrice, quantity, m_lastError))
+      {
+         return false;
+      }
 
-            orderInfo.orderFills.reserve(legCount);
+      m_orders.OnModifySent(orderGuid, quantity, sent);
+      return true;
+   }
 
-            for(long i = 0; i < legCount; ++i)
-            {
-               FillInfo fillInfo;
+   virtual void GetOrderModifyStats(OrderModifyStats& stats)
+   {
+      m_orders.GetModifyStats(stats);
+   }
 
-               fillInfo.canceled = (status == fsCanceled) || (status == fsBusted);
+   virtual bool GetOrder(const CString& orderGuid, OrderInfo& order)
+   {
+      return m_orders.Get(orderGuid, order);
+   }
 
-               ATL::CComBSTR strSymbol;
-               fill->get_InstrumentName(i, &strSymbol);
-               fillInfo.symbol = strSymbol;
+   virtual bool GetOrderByGwOrderID(const GWOrderID& gwOrderID, OrderInfo& order)
+   {
+      return m_orders.GetByGwOrderID(gwOrderID, order);
+   }
 
-               fill->get_Price(i, &fillInfo.fillPrice);
-               fill->get_Quantity(i, &fillInfo.fillQty);
+   virtual bool CancelAllOrders(
+      const ID& gwAccountID,
+      const CString& symbolFullName)
+   {
+      CHECK_CEL_INIT(false);
+      return m_backend->CancelAllOrders(gwAccountID, symbolFullName, m_lastError);
+   }
 
-               orderInfo.orderFills.push_back(fillInfo);
-            }
-         }
+   /// @}
 
-         if(checkValidPtr(cqgerr))
-         {
-            ATL::CComBSTR errorDesc;
-            cqgerr->get_Description(&errorDesc);
-            orderInfo.error = errorDesc;
-         }
+   /// @name IBackendEvents implementation.
+   /// @{
 
-         m_events->OnOrderChanged(orderInfo);
+   virtual void OnDataError(const CString& error)
+   {
+      if(m_events)
+      {
+         m_events->OnError(error);
       }
-
-      return S_OK;
    }
 
-   STDMETHOD(OnTimedBarsResolved)(
-      ICQGTimedBars* cqgTimedBars,
-      ICQGError* cqgerr)
+   virtual void OnDataConnectionStatusChanged(const bool connected)
    {
-      ATLTRACE("CQGCEL::OnTimedBarsResolved\n");
+      if(m_events)
+      {
+         m_events->OnMarketDataConnection(connected);
+      }
+   }
 
+   virtual void OnGWConnectionStatusChanged(const bool connected)
+   {
       if(m_events)
       {
-         ATL::CComBSTR requestID;
-         Bars bars;
+         m_events->OnTradingConnection(connected);
+      }
+   }
 
-         cqgTimedBars->get_Id(&requestID);
-         bars.requestGuid = CString(requestID);
+   virtual void OnAccountsReloaded()
+   {
+      if(m_events)
+      {
+         m_events->OnAccountsReloaded();
+      }
+   }
 
-         if(checkValidPtr(cqgerr))
-         {
-            ATL::CComBSTR errorDesc;
-            cqgerr->get_Description(&errorDesc);
-            bars.error = errorDesc;
-         }
+   virtual void OnPositionsReloaded()
+   {
+      // Local positions start from CQGCEL ones, fills & quotes keep them updated afterwards.
+      Accounts accounts;
+      CString error;
+      m_backend->GetAccounts(accounts, error);
 
-         eRequestStatus status;
-         cqgTimedBars->get_Status(&status);
-         if(bars.error.IsEmpty() && status != rsSuccess)
+      for(size_t i = 0; i < accounts.size(); ++i)
+      {
+         Positions positions;
+         if(!m_backend->GetPositions(accounts[i].gwAccountID, positions, error))
          {
-            bars.error = "Bars request failed, cancelled or pending.";
+            continue;
          }
 
-         bars.requestedCount = 0;
-         cqgTimedBars->get_Count(&bars.requestedCount);
-
-         bars.bars.reserve(bars.requestedCount);
-
-         for(long i = 0; i < bars.requestedCount; ++i)
+         std::vector<SymbolId> symbolIds(positions.size());
+         for(size_t j = 0; j < positions.size(); ++j)
          {
-            ATL::CComPtr<ICQGTimedBar> spBar;
-            cqgTimedBars->get_Item(i, &spBar);
-
-            BarInfo bar;
-            spBar->get_Timestamp(&bar.timestamp.m_dt);
-            spBar->get_Open(&bar.open);
-            spBar->get_High(&bar.high);
-            spBar->get_Low(&bar.low);
-            spBar->get_Close(&bar.close);
-
-            // Skip invalid bars.
-            if(!checkValid(bar.open)) continue;
-
-            bars.bars.push_back(bar);
+            symbolIds[j] = m_symbols.Intern(positions[j].symbol);
          }
 
-         m_events->OnBarsReceived(bars);
+         m_positions.Reset(accounts[i].gwAccountID, positions, symbolIds);
       }
 
-      return S_OK;
+      if(m_events)
+      {
+         m_events->OnPositionsReloaded();
+      }
    }
 
-   STDMETHOD(OnTimedBarsAdded)(
-      ICQGTimedBars* /*cqgTimedBars*/)
+   virtual void OnAccountChanged(const AccountInfo& account)
    {
-      ATLTRACE("CQGCEL::OnTimedBarsAdded\n");
-      return S_OK;
+      if(m_events)
+      {
+         m_events->OnAccountChanged(account);
+      }
    }
 
-   STDMETHOD(OnTimedBarsUpdated)(
-      ICQGTimedBars* /*cqgTimedBars*/,
-      long /*barIndex*/)
+   virtual void OnPositionChanged(
+      const AccountInfo& account,
+      const PositionInfo& position,
+      const bool newPosition)
    {
-       ATLTRACE("CQGCEL::OnTimedBarsUpdated\n");
-       return S_OK;
+      if(m_events)
+      {
+         m_events->OnPositionChanged(account, position, newPosition);
+      }
    }
 
-   STDMETHOD(OnTimedBarsInserted)(
-      ICQGTimedBars* /*cqgTimedBars*/,
-      long /*barIndex*/)
+   virtual SymbolId OnInstrumentSubscribed(
+      const CString& requestedSymbol,
+      const CString& fullName,
+      const Price tickSize,
+      const MoneyAmount tickValue,
+      const QuoteEvent& quotes)
    {
-      ATLTRACE("CQGCEL::OnTimedBarsInserted\n");
-      return S_OK;
-   }
+      const SymbolId id = m_symbols.Intern(fullName);
 
-   STDMETHOD(OnTimedBarsRemoved)(
-      ICQGTimedBars* /*cqgTimedBars*/,
-      long /*barIndex*/)
-   {
-      ATLTRACE("CQGCEL::OnTimedBarsRemoved\n");
-      return S_OK;
-   }
+      QuoteEvent initialQuotes = quotes;
+      initialQuotes.symbolId = id;
 
-private:
+      QuoteEvent changed;
+      m_quotes.Update(initialQuotes, changed);
 
-   /// @brief Initializes CQGCEL object, starts the CQGCEL and subscribes to events.
-   void initializeCQGCEL()
-   {
-      // Create an instance of CQG API
-      HRESULT hr = m_spCQGCEL.CoCreateInstance(__uuidof(CQGCEL), NULL, CLSCTX_INPROC_SERVER);
-      if(FAILED(hr))
+      if(m_settings.conflateQuotes)
       {
-         throw std::runtime_error("Unable to create CQGCEL COM object. "
-            "Please register it again and restart application.");
+         m_conflator.AddSymbol(id, fullName);
       }
 
-      ATLASSERT(m_spCQGCEL);
-
-      // Configure CQGCEL behavior
-      ATL::CComPtr<ICQGAPIConfig> spConf;
-      hr = m_spCQGCEL->get_APIConfiguration(&spConf);
-      CheckCOMError(m_spCQGCEL, hr);
-
-      hr = spConf->put_ReadyStatusCheck(rscOff);
-      CheckCOMError(spConf, hr);
+      SymbolInfo symInfo;
+      symInfo.id = id;
+      symInfo.fullName = fullName;
+      symInfo.tickSize = tickSize;
+      symInfo.tickValue = tickValue;
+      GetQuotes(quotes, symInfo.lastQuotes);
 
-      hr = spConf->put_UsedFromATLClient(VARIANT_TRUE);
-      CheckCOMError(spConf, hr);
+      m_positions.SetPointValue(id, tickSize, tickValue);
+      m_positions.OnQuotes(initialQuotes);
 
-      hr = spConf->put_CollectionsThrowException(VARIANT_FALSE);
-      CheckCOMError(spConf, hr);
-
-      hr = spConf->put_TimeZoneCode(tzCentral);
-      CheckCOMError(spConf, hr);
-
-      hr = spConf->put_UseOrderSide(VARIANT_TRUE);
-      CheckCOMError(spConf, hr);
+      if(m_events)
+      {
+         m_events->OnSymbolSubscribed(requestedSymbol, symInfo);
+      }
 
-      // Default is dsQuotesAndBBA - receive best bid/best ask and trade quotes
-      // To switch to trades only market data notifications replace X with dsQuotes
-      // To switch to trades & full DOM market data notifications replace X with dsQuotesAndDOM
-      // hr = spConf->put_DefaultInstrumentSubscriptionLevel();
-      // CheckCOMError(spConf, hr);
+      // Each batch waiting for the symbol holds its own reference.
+      SymbolsBatches completed;
+      const unsigned batches = m_batches.OnResolved(requestedSymbol, symInfo, completed);
 
-      // Switch full position notifications
-      hr = spConf->put_DefPositionSubscriptionLevel(pslSnapshotAndUpdates);
-      CheckCOMError(spConf, hr);
+      const SubscriptionLevel level = m_settings.marketDepth ? TradesAndDOMLevel : TradesAndBBALevel;
+      if(m_subscriptions.AddRef(id, batches ? batches : 1, tickSize, level) &&
+         m_subscriptions.GetLevel(id) == TradesAndDOMLevel)
+      {
+         m_books.AddSymbol(id, tickSize);
+      }
 
-      // Now advise the connection, to get events
-      ATLVERIFY(SUCCEEDED(ICQGCELDispEventImpl::DispEventAdvise(m_spCQGCEL)));
+      fireBatchesCompleted(completed);
 
-      // Start CQGCEL
-      hr = m_spCQGCEL->Startup();
-      CheckCOMError(m_spCQGCEL, hr);
+      return id;
    }
 
-   /// @brief Unsubscribes from events, shuts down the CQGCEL and finalizes CQGCEL object.
-   void finalizeCQGCEL() throw()
+   virtual void OnInstrumentChanged(const QuoteEvent& quotes)
    {
-      m_events = NULL;
-      if (m_spCQGCEL)
+      if(!m_subscriptions.IsSubscribed(quotes.symbolId))
       {
-         ATLVERIFY(SUCCEEDED(ICQGCELDispEventImpl::DispEventUnadvise(m_spCQGCEL)));
-         ATLVERIFY(SUCCEEDED(m_spCQGCEL->Shutdown()));
-         m_spCQGCEL.Release();
+         // Update queued by CQGCEL before symbol was unsubscribed.
+         return;
       }
-   }
 
-   template <typename Interface>
-   bool checkValidPtr(Interface* obj)
-   {
-      if(!obj)
+      QuoteEvent changed;
+      m_quotes.Update(quotes, changed);
+
+      m_tradeBars.OnQuotes(quotes, m_closedTradeBars);
+      m_positions.OnQuotes(quotes);
+
+      if(!m_events)
       {
-         return false;
+         return;
       }
 
-      return checkValid(obj);
-   }
-
-   template <typename Object>
-   bool checkValid(Object obj)
-   {
-      VARIANT_BOOL valid = VARIANT_FALSE;
-      m_spCQGCEL->IsValid(ATL::CComVariant(obj), &valid);
-      return (valid == VARIANT_TRUE);
-   }
+      for(size_t i = 0; i < m_closedTradeBars.size(); ++i)
+      {
+         m_events->OnTradeBarClosed(m_closedTradeBars[i].requestGuid, m_closedTradeBars[i].bar);
+      }
 
-   ATL::CComPtr<ICQGCEL> m_spCQGCEL; ///< CQGCEL object.
-   IAPIEvents* m_events;             ///< User API events listener.
-}; // class CQGCELWrapper
+      if(m_settings.deltaQuotes && changed.count == 0)
+      {
+         return;
+      }
 
+      const QuoteEvent& update = m_settings.deltaQuotes ? changed : quotes;
 
-#define CHECK_CEL_INIT(res)                 \
-m_lastError.Empty();                        \
-if(!IsValid())                              \
-{                                           \
-   ATLASSERT(0);                            \
-   m_lastError = "CQGCVEL not initialized"; \
-   return res;                              \
-}
+      if(m_settings.conflateQuotes)
+      {
+         if(m_conflator.Push(update))
+         {
+            m_events->OnQuotesPending();
+         }
 
-#define RETURN_CEL_RESULT(hr)                     \
-m_lastError = GetCOMError(m_api->m_spCQGCEL, hr); \
-return m_lastError.IsEmpty();
+         return;
+      }
 
-#define RETURN_CEL_OBJ_RESULT(obj, hr, res) \
-m_lastError = GetCOMError(obj, hr);         \
-return res;
+      if(m_settings.quoteEvents)
+      {
+         m_events->OnQuoteEvent(update);
+         return;
+      }
 
-#define CHECK_CEL_OBJ_RESULT(obj, hr, res) \
-if(hr != S_OK)                             \
-{                                          \
-   RETURN_CEL_OBJ_RESULT(obj, hr, res)     \
-}
+      SymbolInfo symInfo;
+      symInfo.id = update.symbolId;
+      symInfo.fullName = m_symbols.GetName(update.symbolId);
+      GetQuotes(update, symInfo.lastQuotes);
 
-/// @class IAPIFacadeImpl
-struct IAPIFacadeImpl: IAPIFacade
-{
+      m_events->OnSymbolQuote(symInfo);
+   }
 
-   virtual bool IsValid()
+   virtual void OnInstrumentDOMChanged(const MarketDepth& depth)
    {
-      return m_api.get() != NULL;
+      // Symbols not subscribed at TradesAndDOMLevel have no books.
+      DepthUpdate update;
+      if(m_books.Apply(depth, update) && update.count && m_events)
+      {
+         m_events->OnDepthUpdate(update);
+      }
    }
 
-   virtual CString GetLastError()
+   virtual void OnIncorrectSymbol(const CString& symbol)
    {
-      return m_lastError;
+      if(m_events)
+      {
+         m_events->OnSymbolError(symbol);
+      }
+
+      SymbolsBatches completed;
+      m_batches.OnFailed(symbol, completed);
+      fireBatchesCompleted(completed);
    }
 
-   virtual bool Initialize(IAPIEvents* events)
+   virtual void OnOrderChanged(OrderInfo& order, const FillKey& lastFill)
    {
-      m_lastError.Empty();
+      // Order registry drops already reported fill, so positions get each fill once.
+      m_orders.OnChanged(order, lastFill);
 
-      if(m_api.get() != NULL)
+      for(size_t i = 0; i < order.orderFills.size(); ++i)
       {
-         ATLASSERT(0);
-         m_lastError = "CQGCEL already initialized";
-         return false;
+         const FillInfo& fill = order.orderFills[i];
+         m_positions.OnFill(order.gwAccountID, m_symbols.Intern(fill.symbol), order.buy, fill);
       }
 
-      try
+      if(!m_events)
       {
-         m_api.reset(new CQGCELWrapper(events));
+         return;
       }
-      catch(std::exception& ex)
+
+      if(!m_settings.fillEvents)
       {
-         m_lastError = CString("Unable to initialize CQGCEL: ") + ex.what();
-         return false;
+         m_events->OnOrderChanged(order);
+         return;
       }
-      catch(...)
+
+      FillEvent fill;
+      fill.orderGuid = order.orderGuid;
+      fill.fillSeq = order.fillSeq;
+
+      for(size_t i = 0; i < order.orderFills.size(); ++i)
       {
-         m_lastError = "Unable to initialize CQGCEL: Unknown exception";
-         return false;
+         fill.leg = static_cast<unsigned>(i);
+         fill.fill = order.orderFills[i];
+         m_events->OnFill(fill);
       }
 
-      return true;
+      OrderStateEvent state;
+      state.orderGuid = order.orderGuid;
+      state.gwOrderID = order.gwOrderID;
+      state.final = order.final;
+      state.modifyPending = order.modifyPending;
+      state.quantity = order.quantity;
+      state.filledQty = order.filledQty;
+      state.fillSeq = order.fillSeq;
+      state.error = order.error;
+      m_events->OnOrderState(state);
    }
 
-   virtual bool RequestSymbol(const CString& symbol)
+   virtual void OnTimedBarsResolved(const Bars& bars)
    {
-      CHECK_CEL_INIT(false);
-      RETURN_CEL_RESULT(m_api->m_spCQGCEL->NewInstrument(ATL::CComBSTR(symbol)));
+      // Result may belong to several requests, freed slot may let queued requests fail.
+      std::vector<Bars> resolved;
+      m_barsScheduler.OnResolved(*m_backend, bars, resolved);
+
+      for(size_t i = 0; i < resolved.size(); ++i)
+      {
+         resolveBars(resolved[i]);
+      }
    }
 
-   virtual CString RequestBars(const BarsRequest& barsRequest)
+   virtual void OnTimedBarsChanged(const BarsUpdate& update)
    {
-      CHECK_CEL_INIT(CString());
-
-      ATL::CComPtr<ICQGTimedBarsRequest> spRequest;
-      HRESULT hr = m_api->m_spCQGCEL->CreateTimedBarsRequest(&spRequest);
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, CString());
-
-      ATL::CComBSTR symbol(barsRequest.symbol);
-      hr = spRequest->put_Symbol(symbol);
-      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
-
-      const ATL::CComVariant startRange = barsRequest.useIndexRange ?
-         ATL::CComVariant(barsRequest.startIndex) : ATL::CComVariant(barsRequest.startDate.m_dt, VT_DATE);
-
-      const ATL::CComVariant endRange = barsRequest.useIndexRange ?
-         ATL::CComVariant(barsRequest.endIndex) : ATL::CComVariant(barsRequest.endDate.m_dt, VT_DATE);
-
-      hr = spRequest->put_RangeStart(startRange);
-      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
-
-      hr = spRequest->put_RangeEnd(endRange);
-      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
-
-      hr = spRequest->put_IntradayPeriod(barsRequest.intradayPeriodInMinutes);
-      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
+      std::vector<BarsUpdate> derived;
+      if(!m_derivedBars.OnBaseChanged(update, derived))
+      {
+         updateBars(update);
+         return;
+      }
 
-      hr = spRequest->put_SessionsFilter(ATL::CComVariant(barsRequest.sessionsFilter));
-      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
+      for(size_t i = 0; i < derived.size(); ++i)
+      {
+         updateBars(derived[i]);
+      }
+   }
 
-      ATL::CComPtr<ICQGTimedBars> spTimedBars;
-      hr = m_api->m_spCQGCEL->RequestTimedBars(spRequest, &spTimedBars);
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, CString());
+   /// @}
 
-      ATL::CComBSTR requestID;
-      spTimedBars->get_Id(&requestID);
-      return CString(requestID);
-   }
+   /// @name IBaseBarsSource implementation.
+   /// @{
 
-   virtual bool LogonToGateway(const CString& user, const CString& password)
+   virtual CString RequestBaseBars(const BarsRequest& request, CString& error)
    {
-      CHECK_CEL_INIT(false);
-      RETURN_CEL_RESULT(m_api->m_spCQGCEL->GWLogon(ATL::CComBSTR(user), ATL::CComBSTR(password)));
+      ++m_barsCacheStats.upstream;
+      return m_barsScheduler.Request(*m_backend, request, error);
    }
 
-   virtual COleDateTime GetLineTime()
+   virtual void CancelBaseBars(const CString& requestGuid)
    {
-      COleDateTime invalidTime;
-      invalidTime.SetStatus(COleDateTime::invalid);
-
-      ATL::CComPtr<ICQGEnvironment> spEnvironment;
-      HRESULT hr = m_api->m_spCQGCEL->get_Environment(&spEnvironment);
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, invalidTime);
+      CString error;
+      cancelTimedBars(requestGuid, error);
+   }
 
-      DATE lineTime;
-      hr = spEnvironment->get_LineTime(&lineTime);
-      CHECK_CEL_OBJ_RESULT(spEnvironment, hr, invalidTime);
+   /// @}
 
-      if(lineTime == 0.0) return invalidTime;
+   /// @brief Releases symbol subscription reference, removes CQGCEL instrument on the last one.
+   bool releaseSymbol(const SymbolId symbolId, CString& error)
+   {
+      if(m_subscriptions.Release(symbolId) > 0)
+      {
+         return true;
+      }
 
-      return COleDateTime(lineTime);
+      m_books.RemoveSymbol(symbolId);
+      return m_backend->RemoveInstrument(symbolId, error);
    }
 
-   virtual bool GetAccounts(Accounts& accounts)
+   /// @brief Cancels CQGCEL timed bars request.
+   bool cancelTimedBars(const CString& requestGuid, CString& error)
    {
-      accounts.clear();
-
-      CHECK_CEL_INIT(false);
-
-      ATL::CComPtr<ICQGAccounts> spAccounts;
-      HRESULT hr = m_api->m_spCQGCEL->get_Accounts(&spAccounts);
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, false);
-
-      long count = 0;
-      hr = spAccounts->get_Count(&count);
-      CHECK_CEL_OBJ_RESULT(spAccounts, hr, false);
-
-      accounts.reserve(count);
-
-      for(long i = 0; i < count; ++i)
+      if(!m_backend->RemoveTimedBars(requestGuid, error))
       {
-         ATL::CComPtr<ICQGAccount> spAcc;
-         hr = spAccounts->get_ItemByIndex(i, &spAcc);
-         CHECK_CEL_OBJ_RESULT(spAccounts, hr, false);
+         return false;
+      }
 
-         ATL::CComPtr<ICQGAccountSummary> spAccSum;
-         if(spAcc)
-         {
-            hr = spAcc->get_Summary(&spAccSum);
-            CHECK_CEL_OBJ_RESULT(spAcc, hr, false);
-         }
+      // Request canceled before resolving never resolves, so its slot is freed here.
+      std::vector<Bars> resolved;
+      m_barsScheduler.OnCanceled(*m_backend, requestGuid, resolved);
 
-         AccountInfo account;
-         GetAccountInfo(spAcc, spAccSum, account);
-         accounts.push_back(account);
+      for(size_t i = 0; i < resolved.size(); ++i)
+      {
+         resolveBars(resolved[i]);
       }
 
       return true;
    }
 
-   typedef ATL::CComPtr<ICQGAccount> ICQGAccountPtr;
-
-   ICQGAccountPtr getAccount(const ID& gwAccountID)
+   /// @brief Sends base requests of derived requests made.
+   void sendBaseBars()
    {
-      ICQGAccountPtr spAccount;
+      std::vector<Bars> failed;
+      m_derivedBars.SendBases(*this, failed);
 
-      ATL::CComPtr<ICQGAccounts> spAccounts;
-      HRESULT hr = m_api->m_spCQGCEL->get_Accounts(&spAccounts);
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, spAccount);
-
-      hr = spAccounts->get_Item(gwAccountID, &spAccount);
-      CHECK_CEL_OBJ_RESULT(spAccounts, hr, spAccount);
-
-      return spAccount;
+      for(size_t i = 0; i < failed.size(); ++i)
+      {
+         resolveBars(failed[i]);
+      }
    }
 
-   virtual bool GetPositions(const ID& gwAccountID, Positions& positions)
+   /// @brief Reports bars of derived request attached to already resolved base request.
+   void resolveDerivedBars(const CString& requestGuid)
    {
-      positions.clear();
-
-      CHECK_CEL_INIT(false);
-
-      ICQGAccountPtr spAccount = getAccount(gwAccountID);
-      if(!spAccount) return false;
-
-      ATL::CComPtr<ICQGPositions> spPositions;
-      HRESULT hr = spAccount->get_Positions(&spPositions);
-      CHECK_CEL_OBJ_RESULT(spAccount, hr, false);
-
-      long count = 0;
-      hr = spPositions->get_Count(&count);
-      CHECK_CEL_OBJ_RESULT(spPositions, hr, false);
-
-      positions.reserve(count);
-
-      for(long i = 0; i < count; ++i)
+      Bars bars;
+      if(m_derivedBars.Resolve(requestGuid, bars))
       {
-         ATL::CComPtr<ICQGPosition> spPos;
-         hr = spPositions->get_ItemByIndex(i, &spPos);
-         CHECK_CEL_OBJ_RESULT(spPositions, hr, false);
-
-         PositionInfo position;
-         GetPositionInfo(spPos, position);
-         positions.push_back(position);
+         resolveBars(bars);
       }
-
-      return true;
    }
 
-   typedef ATL::CComPtr<ICQGOrders> ICQGOrdersPtr;
-
-   virtual int GetAllWorkingOrdersCount(const ID& gwAccountID)
+   /// @brief Applies subscribed bars change & reports it.
+   void updateBars(const BarsUpdate& update)
    {
-      CHECK_CEL_INIT(0);
-
-      ICQGOrdersPtr spOrders;
-
-      if(gwAccountID == ID())
+      if(!m_bars.Apply(update))
       {
-         HRESULT hr = m_api->m_spCQGCEL->get_Orders(&spOrders);
-         CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, 0);
+         // Canceled request or change which doesn't fit, e.g. request isn't resolved yet.
+         return;
       }
-      else
-      {
-         ICQGAccountPtr spAccount = getAccount(gwAccountID);
-         if(!spAccount) return 0;
 
-         HRESULT hr = spAccount->get_Orders(&spOrders);
-         CHECK_CEL_OBJ_RESULT(spAccount, hr, 0);
+      if(m_events)
+      {
+         m_events->OnBarsUpdated(update);
       }
-
-      return GetWorkingOrders(spOrders);
    }
 
-   virtual int GetInternalWorkingOrdersCount(const ID& gwAccountID)
+   /// @brief Reports bars request result.
+   void resolveBars(const Bars& bars)
    {
-      CHECK_CEL_INIT(0);
+      std::vector<Bars> derived;
+      if(m_derivedBars.OnBaseResolved(bars, derived))
+      {
+         for(size_t i = 0; i < derived.size(); ++i)
+         {
+            resolveBars(derived[i]);
+         }
+
+         return;
+      }
 
-      ICQGOrdersPtr spOrders;
+      if(resolveCachedBars(bars))
+      {
+         return;
+      }
 
-      if(gwAccountID == ID())
+      if(bars.error.IsEmpty())
       {
-         HRESULT hr = m_api->m_spCQGCEL->get_InternalOrders(&spOrders);
-         CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, 0);
+         m_bars.Resolve(bars);
       }
       else
       {
-         ICQGAccountPtr spAccount = getAccount(gwAccountID);
-         if(!spAccount) return 0;
-
-         HRESULT hr = spAccount->get_InternalOrders(&spOrders);
-         CHECK_CEL_OBJ_RESULT(spAccount, hr, 0);
+         m_bars.Remove(bars.requestGuid);
       }
 
-      return GetWorkingOrders(spOrders);
+      if(m_events)
+      {
+         m_events->OnBarsReceived(bars);
+      }
    }
 
-   virtual CString PlaceOrder(
-      OrderType type,
+   typedef std::chrono::steady_clock Clock;
+
+   /// @brief Adds order placed by facade to order registry.
+   void registerPlacedOrder(
+      const CString& orderGuid,
       const ID& gwAccountID,
       const CString& symbolFullName,
       bool buy,
       Quantity quantity,
-      const CString& description,
-      const OrderPrice& price,
-      const OrderPrice& stopLimitPrice)
+      const CString& description)
    {
-      CHECK_CEL_INIT((CString()));
+      OrderInfo order;
+      order.orderGuid = orderGuid;
+      order.symbol = symbolFullName;
+      order.gwAccountID = gwAccountID;
+      order.buy = buy;
+      order.final = false;
+      order.modifyPending = false;
+      order.fillSeq = 0;
+      order.quantity = quantity;
+      order.filledQty = 0;
+      order.description = description;
+      m_orders.OnPlaced(order);
+   }
 
-      ATL::CComPtr<ICQGAccounts> spAccounts;
-      HRESULT hr = m_api->m_spCQGCEL->get_Accounts(&spAccounts);
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, (CString()));
+   /// @brief Adds orders batch to latency counters.
+   /// @param seconds [in] batch time.
+   static void addOrderBatch(OrderBatchLatency& latency, size_t orders, size_t failed, double seconds)
+   {
+      const double us = seconds * 1e6;
+
+      ++latency.batches;
+      latency.orders += orders;
+      latency.failed += failed;
+      latency.lastBatchUs = us;
+      latency.avgBatchUs += (us - latency.avgBatchUs) / latency.batches;
+      latency.maxBatchUs = std::max(latency.maxBatchUs, us);
+      latency.avgOrderUs = latency.orders ? latency.avgBatchUs * latency.batches / latency.orders : 0.0;
+   }
 
-      ATL::CComPtr<ICQGAccount> spAccount;
-      hr = spAccounts->get_Item(gwAccountID, &spAccount);
-      CHECK_CEL_OBJ_RESULT(spAccounts, hr, (CString()));
+   /// @brief Bars request waiting for outstanding CQGCEL request containing it.
+   struct WaitingBarsRequest
+   {
+      BarsRequest request;           ///< User request.
+      CString requestGuid;           ///< Request guid returned to user.
+      Clock::time_point requested;   ///< Time of request.
+   };
 
-      ATL::CComPtr<ICQGInstruments> spInstruments;
-      hr = m_api->m_spCQGCEL->get_Instruments(&spInstruments);
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, (CString()));
+   typedef std::vector<WaitingBarsRequest> WaitingBarsRequests;
 
-      ATL::CComPtr<ICQGInstrument> spInstrument;
-      spInstruments->get_Item(ATL::CComVariant(symbolFullName.GetString()), &spInstrument);
-      CHECK_CEL_OBJ_RESULT(spInstruments, hr, (CString()));
+   /// @brief Bars request served via bar caches.
+   struct CachedBarsRequest
+   {
+      BarsRequest request;           ///< User request.
+      CString requestGuid;           ///< Request guid returned to user.
+      bool tail;                     ///< True if only bars since the last cached bar are requested.
+      DATE coveredFrom;              ///< Time since which CQGCEL request gets every bar.
+      WaitingBarsRequests waiting;   ///< Requests waiting for this one.
+   };
 
-      const eOrderType ordType = 
-         type == Limit ? otLimit :
-            type == Stop ? otStop :
-               type == StopLimit ? otStopLimit : otMarket;
+   typedef std::unordered_map<CString, CachedBarsRequest, CStringHash> CachedBarsRequests;
 
-      const OrderPrice& limitPrice = 
-         type == Limit ? price : 
-            type == StopLimit ? stopLimitPrice : OrderPrice();
+   /// @brief Order ticket prepared by user.
+   struct PreparedTicket
+   {
+      PreparedTicket(): prepared(false), generation(0), quantity(0)
+      {}
+
+      bool prepared;       ///< False if ticket is released.
+      unsigned generation; ///< Number of times slot was released, high bits of ticket identifier.
+      Quantity quantity;   ///< Default order quantity.
+      OrderInfo order;     ///< Placed order state.
+   };
+
+   /// @brief Requests bars via bar caches. Complete bars cached in memory are reported without CQGCEL,
+   ///        requests contained in outstanding CQGCEL request wait for it. If persistent cache covers
+   ///        requested range, only bars since the last cached bar are requested from CQGCEL,
+   ///        otherwise whole range is requested.
+   /// @return Request guid or empty string if failed.
+   CString requestCachedBars(const BarsRequest& barsRequest)
+   {
+      if(m_barIntervals.IsEnabled())
+      {
+         ++m_barsCacheStats.requests;
 
-      const OrderPrice& stopPrice =
-         type == Stop || type == StopLimit ? price : OrderPrice();
+         CString error;
+         const COleDateTime lineTime = m_backend->GetLineTime(error);
 
-      // Create order
-      ATL::CComPtr<ICQGOrder> spOrder;
-      hr = m_api->m_spCQGCEL->CreateOrder(ordType, spInstrument, spAccount,
-         quantity, buy ? osdBuy : osdSell, 
-         limitPrice.initialized() ? limitPrice.price() : 0.0,
-         stopPrice.initialized() ? stopPrice.price() : 0.0,
-         L"", &spOrder);
+         Bars bars;
+         if(IsValidDateTime(lineTime) && m_barIntervals.Load(barsRequest, lineTime.m_dt, bars.bars))
+         {
+            ++m_barsCacheStats.hits;
 
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, (CString()));
+            bars.requestGuid = m_barsScheduler.NewGuid();
+            bars.requestedCount = GetRequestedCount(barsRequest, bars.bars);
+            bars.cachedCount = static_cast<long>(bars.bars.size());
+            m_backend->Post(std::bind(&IAPIFacadeImpl::fireBarsReceived, this, bars));
+            return bars.requestGuid;
+         }
 
-      // Set order description
-      hr = spOrder->put_Description(ATL::CComBSTR(description));
-      CHECK_CEL_OBJ_RESULT(spOrder, hr, (CString()));
+         for(CachedBarsRequests::iterator it = m_barRequests.begin(); it != m_barRequests.end(); ++it)
+         {
+            if(CoversBarsRange(it->second.request, barsRequest))
+            {
+               ++m_barsCacheStats.coalesced;
+
+               WaitingBarsRequest waiting;
+               waiting.request = barsRequest;
+               waiting.requestGuid = m_barsScheduler.NewGuid();
+               waiting.requested = Clock::now();
+               it->second.waiting.push_back(waiting);
+               return waiting.requestGuid;
+            }
+         }
 
-      // Place order
-      hr = spOrder->Place();
-      CHECK_CEL_OBJ_RESULT(spOrder, hr, (CString()));
+         ++m_barsCacheStats.misses;
+      }
 
-      // Return order guid
-      ATL::CComBSTR orderGuid;
-      spOrder->get_GUID(&orderGuid);
-      return CString(orderGuid);
-   }
+      CachedBarsRequest cached;
+      cached.request = barsRequest;
+      cached.tail = false;
+      cached.coveredFrom = barsRequest.startDate.m_dt;
 
-   virtual bool CancelOrder(const CString& orderGuid)
-   {
-      CHECK_CEL_INIT(false);
+      BarsRequest backendRequest = barsRequest;
 
-      ATL::CComPtr<ICQGOrders> spOrders;
-      HRESULT hr = m_api->m_spCQGCEL->get_Orders(&spOrders);
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, false);
+      DATE coveredFrom = 0.0;
+      DATE lastBar = 0.0;
+      if(m_barCache.IsEnabled() && m_barCache.GetRange(barsRequest, coveredFrom, lastBar) &&
+         (barsRequest.useIndexRange || barsRequest.startDate.m_dt >= coveredFrom))
+      {
+         CString error;
+         const COleDateTime lineTime = m_backend->GetLineTime(error);
+         if(IsValidDateTime(lineTime))
+         {
+            // The last cached bar may be incomplete, so it's requested again.
+            backendRequest.useIndexRange = false;
+            backendRequest.startDate = COleDateTime(lastBar);
+            backendRequest.endDate = barsRequest.useIndexRange ?
+               lineTime : COleDateTime(std::max(barsRequest.endDate.m_dt, lastBar));
+
+            cached.tail = true;
+            cached.coveredFrom = lastBar;
+         }
+      }
 
-      ATL::CComBSTR bstrOrderGuid(orderGuid);
-      ATL::CComPtr<ICQGOrder> spOrder;
-      hr = spOrders->get_ItemByGuid(bstrOrderGuid, &spOrder);
-      if(hr == S_FALSE)
+      const CString requestGuid = m_barsScheduler.Request(*m_backend, backendRequest, m_lastError);
+      if(!requestGuid.IsEmpty())
       {
-         m_lastError = "Order with given guid not found.";
-         return false;
+         ++m_barsCacheStats.upstream;
+
+         cached.requestGuid = requestGuid;
+         m_barRequests[requestGuid] = cached;
       }
 
-      CHECK_CEL_OBJ_RESULT(spOrders, hr, false);
+      return requestGuid;
+   }
 
-      if(!spOrder)
+   /// @brief Merges received bars into bar caches and reports requested range,
+   ///        then reports parts of it to requests waiting for it.
+   /// @return False if bars are not requested via bar caches.
+   bool resolveCachedBars(const Bars& bars)
+   {
+      const CachedBarsRequests::iterator it = m_barRequests.find(bars.requestGuid);
+      if(it == m_barRequests.end())
       {
-         m_lastError = "CQGOrder object is NULL.";
          return false;
       }
 
-      VARIANT_BOOL canBeCanceled = VARIANT_FALSE;
-      spOrder->get_CanBeCanceled(&canBeCanceled);
-      if(canBeCanceled == VARIANT_FALSE)
+      const CachedBarsRequest cached = it->second;
+      m_barRequests.erase(it);
+
+      Bars result;
+      result.requestGuid = cached.requestGuid;
+      result.error = bars.error;
+      result.requestedCount = bars.requestedCount;
+      result.queueMs = bars.queueMs;
+      result.serviceMs = bars.serviceMs;
+
+      if(bars.error.IsEmpty())
       {
-         m_lastError = "Order cannot be cancelled.";
-         return false;
+         if(!m_barCache.IsEnabled())
+         {
+            result.bars = bars.bars;
+         }
+         else if(storeCachedBars(cached, bars.bars) && m_barCache.Load(cached.request, result.bars))
+         {
+            // Bars preceding the first received bar come from cache, timestamps of the same bar
+            // may differ by rounding. Cached range may hold no bars at all, e.g. weekend.
+            result.cachedCount = 0;
+            if(bars.bars.empty())
+            {
+               result.cachedCount = static_cast<long>(result.bars.size());
+            }
+            else
+            {
+               const DATE firstReceived = bars.bars.front().timestamp.m_dt - BarTimeEpsilon;
+               while(result.cachedCount < static_cast<long>(result.bars.size()) &&
+                  result.bars[result.cachedCount].timestamp.m_dt < firstReceived)
+               {
+                  ++result.cachedCount;
+               }
+            }
+
+            result.requestedCount = GetRequestedCount(cached.request, result.bars);
+         }
+         else if(cached.tail)
+         {
+            // Cache has fewer bars than requested, so whole range is requested.
+            CachedBarsRequest full = cached;
+            full.tail = false;
+            full.coveredFrom = cached.request.startDate.m_dt;
+
+            const CString requestGuid = m_barsScheduler.Request(*m_backend, cached.request, result.error);
+            if(!requestGuid.IsEmpty())
+            {
+               ++m_barsCacheStats.upstream;
+               m_barRequests[requestGuid] = full;
+               return true;
+            }
+         }
+         else
+         {
+            result.bars = bars.bars;
+         }
+
+         CString error;
+         const COleDateTime lineTime = m_backend->GetLineTime(error);
+         if(IsValidDateTime(lineTime))
+         {
+            m_barIntervals.Store(cached.request, lineTime.m_dt, result.bars);
+         }
       }
 
-      hr = spOrder->Cancel();
-      CHECK_CEL_OBJ_RESULT(spOrder, hr, false);
+      fireBarsReceived(result);
+
+      for(WaitingBarsRequests::const_iterator itWaiting = cached.waiting.begin();
+         itWaiting != cached.waiting.end(); ++itWaiting)
+      {
+         Bars waitingBars;
+         waitingBars.requestGuid = itWaiting->requestGuid;
+         waitingBars.error = result.error;
+         GetCoveredBars(cached.request, result.bars, itWaiting->request, waitingBars.bars);
+         waitingBars.requestedCount = GetRequestedCount(itWaiting->request, waitingBars.bars);
+         waitingBars.serviceMs = std::chrono::duration<double, std::milli>(Clock::now() - itWaiting->requested).count();
+         fireBarsReceived(waitingBars);
+      }
 
       return true;
    }
 
-   virtual bool CancelAllOrders(
-      const ID& gwAccountID,
-      const CString& symbolFullName)
+   /// @brief Merges received bars into persistent bar cache.
+   /// @return False if cache can't be updated, error is reported.
+   bool storeCachedBars(const CachedBarsRequest& cached, const BarInfos& bars)
    {
-      CHECK_CEL_INIT(false);
-
-      ATL::CComPtr<ICQGAccount> spAccount;
-      ATL::CComPtr<ICQGInstrument> spInstrument;
-      HRESULT hr = S_OK;
+      // Index range covers everything since the first received bar.
+      const DATE coveredFrom = cached.tail || !cached.request.useIndexRange || bars.empty() ?
+         cached.coveredFrom : bars.front().timestamp.m_dt;
 
-      if(gwAccountID)
+      CString error;
+      if(!m_barCache.Store(cached.request, coveredFrom, bars, error))
       {
-         ATL::CComPtr<ICQGAccounts> spAccounts;
-         hr = m_api->m_spCQGCEL->get_Accounts(&spAccounts);
-         CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, false);
+         if(m_events)
+         {
+            m_events->OnError(CString("Unable to update bar cache: ") + error);
+         }
 
-         hr = spAccounts->get_Item(gwAccountID, &spAccount);
-         CHECK_CEL_OBJ_RESULT(spAccounts, hr, false);
+         return false;
       }
 
-      if(!symbolFullName.IsEmpty())
-      {
-         ATL::CComPtr<ICQGInstruments> spInstruments;
-         hr = m_api->m_spCQGCEL->get_Instruments(&spInstruments);
-         CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, false);
+      return true;
+   }
 
-         spInstruments->get_Item(ATL::CComVariant(symbolFullName.GetString()), &spInstrument);
-         CHECK_CEL_OBJ_RESULT(spInstruments, hr, false);
+   /// @brief Gets requested number of bars as CQGCEL reports it.
+   static long GetRequestedCount(const BarsRequest& barsRequest, const BarInfos& bars)
+   {
+      return barsRequest.useIndexRange ?
+         std::abs(barsRequest.startIndex - barsRequest.endIndex) + 1 : static_cast<long>(bars.size());
+   }
+
+   /// @brief Gets prepared ticket by identifier.
+   /// @return NULL if ticket is unknown or released.
+   PreparedTicket* findTicket(const OrderTicketId ticketId)
+   {
+      const OrderTicketId slot = ticketId & TicketSlotMask;
+      if(slot == 0 || slot > m_tickets.size())
+      {
+         return NULL;
       }
 
-      hr = m_api->m_spCQGCEL->CancelAllOrders(spAccount, spInstrument, VARIANT_FALSE, VARIANT_FALSE, osdUndefined);
-      CHECK_CEL_OBJ_RESULT(m_api->m_spCQGCEL, hr, false);
+      PreparedTicket& ticket = m_tickets[slot - 1];
+      return ticket.prepared && ticket.generation == ticketId >> TicketSlotBits ? &ticket : NULL;
+   }
 
-      return true;
+   /// @brief Reports bars request result.
+   void fireBarsReceived(const Bars& bars)
+   {
+      if(m_events)
+      {
+         m_events->OnBarsReceived(bars);
+      }
    }
 
-   std::auto_ptr<CQGCELWrapper> m_api;
-   CString m_lastError;
+   /// @brief Notifies about completed symbols batches.
+   void fireBatchesCompleted(const SymbolsBatches& completed)
+   {
+      for(size_t i = 0; m_events && i < completed.size(); ++i)
+      {
+         m_events->OnSymbolsBatchCompleted(completed[i]);
+      }
+   }
+
+   IBackendPtr m_backend;              ///< CQGCEL backend.
+   IAPIEvents* m_events;               ///< Events listener, user's one or dispatcher.
+   IAPIEvents* m_userEvents;           ///< User API events listener.
+   EventDispatcherPtr m_dispatcher;    ///< Events dispatcher if dispatch threads are used.
+   FacadeSettings m_settings;          ///< Facade behavior settings.
+   bool m_started;                     ///< True if backend successfully started.
+   CString m_lastError;                ///< Last error description.
+   SymbolTable m_symbols;              ///< Subscribed symbols.
+   SymbolBatches m_batches;            ///< Symbols batches being resolved.
+   Subscriptions m_subscriptions;      ///< Symbol subscriptions reference counts.
+   QuoteCache m_quotes;                ///< Last known quotes of subscribed symbols.
+   QuoteConflator m_conflator;         ///< Pending quote updates if conflation is on.
+   OrderBooks m_books;                 ///< Order books if market depth is on.
+   OrderRegistry m_orders;             ///< Orders placed or reported, by guid.
+   PositionBook m_positions;           ///< Account positions kept from fills & quotes.
+   std::vector<PreparedTicket> m_tickets; ///< Order tickets, ticket slot is index + 1.
+   std::vector<OrderTicketId> m_freeTickets;   ///< Slots of released tickets.
+   OrderBatchStats m_orderBatchStats;  ///< Orders batches counters.
+   BarSeries m_bars;                   ///< Bars of subscribed bars requests.
+   BarCache m_barCache;                ///< Timed bars history if bar cache is on.
+   CachedBarsRequests m_barRequests;   ///< Pending bars requests served via bar caches, by CQGCEL request guid.
+   BarIntervals m_barIntervals;        ///< Timed bars kept in memory if memory cache is on.
+   BarsCacheStats m_barsCacheStats;    ///< Bar caches counters.
+   BarsScheduler m_barsScheduler;      ///< Timed bars requests sent to CQGCEL & queued.
+   DerivedBars m_derivedBars;          ///< Subscribed bars derived from base period bars.
+   TradeBars m_tradeBars;              ///< Bars built from trades.
+   ClosedTradeBars m_closedTradeBars;  ///< Trade bars closed by quote update, kept to reuse memory.
+   std::vector<QuoteEvent> m_drained;  ///< Quote updates being drained, kept to reuse memory.
 
 }; // class IAPIFacadeImpl
 
 IAPIFacadePtr IAPIFacade::Create()
 {
-   return IAPIFacadePtr(new IAPIFacadeImpl());
+#ifdef CQGAPIFACADE_USE_MFC
+   return IAPIFacadePtr(new IAPIFacadeImpl(CreateCQGCELBackend()));
+#else
+   return IAPIFacadePtr(new IAPIFacadeImpl(IBackendPtr()));
+#endif
+}
+
+IAPIFacadePtr IAPIFacade::CreateSimulated(const SimulationSettings& settings)
+{
+   return IAPIFacadePtr(new IAPIFacadeImpl(CreateSimulatedBackend(settings)));
 }
 
 FacadeVersion IAPIFacade::GetVersion()
@@ -0,0 +1,1857 @@
+/// @file CQGCELBackend.cpp
+/// @brief Simple C++ facade for CQG API - CQGCEL COM backend implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Feb-2015
+
+#include "stdafx.h"
+
+#include "Backend.h"
+#include "SymbolTable.h"
+
+#ifdef CQGAPIFACADE_USE_MFC
+
+#include <map>
+#include <memory>
+#include <string>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <afx.h>
+#include <atlbase.h>
+#include <atlcom.h>
+#include <atlwin.h>
+
+#pragma message ("Please make sure that the path of CQGCEL-4_0.dll on your system corresponds to the one given in CQGCELBackend.cpp file.")
+#import "D:\CQGIC\CQGNet\Bin\CQGCEL-4_0.dll" raw_interfaces_only, raw_native_types, no_namespace, named_guids, auto_search
+
+namespace cqg
+{
+
+/// @class CCOMInitializer
+/// @brief COM subsystem initialization & finalization wrapper
+static struct CCOMInitializer
+{
+   CCOMInitializer()
+   {
+      // Initialize COM
+      ::CoInitialize(NULL);
+   }
+
+   ~CCOMInitializer()
+   {
+      // Finalize COM
+      ::CoUninitialize();
+   }
+} sc_initCOM;
+
+/// @brief Returns latest COM error description
+/// @param spClass [in] - Pointer to COM object which raised error
+/// @param descr [out] - Error description
+/// @return Result code
+template <class IFaceT>
+STDMETHODIMP GetCOMErrorString(
+   const ATL::CComPtr<IFaceT>& spIFace,
+   CString& error)
+{
+   error.Empty();
+
+   ATL::CComPtr<ISupportErrorInfo> spSupportErrorInfo;
+   HRESULT hr = spIFace->QueryInterface(__uuidof(ISupportErrorInfo), (void**)&spSupportErrorInfo);
+
+   if(SUCCEEDED(hr))
+   {
+      hr = spSupportErrorInfo->InterfaceSupportsErrorInfo(__uuidof(IFaceT));
+      if(SUCCEEDED(hr))
+      {
+         ATL::CComPtr<IErrorInfo> spErrorInfo;
+         hr = GetErrorInfo(0, &spErrorInfo);
+
+         if(SUCCEEDED(hr))
+         {
+            ATL::CComBSTR errDesc;
+            hr = spErrorInfo->GetDescription(&errDesc);
+            error = errDesc;
+         }
+      }
+   }
+
+   return hr;
+}
+
+/// @brief Gets COM error description depending on passed result code
+/// @param spIFace [in] pointer to object which is the source of the result code
+/// @param hr [in] result code
+/// @return COM error string
+template <class IFaceT>
+CString GetCOMError(const ATL::CComPtr<IFaceT>& spIFace, HRESULT hr)
+{
+   if(SUCCEEDED(hr))
+   {
+      return CString();
+   }
+
+   CString errMessage;
+   HRESULT hres = GetCOMErrorString(spIFace, errMessage);
+
+   if(SUCCEEDED(hres))
+   {
+      errMessage.Insert(0, "COM error occurred. Description: ");
+   }
+   else
+   {
+      char* errDesc = NULL;
+
+      ::FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM,
+         NULL,
+         hr,
+         MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+         (LPTSTR)&errDesc,
+         0,
+         NULL);
+
+      errMessage = errDesc;
+      ::LocalFree(errDesc);
+   }
+
+   return errMessage;
+}
+
+/// @brief Throws runtime exception depending on passed result code
+/// @param spIFace - Pointer to object which is the source of the result code
+/// @param hr - Result code
+template <class IFaceT>
+void CheckCOMError(const ATL::CComPtr<IFaceT>& spIFace, HRESULT hr)
+{
+   if(SUCCEEDED(hr))
+   {
+      return;
+   }
+
+   throw std::runtime_error(std::string(GetCOMError(spIFace, hr).GetString()));
+}
+
+template <class ICollectionT, typename ItemT>
+class CComCollection
+{
+public:
+
+   CComCollection(ICollectionT* collection): m_isEnd(true)
+   {
+      if(collection)
+      {
+         HRESULT hr = collection->get__NewEnum(&m_collection);
+         CheckCOMError<ICollectionT>(collection, hr);
+
+         Reset();
+      }
+   }
+
+   bool IsEnd() const
+   {
+      return m_isEnd;
+   }
+
+   void Reset()
+   {
+      if(m_collection)
+      {
+         HRESULT hr = m_collection->Reset();
+         CheckCOMError(m_collection, hr);
+         m_isEnd = false;
+      }
+   }
+
+   ATL::CComVariant GetNext()
+   {
+      m_isEnd = true;
+
+      ATL::CComVariant result;
+      if(m_collection)
+      {
+         HRESULT hr = m_collection->Next(1, &result, NULL);
+         CheckCOMError(m_collection, hr);
+         m_isEnd = (hr == S_FALSE);
+      }
+
+      return result;
+   }
+
+   /// @brief Gets up to count next items by single enumerator call.
+   /// @return Number of fetched items.
+   ULONG GetNext(ATL::CComVariant* items, ULONG count)
+   {
+      m_isEnd = true;
+
+      ULONG fetched = 0;
+      if(m_collection)
+      {
+         HRESULT hr = m_collection->Next(count, items, &fetched);
+         CheckCOMError(m_collection, hr);
+         m_isEnd = (hr == S_FALSE);
+      }
+
+      return fetched;
+   }
+
+private:
+   bool m_isEnd;
+   ATL::CComPtr<IEnumVARIANT> m_collection;
+};
+
+bool GetQuote(ICQGQuote* quote, QuoteInfo& quoteInfo)
+{
+   if(!quote)
+   {
+      ATLASSERT(0);
+      return false;
+   }
+
+   VARIANT_BOOL valid = VARIANT_FALSE;
+   quote->get_IsValid(&valid);
+
+   if(valid == VARIANT_FALSE)
+   {
+      return false;
+   }
+
+   eQuoteType type;
+   quote->get_Type(&type);
+
+   quoteInfo.type = QuoteInfo::Unknown;
+   if(type == qtAsk) quoteInfo.type = QuoteInfo::Ask;
+   else if(type == qtBid) quoteInfo.type = QuoteInfo::Bid;
+   else if(type == qtTrade) quoteInfo.type = QuoteInfo::Trade;
+   else if(type == qtYesterdaySettlement) quoteInfo.type = QuoteInfo::Close;
+   else if(type == qtDayHigh) quoteInfo.type = QuoteInfo::High;
+   else if(type == qtDayLow) quoteInfo.type = QuoteInfo::Low;
+   else
+   {
+      return false;
+   }
+
+   quote->get_Price(&quoteInfo.price);
+   quote->get_Volume(&quoteInfo.volume);
+   quote->get_Timestamp(&quoteInfo.timestamp);
+
+   return true;
+}
+
+void GetAllQuotes(ICQGQuotes* quotes, QuoteEvent& quoteEvent)
+{
+   quoteEvent.count = 0;
+   quoteEvent.changedMask = 0;
+
+   if(!quotes)
+   {
+      return;
+   }
+
+   // Whole collection is usually fetched by single enumerator call.
+   enum { BatchSize = 8 };
+
+   CComCollection<ICQGQuotes, ICQGQuote> q(quotes);
+   while(!q.IsEnd() && quoteEvent.count < QuoteEvent::MaxQuotes)
+   {
+      ATL::CComVariant items[BatchSize];
+      const ULONG fetched = q.GetNext(items, BatchSize);
+
+      for(ULONG i = 0; i < fetched && quoteEvent.count < QuoteEvent::MaxQuotes; ++i)
+      {
+         ATL::CComQIPtr<ICQGQuote> spQuote = items[i].pdispVal;
+
+         QuoteInfo& quote = quoteEvent.quotes[quoteEvent.count];
+         if(GetQuote(spQuote, quote))
+         {
+            quoteEvent.changedMask |= QuoteEvent::TypeMask(quote.type);
+            ++quoteEvent.count;
+         }
+      }
+   }
+}
+
+/// @brief Gets DOM levels, best level first.
+/// @return Number of levels got.
+unsigned GetDOMLevels(ICQGDOMQuotes* domQuotes, DepthLevel* levels)
+{
+   unsigned count = 0;
+
+   if(!domQuotes)
+   {
+      return count;
+   }
+
+   enum { BatchSize = MarketDepth::MaxLevels };
+
+   CComCollection<ICQGDOMQuotes, ICQGQuote> q(domQuotes);
+   while(!q.IsEnd() && count < MarketDepth::MaxLevels)
+   {
+      ATL::CComVariant items[BatchSize];
+      const ULONG fetched = q.GetNext(items, BatchSize);
+
+      for(ULONG i = 0; i < fetched && count < MarketDepth::MaxLevels; ++i)
+      {
+         ATL::CComQIPtr<ICQGQuote> spQuote = items[i].pdispVal;
+         if(!spQuote)
+         {
+            continue;
+         }
+
+         VARIANT_BOOL valid = VARIANT_FALSE;
+         spQuote->get_IsValid(&valid);
+         if(valid == VARIANT_FALSE)
+         {
+            continue;
+         }
+
+         spQuote->get_Price(&levels[count].price);
+         spQuote->get_Volume(&levels[count].volume);
+         ++count;
+      }
+   }
+
+   return count;
+}
+
+void GetAccountInfo(ICQGAccount* acc, ICQGAccountSummary* accSum, AccountInfo& account)
+{
+   if(!acc)
+   {
+      ATLASSERT(0);
+      return;
+   }
+
+   acc->get_FcmID(&account.fcmID);
+
+   ATL::CComBSTR strFcmAccountID;
+   acc->get_FcmAccountID(&strFcmAccountID);
+   account.fcmAccountID = strFcmAccountID;
+
+   acc->get_GWAccountID(&account.gwAccountID);
+
+   ATL::CComBSTR strGWAccountName;
+   acc->get_GWAccountName(&strGWAccountName);
+   account.gwAccountName = strGWAccountName;
+
+   ATL::CComBSTR strCurrency;
+   acc->get_ReportingCurrency(&strCurrency);
+   account.currency = strCurrency;
+
+   account.balance = 0.0;
+   account.ote = 0.0;
+   account.profitLoss = 0.0;
+
+   accSum->Balance(0, &account.balance);
+   accSum->OTE(0, &account.ote);
+   accSum->ProfitLoss(0, &account.profitLoss);
+}
+
+void GetPositionInfo(ICQGPosition* pos, PositionInfo& position)
+{
+   if(!pos)
+   {
+      ATLASSERT(0);
+      return;
+   }
+
+   ATL::CComBSTR strSymbol;
+   pos->get_InstrumentName(&strSymbol);
+   position.symbol = strSymbol;
+
+   eOrderSide side = osdUndefined;
+   pos->get_Side(&side);
+   position.longPosition = side == osdBuy;
+
+   long qty = 0;
+   pos->get_Quantity(&qty);
+   position.quantity = qty;
+
+   position.averagePrice = InvalidPrice;
+   position.ote = 0.0;
+   position.profitLoss = 0.0;
+
+   pos->get_AveragePrice(&position.averagePrice);
+   pos->get_OTE(&position.ote);
+   pos->get_ProfitLoss(&position.profitLoss);
+}
+
+/// @class PostedCallsWindow
+/// @brief Message-only window running posted calls from thread message loop, in order with CQGCEL events.
+class PostedCallsWindow : public ATL::CWindowImpl<PostedCallsWindow, ATL::CWindow, ATL::CWinTraits<0, 0> >
+{
+public:
+
+   enum { WM_POSTED_CALLS = WM_APP + 1 };
+
+   BEGIN_MSG_MAP(PostedCallsWindow)
+      MESSAGE_HANDLER(WM_POSTED_CALLS, OnPostedCalls)
+   END_MSG_MAP()
+
+   /// @brief Queues call, the first queued call wakes up message loop.
+   void Post(const std::function<void()>& call)
+   {
+      if(!IsWindow())
+      {
+         return;
+      }
+
+      m_calls.push_back(call);
+      if(m_calls.size() == 1)
+      {
+         PostMessage(WM_POSTED_CALLS);
+      }
+   }
+
+   /// @brief Drops queued calls.
+   void Clear()
+   {
+      m_calls.clear();
+   }
+
+private:
+
+   LRESULT OnPostedCalls(UINT /*msg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& /*handled*/)
+   {
+      // Calls may post new calls, they go to the next message.
+      std::vector<std::function<void()> > calls;
+      calls.swap(m_calls);
+
+      for(size_t i = 0; i < calls.size(); ++i)
+      {
+         calls[i]();
+      }
+
+      return 0;
+   }
+
+   std::vector<std::function<void()> > m_calls;   ///< Calls waiting for message.
+};
+
+class CQGCELBackend;
+
+typedef ATL::IDispEventImpl<1, CQGCELBackend,
+   &__uuidof(_ICQGCELEvents), &__uuidof(__CQG), 4, 0> ICQGCELDispEventImpl;
+
+#define CHECK_CEL_OBJ_RESULT(obj, hr, res) \
+if(hr != S_OK)                             \
+{                                          \
+   error = GetCOMError(obj, hr);           \
+   return res;                             \
+}
+
+/// @class CQGCELBackend
+/// @brief Backend working on top of CQGCEL COM object.
+class CQGCELBackend : public IBackend, public ICQGCELDispEventImpl
+{
+public:
+
+   CQGCELBackend(): m_events(NULL), m_marketDepth(false), m_accountsGeneration(0)
+   {}
+
+   /// @brief Finalizes CQGCEL.
+   ~CQGCELBackend()
+   {
+      finalizeCQGCEL();
+   }
+
+   /// @brief This map is used to declare handler function for specified event.
+   ///        You can use "OLE/COM Object Viewer" to open CQGCEL-4_0.dll and get event ids.
+   ///        The handler signature as well as the event ids can be found in the type library
+   ///        or shown by "OLE/COM Object Viewer".
+   BEGIN_SINK_MAP(CQGCELBackend)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 10, OnDataError)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 2,  OnGWConnectionStatusChanged)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 3,  OnDataConnectionStatusChanged)
+
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 7,  OnAccountChanged)
+
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 4,  OnInstrumentSubscribed)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 5,  OnInstrumentChanged)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 6,  OnInstrumentDOMChanged)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 12, OnIncorrectSymbol)
+
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 17, OnOrderChanged)
+
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 24, OnTimedBarsResolved)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 25, OnTimedBarsAdded)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 26, OnTimedBarsUpdated)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 57, OnTimedBarsInserted)
+      SINK_ENTRY_EX(1, __uuidof(_ICQGCELEvents), 58, OnTimedBarsRemoved)
+   END_SINK_MAP()
+
+   /// @name IBackend implementation.
+   /// @{
+
+   virtual void Startup(IBackendEvents* events, const FacadeSettings& settings)
+   {
+      m_events = events;
+      m_marketDepth = settings.marketDepth;
+      initializeCQGCEL();
+   }
+
+   virtual void Shutdown() throw()
+   {
+      finalizeCQGCEL();
+   }
+
+   virtual unsigned PumpEvents(unsigned /*maxEvents*/)
+   {
+      // CQGCEL events are delivered by thread message loop.
+      return 0;
+   }
+
+   virtual void Post(const std::function<void()>& call)
+   {
+      m_postedCalls.Post(call);
+   }
+
+   virtual bool NewInstrument(const CString& symbol, CString& error)
+   {
+      error = GetCOMError(m_spCQGCEL, m_spCQGCEL->NewInstrument(ATL::CComBSTR(symbol)));
+      return error.IsEmpty();
+   }
+
+   virtual bool RemoveInstrument(const SymbolId id, CString& error)
+   {
+      ATL::CComPtr<ICQGInstrument> spInstrument = getInstrument(id, error);
+      if(!spInstrument)
+      {
+         return false;
+      }
+
+      HRESULT hr = m_spCQGCEL->RemoveInstrument(spInstrument);
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, false);
+
+      // Identity stays registered, so late events of removed instrument are still recognized.
+      m_instruments[id].m_T.Release();
+      return true;
+   }
+
+   virtual bool SetSubscriptionLevel(const SymbolId id, const SubscriptionLevel level, CString& error)
+   {
+      ATL::CComPtr<ICQGInstrument> spInstrument = getInstrument(id, error);
+      if(!spInstrument)
+      {
+         return false;
+      }
+
+      const eDataSubscriptionLevel celLevel =
+         level == NoQuotesLevel ? dsNone :
+            level == TradesLevel ? dsQuotes :
+               level == TradesAndDOMLevel ? dsQuotesAndDOM : dsQuotesAndBBA;
+
+      HRESULT hr = spInstrument->put_DataSubscriptionLevel(celLevel);
+      CHECK_CEL_OBJ_RESULT(spInstrument, hr, false);
+
+      return true;
+   }
+
+   virtual CString RequestTimedBars(const BarsRequest& barsRequest, CString& error)
+   {
+      ATL::CComPtr<ICQGTimedBarsRequest> spRequest;
+      HRESULT hr = m_spCQGCEL->CreateTimedBarsRequest(&spRequest);
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, CString());
+
+      ATL::CComBSTR symbol(barsRequest.symbol);
+      hr = spRequest->put_Symbol(symbol);
+      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
+
+      const ATL::CComVariant startRange = barsRequest.useIndexRange ?
+         ATL::CComVariant(barsRequest.startIndex) : ATL::CComVariant(barsRequest.startDate.m_dt, VT_DATE);
+
+      const ATL::CComVariant endRange = barsRequest.useIndexRange ?
+         ATL::CComVariant(barsRequest.endIndex) : ATL::CComVariant(barsRequest.endDate.m_dt, VT_DATE);
+
+      hr = spRequest->put_RangeStart(startRange);
+      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
+
+      hr = spRequest->put_RangeEnd(endRange);
+      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
+
+      hr = spRequest->put_IntradayPeriod(barsRequest.intradayPeriodInMinutes);
+      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
+
+      hr = spRequest->put_SessionsFilter(ATL::CComVariant(barsRequest.sessionsFilter));
+      CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
+
+      if(barsRequest.subscribe)
+      {
+         hr = spRequest->put_UpdatesEnabled(VARIANT_TRUE);
+         CHECK_CEL_OBJ_RESULT(spRequest, hr, CString());
+      }
+
+      ATL::CComPtr<ICQGTimedBars> spTimedBars;
+      hr = m_spCQGCEL->RequestTimedBars(spRequest, &spTimedBars);
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, CString());
+
+      ATL::CComBSTR requestID;
+      spTimedBars->get_Id(&requestID);
+
+      const CString requestGuid(requestID);
+      if(barsRequest.subscribe)
+      {
+         m_subscribedBars[requestGuid] = spTimedBars;
+      }
+
+      return requestGuid;
+   }
+
+   virtual bool RemoveTimedBars(const CString& requestGuid, CString& error)
+   {
+      const SubscribedBars::iterator it = m_subscribedBars.find(requestGuid);
+      if(it == m_subscribedBars.end())
+      {
+         error = "Bars request is not subscribed";
+         return false;
+      }
+
+      const ATL::CComPtr<ICQGTimedBars> spTimedBars = it->second.m_T;
+      m_subscribedBars.erase(it);
+
+      HRESULT hr = m_spCQGCEL->RemoveTimedBars(spTimedBars);
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, false);
+
+      return true;
+   }
+
+   virtual bool GWLogon(const CString& user, const CString& password, CString& error)
+   {
+      error = GetCOMError(m_spCQGCEL, m_spCQGCEL->GWLogon(ATL::CComBSTR(user), ATL::CComBSTR(password)));
+      return error.IsEmpty();
+   }
+
+   virtual COleDateTime GetLineTime(CString& error)
+   {
+      COleDateTime invalidTime;
+      invalidTime.SetStatus(COleDateTime::invalid);
+
+      ATL::CComPtr<ICQGEnvironment> spEnvironment;
+      HRESULT hr = m_spCQGCEL->get_Environment(&spEnvironment);
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, invalidTime);
+
+      DATE lineTime;
+      hr = spEnvironment->get_LineTime(&lineTime);
+      CHECK_CEL_OBJ_RESULT(spEnvironment, hr, invalidTime);
+
+      if(lineTime == 0.0) return invalidTime;
+
+      return COleDateTime(lineTime);
+   }
+
+   virtual bool GetAccounts(Accounts& accounts, CString& error)
+   {
+      ATL::CComPtr<ICQGAccounts> spAccounts;
+      HRESULT hr = m_spCQGCEL->get_Accounts(&spAccounts);
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, false);
+
+      long count = 0;
+      hr = spAccounts->get_Count(&count);
+      CHECK_CEL_OBJ_RESULT(spAccounts, hr, false);
+
+      accounts.reserve(count);
+
+      for(long i = 0; i < count; ++i)
+      {
+         ATL::CComPtr<ICQGAccount> spAcc;
+         hr = spAccounts->get_ItemByIndex(i, &spAcc);
+         CHECK_CEL_OBJ_RESULT(spAccounts, hr, false);
+
+         ATL::CComPtr<ICQGAccountSummary> spAccSum;
+         if(spAcc)
+         {
+            hr = spAcc->get_Summary(&spAccSum);
+            CHECK_CEL_OBJ_RESULT(spAcc, hr, false);
+         }
+
+         AccountInfo account;
+         GetAccountInfo(spAcc, spAccSum, account);
+         accounts.push_back(account);
+      }
+
+      return true;
+   }
+
+   virtual bool GetPositions(const ID& gwAccountID, Positions& positions, CString& error)
+   {
+      ICQGAccountPtr spAccount = getAccount(gwAccountID, error);
+      if(!spAccount) return false;
+
+      ATL::CComPtr<ICQGPositions> spPositions;
+      HRESULT hr = spAccount->get_Positions(&spPositions);
+      CHECK_CEL_OBJ_RESULT(spAccount, hr, false);
+
+      long count = 0;
+      hr = spPositions->get_Count(&count);
+      CHECK_CEL_OBJ_RESULT(spPositions, hr, false);
+
+      positions.reserve(count);
+
+      for(long i = 0; i < count; ++i)
+      {
+         ATL::CComPtr<ICQGPosition> spPos;
+         hr = spPositions->get_ItemByIndex(i, &spPos);
+         CHECK_CEL_OBJ_RESULT(spPositions, hr, false);
+
+         PositionInfo position;
+         GetPositionInfo(spPos, position);
+         positions.push_back(position);
+      }
+
+      return true;
+   }
+
+   virtual CString PlaceOrder(
+      OrderType type,
+      const ID& gwAccountID,
+      const CString& symbolFullName,
+      bool buy,
+      Quantity quantity,
+      const CString& description,
+      const OrderPrice& price,
+      const OrderPrice& stopLimitPrice,
+      CString& error)
+   {
+      PreparedOrder order;
+      if(!prepareOrder(type, gwAccountID, symbolFullName, buy, description, order, error))
+      {
+         return CString();
+      }
+
+      return placeOrder(order, price, quantity, stopLimitPrice, error);
+   }
+
+   virtual bool PrepareOrderTicket(OrderTicketId ticketId, const OrderTicket& ticket, CString& error)
+   {
+      PreparedOrder order;
+      if(!prepareOrder(ticket.type, ticket.gwAccountID, ticket.symbolFullName, ticket.buy, ticket.description,
+         order, error))
+      {
+         return false;
+      }
+
+      if(ticketId >= m_tickets.size())
+      {
+         m_tickets.resize(ticketId + 1);
+      }
+
+      m_tickets[ticketId] = order;
+      return true;
+   }
+
+   virtual CString SubmitOrderTicket(
+      OrderTicketId ticketId,
+      const OrderPrice& price,
+      Quantity quantity,
+      const OrderPrice& stopLimitPrice,
+      CString& error)
+   {
+      if(ticketId >= m_tickets.size() || !m_tickets[ticketId].instrument)
+      {
+         error = "Order ticket not found.";
+         return CString();
+      }
+
+      return placeOrder(m_tickets[ticketId], price, quantity, stopLimitPrice, error);
+   }
+
+   virtual void ReleaseOrderTicket(OrderTicketId ticketId)
+   {
+      if(ticketId < m_tickets.size())
+      {
+         m_tickets[ticketId] = PreparedOrder();
+      }
+   }
+
+   virtual void PlaceOrders(const OrderRequests& orders, OrderResults& results)
+   {
+      results.resize(orders.size());
+
+      PreparedOrder prepared;
+      const OrderRequest* last = NULL;
+
+      for(size_t i = 0; i < orders.size(); ++i)
+      {
+         const OrderRequest& order = orders[i];
+         OrderResult& result = results[i];
+
+         // Orders of the same account, symbol & description reuse resolved objects and description string.
+         if(last == NULL || order.gwAccountID != last->gwAccountID ||
+            order.symbolFullName != last->symbolFullName || order.description != last->description)
+         {
+            last = NULL;
+            if(!prepareOrder(order.type, order.gwAccountID, order.symbolFullName, order.buy, order.description,
+               prepared, result.error))
+            {
+               continue;
+            }
+
+            last = &order;
+         }
+
+         prepared.type = order.type;
+         prepared.cqgType = getOrderType(order.type);
+         prepared.side = order.buy ? osdBuy : osdSell;
+         result.orderGuid = placeOrder(prepared, order.price, order.quantity, order.stopLimitPrice, result.error);
+      }
+   }
+
+   virtual bool CancelOrder(const CString& orderGuid, CString& error)
+   {
+      const WorkingOrders::const_iterator it = m_workingOrders.find(orderGuid);
+      if(it == m_workingOrders.end())
+      {
+         error = "Order with given guid not found.";
+         return false;
+      }
+
+      const ATL::CComPtr<ICQGOrder>& spOrder = it->second.order;
+
+      VARIANT_BOOL canBeCanceled = VARIANT_FALSE;
+      spOrder->get_CanBeCanceled(&canBeCanceled);
+      if(canBeCanceled == VARIANT_FALSE)
+      {
+         error = "Order cannot be cancelled.";
+         return false;
+      }
+
+      const HRESULT hr = spOrder->Cancel();
+      CHECK_CEL_OBJ_RESULT(spOrder, hr, false);
+
+      return true;
+   }
+
+   virtual bool ModifyOrder(
+      const CString& orderGuid,
+      const OrderPrice& price,
+      const OrderPrice& stopLimitPrice,
+      Quantity quantity,
+      CString& error)
+   {
+      const WorkingOrders::const_iterator it = m_workingOrders.find(orderGuid);
+      if(it == m_workingOrders.end())
+      {
+         error = "Order with given guid not found.";
+         return false;
+      }
+
+      const ATL::CComPtr<ICQGOrder>& spOrder = it->second.order;
+
+      VARIANT_BOOL canBeModified = VARIANT_FALSE;
+      spOrder->get_CanBeModified(&canBeModified);
+      if(canBeModified == VARIANT_FALSE)
+      {
+         error = "Order cannot be modified.";
+         return false;
+      }
+
+      eOrderType type = otMarket;
+      spOrder->get_Type(&type);
+
+      if((type == otMarket && price.initialized()) || (type != otStopLimit && stopLimitPrice.initialized()))
+      {
+         error = "Invalid order parameters.";
+         return false;
+      }
+
+      ATL::CComPtr<ICQGOrderModify> spModify;
+      HRESULT hr = spOrder->PrepareModify(&spModify);
+      CHECK_CEL_OBJ_RESULT(spOrder, hr, false);
+
+      // Only changed properties are sent, the rest are kept by gateway.
+      if(price.initialized() &&
+         !setModifyProperty(spModify, type == otLimit ? opLimitPrice : opStopPrice, price.price(), error))
+      {
+         return false;
+      }
+
+      if(stopLimitPrice.initialized() && !setModifyProperty(spModify, opLimitPrice, stopLimitPrice.price(), error))
+      {
+         return false;
+      }
+
+      if(quantity && !setModifyProperty(spModify, opQuantity, static_cast<long>(quantity), error))
+      {
+         return false;
+      }
+
+      hr = spOrder->Modify(spModify);
+      CHECK_CEL_OBJ_RESULT(spOrder, hr, false);
+
+      return true;
+   }
+
+   virtual void CancelOrders(const OrderGuids& orderGuids, OrderResults& results)
+   {
+      for(size_t i = 0; i < orderGuids.size(); ++i)
+      {
+         if(results[i].error.IsEmpty())
+         {
+            CancelOrder(orderGuids[i], results[i].error);
+         }
+      }
+   }
+
+   virtual bool CancelAllOrders(const ID& gwAccountID, const CString& symbolFullName, CString& error)
+   {
+      ICQGAccountPtr spAccount;
+      ATL::CComPtr<ICQGInstrument> spInstrument;
+
+      if(gwAccountID)
+      {
+         spAccount = getAccount(gwAccountID, error);
+         if(!spAccount) return false;
+      }
+
+      if(!symbolFullName.IsEmpty())
+      {
+         spInstrument = getInstrument(symbolFullName, error);
+         if(!spInstrument) return false;
+      }
+
+      const HRESULT hr = m_spCQGCEL->CancelAllOrders(spAccount, spInstrument, VARIANT_FALSE, VARIANT_FALSE, osdUndefined);
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, false);
+
+      return true;
+   }
+
+   /// @}
+
+private:
+
+   /// @brief Handle event of some abnormal discrepancy
+   ///        between data expected and data received from CQG.
+   ///        This event also can be fired when CQGCEL startup fails.
+   /// @param obj [in] Object where the error occurred
+   /// @param errorDescription [in] String describing the error
+   /// @return S_OK
+   STDMETHOD(OnDataError)(
+      LPDISPATCH /*obj*/,
+      BSTR errorDescription)
+   {
+      ATLTRACE("CQGCEL::OnDataError\n");
+
+      if(m_events)
+      {
+         m_events->OnDataError(CString(errorDescription));
+      }
+
+      return S_OK;
+   }
+
+   /// @brief Fired when some changes occurred
+   ///        in the connection with the CQG Gateway.
+   /// @param newStatus [in] New connection status
+   /// @return S_OK
+   STDMETHOD(OnGWConnectionStatusChanged)(
+      eConnectionStatus newStatus)
+   {
+      ATLTRACE("CQGCEL::OnGWConnectionStatusChanged\n");
+
+      const bool connected = (newStatus == csConnectionUp);
+      if(connected)
+      {
+         // Subscribe to accounts, positions & order events
+         HRESULT hr = m_spCQGCEL->put_AccountSubscriptionLevel(aslAccountUpdatesAndOrders);
+         CheckCOMError(m_spCQGCEL, hr);
+      }
+
+      if(m_events)
+      {
+         m_events->OnGWConnectionStatusChanged(connected);
+      }
+
+      return S_OK;
+   }
+
+   /// @brief Fired when some changes occurred
+   ///        in the connection with the CQG data server.
+   /// @param newStatus [in] New connection status
+   /// @return S_OK
+   STDMETHOD(OnDataConnectionStatusChanged)(
+      eConnectionStatus newStatus)
+   {
+      ATLTRACE("CQGCEL::OnDataConnectionStatusChanged\n");
+
+      if(m_events)
+      {
+         m_events->OnDataConnectionStatusChanged(newStatus == csConnectionUp);
+      }
+
+      return S_OK;
+   }
+
+   /// @brief Fired when new account is added, changed or removed.
+   /// @param change [in] Account change type
+   /// @param account [in] Changed account instance
+   /// @param position [in] Changed position instance
+   /// @return S_OK
+   STDMETHOD(OnAccountChanged)(
+      eAccountChangeType change,
+      ICQGAccount* account,
+      ICQGPosition* position)
+   {
+      ATLTRACE("CQGCEL::OnAccountChanged\n");
+
+      if(!m_events)
+      {
+         return S_OK;
+      }
+
+      if(change == actAccountsReloaded)
+      {
+         m_accounts.clear();
+         ++m_accountsGeneration;
+         m_events->OnAccountsReloaded();
+      }
+      else if(change == actPositionsReloaded)
+      {
+         m_events->OnPositionsReloaded();
+      }
+      else if(change == actAccountChanged || change == actPositionAdded || change == actPositionChanged)
+      {
+         ATL::CComPtr<ICQGAccountSummary> spAccSum;
+         HRESULT hr = account->get_Summary(&spAccSum);
+         CheckCOMError<ICQGAccount>(account, hr);
+
+         AccountInfo accountInfo;
+         GetAccountInfo(account, spAccSum, accountInfo);
+
+         if(change == actAccountChanged)
+         {
+            m_events->OnAccountChanged(accountInfo);
+         }
+         else
+         {
+            PositionInfo positionInfo;
+            GetPositionInfo(position, positionInfo);
+
+            m_events->OnPositionChanged(accountInfo, positionInfo, change == actPositionAdded);
+         }
+      }
+
+      return S_OK;
+   }
+
+   /// @brief Fired when new instrument is resolved and subscribed.
+   /// @param symbol [in] Requested symbol
+   /// @param instrument [in] Subscribed instrument object
+   /// @return S_OK
+   STDMETHOD(OnInstrumentSubscribed)(
+      BSTR symbol,
+      ICQGInstrument* instrument)
+   {
+      ATLTRACE("CQGCEL::OnInstrumentSubscribed\n");
+
+      if(m_events)
+      {
+         ATL::CComBSTR strSymbol;
+         HRESULT hr = instrument->get_FullName(&strSymbol);
+         CheckCOMError<ICQGInstrument>(instrument, hr);
+
+         const CString fullName(strSymbol);
+
+         ATL::CComPtr<ICQGQuotes> quotes;
+         hr = instrument->get_Quotes(&quotes);
+         CheckCOMError<ICQGInstrument>(instrument, hr);
+
+         QuoteEvent quoteEvent;
+         quoteEvent.symbolId = InvalidSymbolId;
+         GetAllQuotes(quotes, quoteEvent);
+
+         double tickSize = 0.0;
+         hr = instrument->get_TickSize(&tickSize);
+         CheckCOMError<ICQGInstrument>(instrument, hr);
+
+         double tickValue = 0.0;
+         hr = instrument->get_TickValue(&tickValue);
+         CheckCOMError<ICQGInstrument>(instrument, hr);
+
+         const SymbolId id = m_events->OnInstrumentSubscribed(CString(symbol), fullName, tickSize, tickValue,
+            quoteEvent);
+         registerInstrument(id, fullName, instrument);
+      }
+
+      return S_OK;
+   }
+
+   /// @brief Fired when any of instrument quotes or
+   ///        dynamic instrument properties are changed.
+   /// @param instrument [in] Changed instrument object
+   /// @param quotes [in] Changed quotes collection
+   /// @param props [in] Changed properties collection
+   /// @return S_OK
+   STDMETHOD(OnInstrumentChanged)(
+      ICQGInstrument* instrument,
+      ICQGQuotes* quotes,
+      ICQGInstrumentProperties* /*props*/)
+   {
+      ATLTRACE("CQGCEL::OnInstrumentChanged\n");
+
+      if(m_events)
+      {
+         QuoteEvent quoteEvent;
+         quoteEvent.symbolId = findInstrument(instrument);
+
+         if(quoteEvent.symbolId != InvalidSymbolId)
+         {
+            GetAllQuotes(quotes, quoteEvent);
+            m_events->OnInstrumentChanged(quoteEvent);
+         }
+      }
+
+      return S_OK;
+   }
+
+   /// @brief Fired when instrument DOM is changed, dsQuotesAndDOM subscription level only.
+   /// @param instrument [in] Changed instrument object
+   /// @param prevAsks [in] Previous ask levels, not used
+   /// @param prevBids [in] Previous bid levels, not used
+   /// @return S_OK
+   STDMETHOD(OnInstrumentDOMChanged)(
+      ICQGInstrument* instrument,
+      ICQGDOMQuotes* /*prevAsks*/,
+      ICQGDOMQuotes* /*prevBids*/)
+   {
+      ATLTRACE("CQGCEL::OnInstrumentDOMChanged\n");
+
+      if(m_events)
+      {
+         MarketDepth depth;
+         depth.symbolId = findInstrument(instrument);
+
+         if(depth.symbolId != InvalidSymbolId)
+         {
+            ATL::CComPtr<ICQGDOMQuotes> bids;
+            HRESULT hr = instrument->get_DOMBids(&bids);
+            CheckCOMError<ICQGInstrument>(instrument, hr);
+
+            ATL::CComPtr<ICQGDOMQuotes> asks;
+            hr = instrument->get_DOMAsks(&asks);
+            CheckCOMError<ICQGInstrument>(instrument, hr);
+
+            depth.bidsCount = GetDOMLevels(bids, depth.bids);
+            depth.asksCount = GetDOMLevels(asks, depth.asks);
+
+            m_events->OnInstrumentDOMChanged(depth);
+         }
+      }
+
+      return S_OK;
+   }
+
+   /// @brief This event is fired when a not tradable symbol name has been 
+   ///         passed to the NewInstrument method.
+   /// @param wrongSymbol [in] Requested symbol
+   /// @return S_OK
+   STDMETHOD(OnIncorrectSymbol)(BSTR wrongSymbol)
+   {
+      ATLTRACE("CQGCEL::OnIncorrectSymbol\n");
+
+      if(m_events)
+      {
+         m_events->OnIncorrectSymbol(CString(wrongSymbol));
+      }
+
+      return S_OK;
+   }
+
+   /// @brief Fired when new order was added, order status was 
+   ///        changed or the order was removed.
+   /// @param change [in] The type of the occurred change
+   /// @param order [in] CQGOrder object representing the order to which the change refers
+   /// @param oldProperties [in] CQGOrderProperties collection representing 
+   ///        the old values of the changed order properties
+   /// @param fill [in] CQGFill object representing the last fill of the order
+   /// @param cqgerr [in] CQGError object to describe the last error, if any
+   /// @return S_OK
+   STDMETHOD(OnOrderChanged)(
+      eChangeType /*change*/,
+      ICQGOrder* order,
+      ICQGOrderProperties* /*oldProperties*/,
+      ICQGFill* fill,
+      ICQGError* cqgerr)
+   {
+      ATLTRACE("CQGCEL::OnOrderChanged\n");
+
+      if(m_events)
+      {
+         OrderInfo orderInfo;
+
+         ATL::CComBSTR strGuid;
+         order->get_GUID(&strGuid);
+         orderInfo.orderGuid = strGuid;
+
+         // Working orders are kept to be canceled without CQGCEL orders lookup,
+         // properties which never change are read once per order.
+         WorkingOrder& working = m_workingOrders[orderInfo.orderGuid];
+         if(!working.order)
+         {
+            working.order = order;
+         }
+
+         if(!working.resolved)
+         {
+            ATL::CComBSTR strSymbol;
+            order->get_InstrumentName(&strSymbol);
+            working.symbol = strSymbol;
+
+            ATL::CComPtr<ICQGAccount> spAcc;
+            order->get_Account(&spAcc);
+            spAcc->get_GWAccountID(&working.gwAccountID);
+
+            eOrderSide side = osdUndefined;
+            order->get_Side(&side);
+            working.buy = side == osdBuy;
+
+            ATL::CComBSTR description;
+            order->get_Description(&description);
+            working.description = description;
+
+            working.resolved = true;
+         }
+
+         // Gateway order ID is known once gateway accepts order.
+         if(working.gwOrderID.IsEmpty())
+         {
+            ATL::CComBSTR originOrderID;
+            order->get_OriginalOrderID(&originOrderID);
+            working.gwOrderID = originOrderID;
+         }
+
+         orderInfo.symbol = working.symbol;
+         orderInfo.gwAccountID = working.gwAccountID;
+         orderInfo.buy = working.buy;
+         orderInfo.description = working.description;
+         orderInfo.gwOrderID = working.gwOrderID;
+
+         VARIANT_BOOL state = VARIANT_FALSE;
+         order->get_IsFinal(&state);
+         orderInfo.final = state == VARIANT_TRUE;
+
+         if(orderInfo.final)
+         {
+            m_workingOrders.erase(orderInfo.orderGuid);
+         }
+
+         eOrderStatus gwStatus = osNotSent;
+         order->get_GWStatus(&gwStatus);
+         orderInfo.modifyPending = gwStatus == osInModify;
+
+         long qty = 0;
+         order->get_Quantity(&qty);
+         orderInfo.quantity = qty;
+
+         long filledQty = 0;
+         order->get_FilledQuantity(&filledQty);
+         orderInfo.filledQty = filledQty;
+
+         // Every change carries the last fill, facade core drops already reported one by its identity.
+         FillKey lastFill;
+
+         if(checkValidPtr(fill))
+         {
+            long legCount = 0;
+            fill->get_LegCount(&legCount);
+
+            eFillStatus status = fsNormal;
+            fill->get_Status(&status);
+
+            long fillId = 0;
+            fill->get_Id(&fillId);
+            lastFill = FillKey(fillId, status);
+
+            orderInfo.orderFills.reserve(legCount);
+
+            for(long i = 0; i < legCount; ++i)
+            {
+               FillInfo fillInfo;
+
+               fillInfo.canceled = (status == fsCanceled) || (status == fsBusted);
+
+               ATL::CComBSTR strSymbol;
+               fill->get_InstrumentName(i, &strSymbol);
+               fillInfo.symbol = strSymbol;
+
+               fill->get_Price(i, &fillInfo.fillPrice);
+               fill->get_Quantity(i, &fillInfo.fillQty);
+
+               orderInfo.orderFills.push_back(fillInfo);
+            }
+         }
+
+         if(checkValidPtr(cqgerr))
+         {
+            ATL::CComBSTR errorDesc;
+            cqgerr->get_Description(&errorDesc);
+            orderInfo.error = errorDesc;
+         }
+
+         m_events->OnOrderChanged(orderInfo, lastFill);
+      }
+
+      return S_OK;
+   }
+
+   STDMETHOD(OnTimedBarsResolved)(
+      ICQGTimedBars* cqgTimedBars,
+      ICQGError* cqgerr)
+   {
+      ATLTRACE("CQGCEL::OnTimedBarsResolved\n");
+
+      if(m_events)
+      {
+         ATL::CComBSTR requestID;
+         Bars bars;
+
+         cqgTimedBars->get_Id(&requestID);
+         bars.requestGuid = CString(requestID);
+
+         if(checkValidPtr(cqgerr))
+         {
+            ATL::CComBSTR errorDesc;
+            cqgerr->get_Description(&errorDesc);
+            bars.error = errorDesc;
+         }
+
+         eRequestStatus status;
+         cqgTimedBars->get_Status(&status);
+         if(bars.error.IsEmpty() && status != rsSuccess)
+         {
+            bars.error = "Bars request failed, cancelled or pending.";
+         }
+
+         bars.requestedCount = 0;
+         cqgTimedBars->get_Count(&bars.requestedCount);
+
+         bars.bars.reserve(bars.requestedCount);
+
+         // Subscribed bars keep invalid bars, so bar indexes of further changes match.
+         const bool subscribed = m_subscribedBars.find(bars.requestGuid) != m_subscribedBars.end();
+
+         for(long i = 0; i < bars.requestedCount; ++i)
+         {
+            BarInfo bar;
+
+            // Skip invalid bars.
+            if(!getBar(cqgTimedBars, i, bar) && !subscribed) continue;
+
+            bars.bars.push_back(bar);
+         }
+
+         if(!bars.error.IsEmpty())
+         {
+            m_subscribedBars.erase(bars.requestGuid);
+         }
+
+         m_events->OnTimedBarsResolved(bars);
+      }
+
+      return S_OK;
+   }
+
+   STDMETHOD(OnTimedBarsAdded)(
+      ICQGTimedBars* cqgTimedBars)
+   {
+      ATLTRACE("CQGCEL::OnTimedBarsAdded\n");
+
+      // New bar is always the last one.
+      long count = 0;
+      cqgTimedBars->get_Count(&count);
+      fireTimedBarsChanged(cqgTimedBars, BarAdded, count - 1);
+
+      return S_OK;
+   }
+
+   STDMETHOD(OnTimedBarsUpdated)(
+      ICQGTimedBars* cqgTimedBars,
+      long barIndex)
+   {
+      ATLTRACE("CQGCEL::OnTimedBarsUpdated\n");
+      fireTimedBarsChanged(cqgTimedBars, BarUpdated, barIndex);
+      return S_OK;
+   }
+
+   STDMETHOD(OnTimedBarsInserted)(
+      ICQGTimedBars* cqgTimedBars,
+      long barIndex)
+   {
+      ATLTRACE("CQGCEL::OnTimedBarsInserted\n");
+      fireTimedBarsChanged(cqgTimedBars, BarInserted, barIndex);
+      return S_OK;
+   }
+
+   STDMETHOD(OnTimedBarsRemoved)(
+      ICQGTimedBars* cqgTimedBars,
+      long barIndex)
+   {
+      ATLTRACE("CQGCEL::OnTimedBarsRemoved\n");
+      fireTimedBarsChanged(cqgTimedBars, BarRemoved, barIndex);
+      return S_OK;
+   }
+
+private:
+
+   /// @brief Initializes CQGCEL object, starts the CQGCEL and subscribes to events.
+   void initializeCQGCEL()
+   {
+      // Create an instance of CQG API
+      HRESULT hr = m_spCQGCEL.CoCreateInstance(__uuidof(CQGCEL), NULL, CLSCTX_INPROC_SERVER);
+      if(FAILED(hr))
+      {
+         throw std::runtime_error("Unable to create CQGCEL COM object. "
+            "Please register it again and restart application.");
+      }
+
+      ATLASSERT(m_spCQGCEL);
+
+      // Configure CQGCEL behavior
+      ATL::CComPtr<ICQGAPIConfig> spConf;
+      hr = m_spCQGCEL->get_APIConfiguration(&spConf);
+      CheckCOMError(m_spCQGCEL, hr);
+
+      hr = spConf->put_ReadyStatusCheck(rscOff);
+      CheckCOMError(spConf, hr);
+
+      hr = spConf->put_UsedFromATLClient(VARIANT_TRUE);
+      CheckCOMError(spConf, hr);
+
+      hr = spConf->put_CollectionsThrowException(VARIANT_FALSE);
+      CheckCOMError(spConf, hr);
+
+      hr = spConf->put_TimeZoneCode(tzCentral);
+      CheckCOMError(spConf, hr);
+
+      hr = spConf->put_UseOrderSide(VARIANT_TRUE);
+      CheckCOMError(spConf, hr);
+
+      // Default is dsQuotesAndBBA - receive best bid/best ask and trade quotes
+      // To switch to trades only market data notifications replace X with dsQuotes
+      if(m_marketDepth)
+      {
+         hr = spConf->put_DefaultInstrumentSubscriptionLevel(dsQuotesAndDOM);
+         CheckCOMError(spConf, hr);
+      }
+
+      // Switch full position notifications
+      hr = spConf->put_DefPositionSubscriptionLevel(pslSnapshotAndUpdates);
+      CheckCOMError(spConf, hr);
+
+      // Posted calls go through the same thread message loop as CQGCEL events
+      if(!m_postedCalls.Create(HWND_MESSAGE))
+      {
+         throw std::runtime_error("Unable to create posted calls window.");
+      }
+
+      // Now advise the connection, to get events
+      ATLVERIFY(SUCCEEDED(ICQGCELDispEventImpl::DispEventAdvise(m_spCQGCEL)));
+
+      // Start CQGCEL
+      hr = m_spCQGCEL->Startup();
+      CheckCOMError(m_spCQGCEL, hr);
+   }
+
+   /// @brief Unsubscribes from events, shuts down the CQGCEL and finalizes CQGCEL object.
+   void finalizeCQGCEL() throw()
+   {
+      m_events = NULL;
+
+      m_postedCalls.Clear();
+      if(m_postedCalls.IsWindow())
+      {
+         m_postedCalls.DestroyWindow();
+      }
+
+      m_instruments.clear();
+      m_instrumentIds.clear();
+      m_instrumentIdsByName.clear();
+      m_accounts.clear();
+      m_tickets.clear();
+      m_identities.clear();
+      m_subscribedBars.clear();
+      m_workingOrders.clear();
+
+      if (m_spCQGCEL)
+      {
+         ATLVERIFY(SUCCEEDED(ICQGCELDispEventImpl::DispEventUnadvise(m_spCQGCEL)));
+         ATLVERIFY(SUCCEEDED(m_spCQGCEL->Shutdown()));
+         m_spCQGCEL.Release();
+      }
+   }
+
+   template <typename Interface>
+   bool checkValidPtr(Interface* obj)
+   {
+      if(!obj)
+      {
+         return false;
+      }
+
+      return checkValid(obj);
+   }
+
+   template <typename Object>
+   bool checkValid(Object obj)
+   {
+      VARIANT_BOOL valid = VARIANT_FALSE;
+      m_spCQGCEL->IsValid(ATL::CComVariant(obj), &valid);
+      return (valid == VARIANT_TRUE);
+   }
+
+   typedef ATL::CComPtr<ICQGAccount> ICQGAccountPtr;
+
+   /// @brief Gets account object, resolved accounts are kept until CQGCEL reloads accounts.
+   ICQGAccountPtr getAccount(const ID& gwAccountID, CString& error)
+   {
+      const AccountsCache::const_iterator it = m_accounts.find(gwAccountID);
+      if(it != m_accounts.end())
+      {
+         return it->second.m_T;
+      }
+
+      ICQGAccountPtr spAccount;
+
+      ATL::CComPtr<ICQGAccounts> spAccounts;
+      HRESULT hr = m_spCQGCEL->get_Accounts(&spAccounts);
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, spAccount);
+
+      hr = spAccounts->get_Item(gwAccountID, &spAccount);
+      CHECK_CEL_OBJ_RESULT(spAccounts, hr, spAccount);
+
+      if(!spAccount)
+      {
+         error = "Account not found.";
+         return spAccount;
+      }
+
+      m_accounts[gwAccountID] = spAccount;
+      return spAccount;
+   }
+
+   /// @brief Gets instrument object by full name. Subscribed instruments are found by interned name,
+   ///        CQGCEL instruments collection is asked only for instruments subscribed elsewhere.
+   ATL::CComPtr<ICQGInstrument> getInstrument(const CString& fullName, CString& error)
+   {
+      const InstrumentIdsByName::const_iterator it = m_instrumentIdsByName.find(fullName);
+      if(it != m_instrumentIdsByName.end() && it->second < m_instruments.size() && m_instruments[it->second].m_T)
+      {
+         return m_instruments[it->second].m_T;
+      }
+
+      ATL::CComPtr<ICQGInstrument> spInstrument;
+
+      ATL::CComPtr<ICQGInstruments> spInstruments;
+      HRESULT hr = m_spCQGCEL->get_Instruments(&spInstruments);
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, spInstrument);
+
+      hr = spInstruments->get_Item(ATL::CComVariant(fullName.GetString()), &spInstrument);
+      CHECK_CEL_OBJ_RESULT(spInstruments, hr, spInstrument);
+
+      if(!spInstrument)
+      {
+         error = "Instrument not subscribed";
+      }
+
+      return spInstrument;
+   }
+
+   /// @brief Order parameters resolved ahead of placing, see IAPIFacade::PrepareOrderTicket().
+   struct PreparedOrder
+   {
+      PreparedOrder(): type(Market), cqgType(otMarket), gwAccountID(0), accountsGeneration(0), side(osdBuy)
+      {}
+
+      OrderType type;                              ///< Order type.
+      eOrderType cqgType;                          ///< CQGCEL order type.
+      ID gwAccountID;                              ///< Gateway account ID.
+      unsigned accountsGeneration;                 ///< Accounts reload account object belongs to.
+      ATL::CComPtr<ICQGAccount> account;           ///< Order account.
+      ATL::CComPtr<ICQGInstrument> instrument;     ///< Order instrument, NULL if ticket is released.
+      eOrderSide side;                             ///< Order side.
+      ATL::CComBSTR description;                   ///< Order description, NULL if empty.
+   };
+
+   typedef std::vector<PreparedOrder> PreparedOrders;
+
+   /// @brief Converts order type to CQGCEL one.
+   static eOrderType getOrderType(OrderType type)
+   {
+      return
+         type == Limit ? otLimit :
+            type == Stop ? otStop :
+               type == StopLimit ? otStopLimit : otMarket;
+   }
+
+   /// @brief Sets new value of order property to modify.
+   bool setModifyProperty(
+      const ATL::CComPtr<ICQGOrderModify>& spModify,
+      eOrderProperty id,
+      const ATL::CComVariant& value,
+      CString& error)
+   {
+      ATL::CComPtr<ICQGOrderProperty> spProperty;
+      HRESULT hr = spModify->get_Properties(id, &spProperty);
+      CHECK_CEL_OBJ_RESULT(spModify, hr, false);
+
+      hr = spProperty->put_Value(value);
+      CHECK_CEL_OBJ_RESULT(spProperty, hr, false);
+
+      return true;
+   }
+
+   /// @brief Resolves order account & instrument and converts order parameters to CQGCEL ones.
+   bool prepareOrder(
+      OrderType type,
+      const ID& gwAccountID,
+      const CString& symbolFullName,
+      bool buy,
+      const CString& description,
+      PreparedOrder& order,
+      CString& error)
+   {
+      order.account = getAccount(gwAccountID, error);
+      if(!order.account) return false;
+
+      order.instrument = getInstrument(symbolFullName, error);
+      if(!order.instrument) return false;
+
+      order.type = type;
+      order.cqgType = getOrderType(type);
+
+      order.gwAccountID = gwAccountID;
+      order.accountsGeneration = m_accountsGeneration;
+      order.side = buy ? osdBuy : osdSell;
+      order.description.Empty();
+      if(!description.IsEmpty())
+      {
+         order.description = ATL::CComBSTR(description);
+      }
+
+      return true;
+   }
+
+   /// @brief Creates & places order of prepared parameters.
+   /// @return Placed order guid or empty string if failed.
+   CString placeOrder(
+      PreparedOrder& order,
+      const OrderPrice& price,
+      Quantity quantity,
+      const OrderPrice& stopLimitPrice,
+      CString& error)
+   {
+      // Account objects are replaced when CQGCEL reloads accounts.
+      if(order.accountsGeneration != m_accountsGeneration)
+      {
+         order.account = getAccount(order.gwAccountID, error);
+         if(!order.account) return CString();
+
+         order.accountsGeneration = m_accountsGeneration;
+      }
+
+      const OrderType type = order.type;
+
+      const OrderPrice& limitPrice = 
+         type == Limit ? price : 
+            type == StopLimit ? stopLimitPrice : OrderPrice();
+
+      const OrderPrice& stopPrice =
+         type == Stop || type == StopLimit ? price : OrderPrice();
+
+      // Create order
+      ATL::CComPtr<ICQGOrder> spOrder;
+      HRESULT hr = m_spCQGCEL->CreateOrder(order.cqgType, order.instrument, order.account,
+         quantity, order.side,
+         limitPrice.initialized() ? limitPrice.price() : 0.0,
+         stopPrice.initialized() ? stopPrice.price() : 0.0,
+         L"", &spOrder);
+
+      CHECK_CEL_OBJ_RESULT(m_spCQGCEL, hr, (CString()));
+
+      // Set order description
+      if(order.description)
+      {
+         hr = spOrder->put_Description(order.description);
+         CHECK_CEL_OBJ_RESULT(spOrder, hr, (CString()));
+      }
+
+      // Place order
+      hr = spOrder->Place();
+      CHECK_CEL_OBJ_RESULT(spOrder, hr, (CString()));
+
+      // Return order guid, order is kept until it's final
+      ATL::CComBSTR orderGuid;
+      spOrder->get_GUID(&orderGuid);
+      m_workingOrders[CString(orderGuid)].order = spOrder;
+      return CString(orderGuid);
+   }
+
+   /// @brief Reads timed bar.
+   /// @param bar [out] bar, prices are InvalidPrice if bar is invalid, e.g. has no trades.
+   /// @return False if bar is invalid.
+   bool getBar(ICQGTimedBars* cqgTimedBars, long index, BarInfo& bar)
+   {
+      ATL::CComPtr<ICQGTimedBar> spBar;
+      cqgTimedBars->get_Item(index, &spBar);
+
+      spBar->get_Timestamp(&bar.timestamp.m_dt);
+      spBar->get_Open(&bar.open);
+      spBar->get_High(&bar.high);
+      spBar->get_Low(&bar.low);
+      spBar->get_Close(&bar.close);
+      spBar->get_ActualVolume(&bar.volume);
+
+      if(!checkValid(bar.open))
+      {
+         bar.open = bar.high = bar.low = bar.close = InvalidPrice;
+         bar.volume = 0;
+         return false;
+      }
+
+      return true;
+   }
+
+   /// @brief Reports subscribed timed bars change.
+   void fireTimedBarsChanged(ICQGTimedBars* cqgTimedBars, BarsChange change, long index)
+   {
+      if(!m_events)
+      {
+         return;
+      }
+
+      ATL::CComBSTR requestID;
+      cqgTimedBars->get_Id(&requestID);
+
+      BarsUpdate update;
+      update.requestGuid = CString(requestID);
+      update.change = change;
+      update.index = index;
+
+      if(m_subscribedBars.find(update.requestGuid) == m_subscribedBars.end())
+      {
+         // Removed already.
+         return;
+      }
+
+      if(change == BarRemoved)
+      {
+         update.bar.open = update.bar.high = update.bar.low = update.bar.close = InvalidPrice;
+         update.bar.volume = 0;
+      }
+      else
+      {
+         getBar(cqgTimedBars, index, update.bar);
+      }
+
+      m_events->OnTimedBarsChanged(update);
+   }
+
+   /// @brief Gets instrument object of subscribed symbol.
+   ATL::CComPtr<ICQGInstrument> getInstrument(const SymbolId id, CString& error)
+   {
+      if(id >= m_instruments.size() || !m_instruments[id].m_T)
+      {
+         error = "Instrument not subscribed";
+         return NULL;
+      }
+
+      return m_instruments[id].m_T;
+   }
+
+   /// @brief Remembers instrument object of subscribed symbol.
+   void registerInstrument(const SymbolId id, const CString& fullName, ICQGInstrument* instrument)
+   {
+      ATL::CComPtr<IUnknown> spIdentity;
+      instrument->QueryInterface(IID_IUnknown, (void**)&spIdentity);
+
+      if(id >= m_instruments.size())
+      {
+         m_instruments.resize(id + 1);
+      }
+
+      m_instruments[id].m_T = instrument;
+      m_instrumentIdsByName[fullName] = id;
+
+      if(m_instrumentIds.insert(InstrumentIds::value_type(spIdentity.p, id)).second)
+      {
+         // Keep identity alive, so its address can't be reused by another object.
+         m_identities.push_back(ATL::CAdapt<ATL::CComPtr<IUnknown> >(spIdentity));
+      }
+   }
+
+   /// @brief Finds identifier of subscribed instrument object.
+   ///        COM object identity (IUnknown) is used first, so there is no need
+   ///        to fetch & copy instrument full name on each instrument update.
+   SymbolId findInstrument(ICQGInstrument* instrument)
+   {
+      ATL::CComPtr<IUnknown> spIdentity;
+      instrument->QueryInterface(IID_IUnknown, (void**)&spIdentity);
+
+      const InstrumentIds::const_iterator it = m_instrumentIds.find(spIdentity.p);
+      if(it != m_instrumentIds.end())
+      {
+         return it->second;
+      }
+
+      // CQGCEL gave another object for the same instrument, slow path.
+      ATL::CComBSTR strSymbol;
+      instrument->get_FullName(&strSymbol);
+
+      const InstrumentIdsByName::const_iterator itName = m_instrumentIdsByName.find(CString(strSymbol));
+      if(itName == m_instrumentIdsByName.end())
+      {
+         return InvalidSymbolId;
+      }
+
+      registerInstrument(itName->second, itName->first, instrument);
+      return itName->second;
+   }
+
+   /// @brief Working order & its properties which never change.
+   struct WorkingOrder
+   {
+      WorkingOrder(): gwAccountID(0), buy(false), resolved(false)
+      {}
+
+      ATL::CComPtr<ICQGOrder> order;   ///< CQGCEL order.
+      CString symbol;                  ///< Order symbol full name.
+      ID gwAccountID;                  ///< Order gateway account ID.
+      bool buy;                        ///< True if order side is buy.
+      CString description;             ///< Order description.
+      GWOrderID gwOrderID;             ///< Gateway order ID, empty until gateway accepts order.
+      bool resolved;                   ///< True if properties above except gateway order ID are read.
+   };
+
+   typedef ATL::CAdapt<ATL::CComPtr<ICQGInstrument> > ICQGInstrumentHolder;
+   typedef std::unordered_map<IUnknown*, SymbolId> InstrumentIds;
+   typedef std::unordered_map<CString, SymbolId, CStringHash> InstrumentIdsByName;
+   typedef std::unordered_map<ID, ATL::CAdapt<ICQGAccountPtr> > AccountsCache;
+   typedef std::map<CString, ATL::CAdapt<ATL::CComPtr<ICQGTimedBars> > > SubscribedBars;
+   typedef std::unordered_map<CString, WorkingOrder, CStringHash> WorkingOrders;
+
+   ATL::CComPtr<ICQGCEL> m_spCQGCEL; ///< CQGCEL object.
+   IBackendEvents* m_events;         ///< Facade core events listener.
+   bool m_marketDepth;               ///< True to subscribe instruments to DOM.
+
+   std::vector<ICQGInstrumentHolder> m_instruments;       ///< Subscribed instruments by symbol ID.
+   InstrumentIds m_instrumentIds;                         ///< Symbol IDs by instrument identity.
+   InstrumentIdsByName m_instrumentIdsByName;             ///< Symbol IDs by full name.
+   std::vector<ATL::CAdapt<ATL::CComPtr<IUnknown> > > m_identities; ///< Registered instrument identities.
+   SubscribedBars m_subscribedBars;                       ///< Subscribed timed bars by request guid.
+   WorkingOrders m_workingOrders;                         ///< Working orders by guid.
+   AccountsCache m_accounts;                              ///< Resolved accounts by gateway account ID.
+   unsigned m_accountsGeneration;                         ///< Number of accounts reloads.
+   PreparedOrders m_tickets;                              ///< Prepared order tickets by identifier.
+   PostedCallsWindow m_postedCalls;                       ///< Calls posted by facade core.
+}; // class CQGCELBackend
+
+IBackendPtr CreateCQGCELBackend()
+{
+   return IBackendPtr(new CQGCELBackend());
+}
+
+} // namespace cqg
+
+#endif // CQGAPIFACADE_USE_MFC
+
@@ -0,0 +1,567 @@
+/// @file DerivedBars.cpp
+/// @brief Simple C++ facade for CQG API - timed bars derived from finer base period bars implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "DerivedBars.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace cqg
+{
+
+namespace
+{
+
+const double MinutesPerDay = 24.0 * 60.0;
+
+/// @brief Timestamps of the same bar may differ by rounding, 1 millisecond.
+const double TimeEpsilon = 1.0 / (24.0 * 60.0 * 60.0 * 1000.0);
+
+/// @brief Minimum gap between base bars of the same day taken as session break, 1 hour.
+const double MinSessionBreak = 1.0 / 24.0;
+
+/// @brief Gets key of base request shared by derived requests.
+CString GetKey(const BarsRequest& request)
+{
+   CString key;
+   key.Format("%s|%ld", request.symbol.GetString(), request.sessionsFilter);
+   return key;
+}
+
+/// @brief Checks whether base bars gap starts new session: gap crosses a day or is long enough to be session break.
+///        Shorter gaps are periods without trades of illiquid symbol, they don't move coarse bars boundaries.
+bool IsSessionStart(const BarInfos& base, const size_t index, const double basePeriod)
+{
+   if(index == 0)
+   {
+      return false;
+   }
+
+   const double previous = base[index - 1].timestamp.m_dt;
+   const double time = base[index].timestamp.m_dt;
+   const double gap = time - previous;
+
+   return gap > basePeriod * 1.5 && (std::floor(time) != std::floor(previous) || gap >= MinSessionBreak - TimeEpsilon);
+}
+
+/// @brief Gets start of the first session found in base bars, zero (midnight) if there is no session gap.
+double GetFirstSessionStart(const BarInfos& base, const double basePeriod)
+{
+   for(size_t i = 1; i < base.size(); ++i)
+   {
+      if(IsSessionStart(base, i, basePeriod))
+      {
+         return base[i].timestamp.m_dt;
+      }
+   }
+
+   return 0.0;
+}
+
+/// @brief Adds base bar to coarse bar, bars without trades change volume only.
+void Merge(BarInfo& coarse, const BarInfo& bar)
+{
+   coarse.volume += bar.volume;
+
+   if(bar.close == InvalidPrice)
+   {
+      return;
+   }
+
+   if(coarse.close == InvalidPrice)
+   {
+      coarse.open = bar.open;
+      coarse.high = bar.high;
+      coarse.low = bar.low;
+   }
+   else
+   {
+      coarse.high = std::max(coarse.high, bar.high);
+      coarse.low = std::min(coarse.low, bar.low);
+   }
+
+   coarse.close = bar.close;
+}
+
+/// @brief Checks whether bars are the same.
+bool IsSameBar(const BarInfo& lhs, const BarInfo& rhs)
+{
+   return lhs.timestamp.m_dt == rhs.timestamp.m_dt && lhs.open == rhs.open && lhs.high == rhs.high &&
+      lhs.low == rhs.low && lhs.close == rhs.close && lhs.volume == rhs.volume;
+}
+
+/// @brief Applies bars change, see BarSeries::Apply().
+bool ApplyChange(BarInfos& bars, const BarsUpdate& update)
+{
+   if(update.index < 0)
+   {
+      return false;
+   }
+
+   const size_t size = bars.size();
+   const size_t index = static_cast<size_t>(update.index);
+
+   switch(update.change)
+   {
+   case BarAdded:
+      if(index != size) return false;
+      bars.push_back(update.bar);
+      break;
+
+   case BarUpdated:
+      if(index >= size) return false;
+      bars[index] = update.bar;
+      break;
+
+   case BarInserted:
+      if(index > size) return false;
+      bars.insert(bars.begin() + index, update.bar);
+      break;
+
+   case BarRemoved:
+      if(index >= size) return false;
+      bars.erase(bars.begin() + index);
+      break;
+   }
+
+   return true;
+}
+
+/// @brief Adds change of coarse bar to derived request changes, bars before reported ones are skipped.
+void AddUpdate(
+   const CString& requestGuid,
+   const BarsChange change,
+   const size_t index,
+   const size_t offset,
+   const BarInfos& bars,
+   std::vector<BarsUpdate>& updates)
+{
+   if(index < offset)
+   {
+      return;
+   }
+
+   BarsUpdate update;
+   update.requestGuid = requestGuid;
+   update.change = change;
+   update.index = static_cast<long>(index - offset);
+   if(change != BarRemoved)
+   {
+      update.bar = bars[index];
+   }
+
+   updates.push_back(update);
+}
+
+} // namespace
+
+bool DerivedBars::CanDerive(const BarsRequest& request) const
+{
+   return m_basePeriod > 0 && request.subscribe && request.useIndexRange &&
+      std::max(request.startIndex, request.endIndex) == 0 &&
+      request.intradayPeriodInMinutes > m_basePeriod &&
+      request.intradayPeriodInMinutes % m_basePeriod == 0;
+}
+
+CString DerivedBars::Request(IBaseBarsSource& source, const BarsRequest& request)
+{
+   const long factor = request.intradayPeriodInMinutes / m_basePeriod;
+   const long count = std::abs(request.startIndex - request.endIndex) + 1;
+
+   // One more coarse bar, so the oldest requested one is complete.
+   const long baseCount = (count + 1) * factor;
+
+   CString baseGuid;
+
+   const KeysMap::const_iterator itCurrent = m_current.find(GetKey(request));
+   if(itCurrent != m_current.end())
+   {
+      const CString currentGuid = itCurrent->second;
+      Base& current = m_bases[currentGuid];
+
+      if(!current.sent)
+      {
+         // Base request is not sent yet, so it just grows.
+         current.count = std::max(current.count, baseCount);
+         current.request.endIndex = 1 - current.count;
+         current.request.priority = std::min(current.request.priority, request.priority);
+         baseGuid = currentGuid;
+      }
+      else if(current.count >= baseCount)
+      {
+         baseGuid = currentGuid;
+      }
+      else if(!current.resolved)
+      {
+         // Nothing is derived from unresolved base request yet, so it's just replaced by bigger one.
+         baseGuid = addBase(request, baseCount);
+
+         Base& bigger = m_bases[baseGuid];
+         bigger.derived.swap(current.derived);
+         for(size_t i = 0; i < bigger.derived.size(); ++i)
+         {
+            m_derived[bigger.derived[i]].baseGuid = baseGuid;
+         }
+
+         m_bases.erase(currentGuid);
+         source.CancelBaseBars(currentGuid);
+      }
+   }
+
+   // Resolved base request is too short, bigger one is used by this & later requests.
+   if(baseGuid.IsEmpty())
+   {
+      baseGuid = addBase(request, baseCount);
+   }
+
+   CString requestGuid;
+   requestGuid.Format("{FACADE-DERIVED-%08u}", ++m_guidsCount);
+
+   Derived& derived = m_derived[requestGuid];
+   derived.request = request;
+   derived.baseGuid = baseGuid;
+   derived.period = request.intradayPeriodInMinutes / MinutesPerDay;
+   derived.count = count;
+   derived.resolved = false;
+   derived.offset = 0;
+
+   m_bases[baseGuid].derived.push_back(requestGuid);
+   return requestGuid;
+}
+
+void DerivedBars::SendBases(IBaseBarsSource& source, std::vector<Bars>& failed)
+{
+   failed.clear();
+
+   std::vector<CString> unsent;
+   unsent.swap(m_unsent);
+
+   for(size_t i = 0; i < unsent.size(); ++i)
+   {
+      // Base request may be already replaced or canceled.
+      const BasesMap::iterator itBase = m_bases.find(unsent[i]);
+      if(itBase == m_bases.end() || itBase->second.sent)
+      {
+         continue;
+      }
+
+      CString error;
+      const CString baseGuid = source.RequestBaseBars(itBase->second.request, error);
+      if(baseGuid.IsEmpty())
+      {
+         for(size_t j = 0; j < itBase->second.derived.size(); ++j)
+         {
+            Bars bars;
+            bars.requestGuid = itBase->second.derived[j];
+            bars.error = error;
+            failed.push_back(bars);
+         }
+
+         removeBase(unsent[i]);
+         continue;
+      }
+
+      itBase->second.sent = true;
+      renameBase(unsent[i], baseGuid);
+   }
+}
+
+bool DerivedBars::Resolve(const CString& requestGuid, Bars& bars)
+{
+   const DerivedMap::iterator it = m_derived.find(requestGuid);
+   if(it == m_derived.end() || it->second.resolved)
+   {
+      return false;
+   }
+
+   const BasesMap::const_iterator itBase = m_bases.find(it->second.baseGuid);
+   if(itBase == m_bases.end() || !itBase->second.resolved)
+   {
+      return false;
+   }
+
+   derive(it->second, itBase->second.bars, 0);
+   getBars(requestGuid, it->second, bars);
+   return true;
+}
+
+bool DerivedBars::Cancel(IBaseBarsSource& source, const CString& requestGuid)
+{
+   const DerivedMap::iterator it = m_derived.find(requestGuid);
+   if(it == m_derived.end())
+   {
+      return false;
+   }
+
+   const CString baseGuid = it->second.baseGuid;
+   m_derived.erase(it);
+
+   const BasesMap::iterator itBase = m_bases.find(baseGuid);
+   if(itBase == m_bases.end())
+   {
+      return true;
+   }
+
+   std::vector<CString>& derived = itBase->second.derived;
+   derived.erase(std::remove(derived.begin(), derived.end(), requestGuid), derived.end());
+
+   if(derived.empty())
+   {
+      const bool sent = itBase->second.sent;
+      removeBase(baseGuid);
+
+      if(sent)
+      {
+         source.CancelBaseBars(baseGuid);
+      }
+   }
+
+   return true;
+}
+
+bool DerivedBars::OnBaseResolved(const Bars& bars, std::vector<Bars>& resolved)
+{
+   resolved.clear();
+
+   const BasesMap::iterator itBase = m_bases.find(bars.requestGuid);
+   if(itBase == m_bases.end())
+   {
+      return false;
+   }
+
+   Base& base = itBase->second;
+
+   if(!bars.error.IsEmpty())
+   {
+      for(size_t i = 0; i < base.derived.size(); ++i)
+      {
+         Bars failed;
+         failed.requestGuid = base.derived[i];
+         failed.error = bars.error;
+         resolved.push_back(failed);
+      }
+
+      removeBase(bars.requestGuid);
+      return true;
+   }
+
+   base.bars = bars.bars;
+   base.resolved = true;
+
+   for(size_t i = 0; i < base.derived.size(); ++i)
+   {
+      Derived& derived = m_derived[base.derived[i]];
+      if(derived.resolved)
+      {
+         continue;
+      }
+
+      resolved.push_back(Bars());
+      derive(derived, base.bars, 0);
+      getBars(base.derived[i], derived, resolved.back());
+   }
+
+   return true;
+}
+
+bool DerivedBars::OnBaseChanged(const BarsUpdate& update, std::vector<BarsUpdate>& updates)
+{
+   updates.clear();
+
+   const BasesMap::iterator itBase = m_bases.find(update.requestGuid);
+   if(itBase == m_bases.end())
+   {
+      return false;
+   }
+
+   Base& base = itBase->second;
+   if(!base.resolved || !ApplyChange(base.bars, update))
+   {
+      return true;
+   }
+
+   const size_t index = static_cast<size_t>(update.index);
+
+   for(size_t i = 0; i < base.derived.size(); ++i)
+   {
+      const CString& requestGuid = base.derived[i];
+      Derived& derived = m_derived[requestGuid];
+      if(!derived.resolved)
+      {
+         continue;
+      }
+
+      // Coarse bars from the one containing changed base bar on are derived again.
+      size_t from = 0;
+      for(size_t k = derived.starts.size(); k > 0; --k)
+      {
+         if(derived.starts[k - 1].first <= index)
+         {
+            from = k - 1;
+            break;
+         }
+      }
+
+      const BarInfos previous(derived.bars.begin() + std::min(from, derived.bars.size()), derived.bars.end());
+      const size_t previousSize = from + previous.size();
+
+      derive(derived, base.bars, from);
+
+      const size_t size = derived.bars.size();
+      for(size_t k = from; k < std::min(size, previousSize); ++k)
+      {
+         if(!IsSameBar(previous[k - from], derived.bars[k]))
+         {
+            AddUpdate(requestGuid, BarUpdated, k, derived.offset, derived.bars, updates);
+         }
+      }
+
+      for(size_t k = previousSize; k < size; ++k)
+      {
+         AddUpdate(requestGuid, BarAdded, k, derived.offset, derived.bars, updates);
+      }
+
+      for(size_t k = previousSize; k > size; --k)
+      {
+         AddUpdate(requestGuid, BarRemoved, k - 1, derived.offset, derived.bars, updates);
+      }
+   }
+
+   return true;
+}
+
+CString DerivedBars::addBase(const BarsRequest& request, long count)
+{
+   CString baseGuid;
+   baseGuid.Format("{FACADE-BASE-%08u}", ++m_guidsCount);
+
+   Base& base = m_bases[baseGuid];
+   base.key = GetKey(request);
+   base.request.symbol = request.symbol;
+   base.request.useIndexRange = true;
+   base.request.startIndex = 0;
+   base.request.endIndex = 1 - count;
+   base.request.intradayPeriodInMinutes = m_basePeriod;
+   base.request.sessionsFilter = request.sessionsFilter;
+   base.request.subscribe = true;
+   base.request.priority = request.priority;
+   base.count = count;
+   base.sent = false;
+   base.resolved = false;
+
+   m_current[base.key] = baseGuid;
+   m_unsent.push_back(baseGuid);
+   return baseGuid;
+}
+
+void DerivedBars::renameBase(const CString& baseGuid, const CString& newGuid)
+{
+   const BasesMap::iterator itBase = m_bases.find(baseGuid);
+   if(itBase == m_bases.end())
+   {
+      return;
+   }
+
+   Base& base = m_bases[newGuid];
+   base = itBase->second;
+   m_bases.erase(baseGuid);
+
+   for(size_t i = 0; i < base.derived.size(); ++i)
+   {
+      m_derived[base.derived[i]].baseGuid = newGuid;
+   }
+
+   const KeysMap::iterator itCurrent = m_current.find(base.key);
+   if(itCurrent != m_current.end() && itCurrent->second == baseGuid)
+   {
+      itCurrent->second = newGuid;
+   }
+}
+
+void DerivedBars::removeBase(const CString& baseGuid)
+{
+   const BasesMap::iterator itBase = m_bases.find(baseGuid);
+   if(itBase == m_bases.end())
+   {
+      return;
+   }
+
+   const KeysMap::iterator itCurrent = m_current.find(itBase->second.key);
+   if(itCurrent != m_current.end() && itCurrent->second == baseGuid)
+   {
+      m_current.erase(itCurrent);
+   }
+
+   for(size_t i = 0; i < itBase->second.derived.size(); ++i)
+   {
+      m_derived.erase(itBase->second.derived[i]);
+   }
+
+   m_bases.erase(itBase);
+}
+
+void DerivedBars::derive(Derived& derived, const BarInfos& base, size_t from) const
+{
+   const double basePeriod = m_basePeriod / MinutesPerDay;
+
+   size_t first = 0;
+   double anchor = 0.0;
+
+   if(from < derived.starts.size())
+   {
+      first = derived.starts[from].first;
+      anchor = derived.starts[from].anchor;
+   }
+   else
+   {
+      from = 0;
+      anchor = GetFirstSessionStart(base, basePeriod);
+   }
+
+   derived.bars.resize(from);
+   derived.starts.resize(from);
+
+   for(size_t i = first; i < base.size(); ++i)
+   {
+      const double time = base[i].timestamp.m_dt;
+      if(IsSessionStart(base, i, basePeriod))
+      {
+         anchor = time;
+      }
+
+      const double start = anchor + std::floor((time - anchor) / derived.period + 1e-6) * derived.period;
+
+      if(derived.bars.size() > from && std::abs(derived.bars.back().timestamp.m_dt - start) < TimeEpsilon)
+      {
+         Merge(derived.bars.back(), base[i]);
+         continue;
+      }
+
+      derived.bars.push_back(base[i]);
+      derived.bars.back().timestamp = COleDateTime(start);
+
+      CoarseStart coarseStart;
+      coarseStart.first = i;
+      coarseStart.anchor = anchor;
+      derived.starts.push_back(coarseStart);
+   }
+}
+
+void DerivedBars::getBars(const CString& requestGuid, Derived& derived, Bars& bars)
+{
+   const size_t count = static_cast<size_t>(derived.count);
+   derived.offset = derived.bars.size() > count ? derived.bars.size() - count : 0;
+   derived.resolved = true;
+
+   bars.requestGuid = requestGuid;
+   bars.requestedCount = derived.count;
+   bars.bars.assign(derived.bars.begin() + derived.offset, derived.bars.end());
+}
+
+} // namespace cqg
@@ -0,0 +1,151 @@
+/// @file DerivedBars.h
+/// @brief Simple C++ facade for CQG API - timed bars derived from finer base period bars.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "SymbolTable.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace cqg
+{
+
+/// @class IBaseBarsSource
+/// @brief Sends & cancels subscribed base period bars requests for DerivedBars.
+struct IBaseBarsSource
+{
+   /// @brief Sends subscribed base bars request.
+   /// @return Request guid, empty string if request failed.
+   virtual CString RequestBaseBars(const BarsRequest& request, CString& error) = 0;
+
+   /// @brief Cancels base bars request no longer needed.
+   virtual void CancelBaseBars(const CString& requestGuid) = 0;
+
+   virtual ~IBaseBarsSource() {}
+};
+
+/// @class DerivedBars
+/// @brief Subscribed bars of period multiple of base period, see FacadeSettings::baseBarPeriodInMinutes.
+///        Requests of the same symbol & sessions filter share single subscribed base period request,
+///        base request is sent by SendBases(), so requests made together make single base request,
+///        coarse bars are aggregated from its bars & updated incrementally as base bars change.
+///        Coarse bars start at multiples of period since session start. A gap between base bars crossing a day
+///        or lasting an hour at least is taken as session break, shorter gaps are periods without trades
+///        and keep bars alignment. Bars before the first break use the first session start, midnight if there's none.
+class DerivedBars
+{
+public:
+
+   DerivedBars(): m_basePeriod(0), m_guidsCount(0)
+   {}
+
+   /// @brief Sets base period in minutes, zero disables derivation.
+   void SetBasePeriod(const long basePeriod)
+   {
+      m_basePeriod = basePeriod;
+   }
+
+   /// @brief Checks whether request bars can be derived: subscribed request of index range ending
+   ///        at the current bar with period multiple of base period.
+   bool CanDerive(const BarsRequest& request) const;
+
+   /// @brief Attaches request to base request covering it or to new base request to be sent by SendBases().
+   /// @return Derived request guid.
+   CString Request(IBaseBarsSource& source, const BarsRequest& request);
+
+   /// @brief Sends base requests made by Request() since last call.
+   /// @param failed [out] results of derived requests which base request failed.
+   void SendBases(IBaseBarsSource& source, std::vector<Bars>& failed);
+
+   /// @brief Gets bars of request attached to already resolved base request, see Request().
+   /// @return False if request is already resolved, canceled or its base request isn't resolved yet.
+   bool Resolve(const CString& requestGuid, Bars& bars);
+
+   /// @brief Cancels derived request, cancels base request once no requests use it.
+   /// @return False if request is not derived one.
+   bool Cancel(IBaseBarsSource& source, const CString& requestGuid);
+
+   /// @brief Keeps resolved base request bars & resolves requests waiting for them.
+   ///        Failed base request fails all its derived requests.
+   /// @param resolved [out] results of derived requests.
+   /// @return False if bars are not base request ones.
+   bool OnBaseResolved(const Bars& bars, std::vector<Bars>& resolved);
+
+   /// @brief Applies base bars change & derives changes of its requests bars.
+   /// @param updates [out] changes of derived requests bars.
+   /// @return False if change is not base request one.
+   bool OnBaseChanged(const BarsUpdate& update, std::vector<BarsUpdate>& updates);
+
+   /// @brief Gets number of outstanding base requests.
+   size_t GetBaseCount() const
+   {
+      return m_bases.size();
+   }
+
+private:
+
+   /// @brief Start of coarse bar in base bars.
+   struct CoarseStart
+   {
+      size_t first;    ///< Index of the first base bar.
+      double anchor;   ///< Start of session the bar belongs to.
+   };
+
+   /// @brief Derived request state.
+   struct Derived
+   {
+      BarsRequest request;               ///< User request.
+      CString baseGuid;                  ///< Base request guid.
+      double period;                     ///< Bar period in days.
+      long count;                        ///< Number of requested bars.
+      bool resolved;                     ///< True once bars were reported.
+      BarInfos bars;                     ///< All coarse bars of base bars.
+      std::vector<CoarseStart> starts;   ///< Start of each coarse bar.
+      size_t offset;                     ///< Index of the first reported coarse bar.
+   };
+
+   /// @brief Base request state.
+   struct Base
+   {
+      CString key;                    ///< Symbol & sessions filter key.
+      BarsRequest request;            ///< Base request.
+      long count;                     ///< Number of requested base bars.
+      bool sent;                      ///< True once sent to CQGCEL, guid is facade one before.
+      bool resolved;                  ///< True once base bars are received.
+      BarInfos bars;                  ///< Current base bars.
+      std::vector<CString> derived;   ///< Guids of derived requests using it.
+   };
+
+   typedef std::unordered_map<CString, Derived, CStringHash> DerivedMap;
+   typedef std::unordered_map<CString, Base, CStringHash> BasesMap;
+   typedef std::unordered_map<CString, CString, CStringHash> KeysMap;
+
+   /// @brief Makes base request of given number of bars to be sent by SendBases().
+   CString addBase(const BarsRequest& request, long count);
+
+   /// @brief Moves base request & its derived requests to new guid.
+   void renameBase(const CString& baseGuid, const CString& newGuid);
+
+   /// @brief Drops base request & all its derived requests.
+   void removeBase(const CString& baseGuid);
+
+   /// @brief Derives coarse bars from the given one on, previous coarse bars are kept.
+   void derive(Derived& derived, const BarInfos& base, size_t from) const;
+
+   /// @brief Gets reported bars of derived request.
+   static void getBars(const CString& requestGuid, Derived& derived, Bars& bars);
+
+   long m_basePeriod;       ///< Base period in minutes, zero if disabled.
+   unsigned m_guidsCount;   ///< Number of derived & not sent base requests made.
+   DerivedMap m_derived;    ///< Derived requests by guid.
+   BasesMap m_bases;        ///< Base requests by guid.
+   KeysMap m_current;       ///< The latest base request guid by symbol & sessions filter key.
+   std::vector<CString> m_unsent;   ///< Guids of base requests to send.
+};
+
+} // namespace cqg
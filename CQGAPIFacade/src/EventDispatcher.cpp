@@ -0,0 +1,463 @@
+/// @file EventDispatcher.cpp
+/// @brief Simple C++ facade for CQG API - events delivery by worker threads implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "EventDispatcher.h"
+
+#include <algorithm>
+
+namespace cqg
+{
+
+namespace
+{
+
+/// @brief Number of empty queue polls before worker goes to sleep.
+const unsigned SpinsBeforeSleep = 256;
+
+/// @brief Max sleep time, limits latency if wake up is missed.
+const std::chrono::milliseconds MaxSleep(1);
+
+/// @brief Updates atomic maximum.
+template <typename T>
+void UpdateMax(std::atomic<T>& maximum, const T value)
+{
+   T current = maximum.load(std::memory_order_relaxed);
+   while(value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+   {
+   }
+}
+
+} // namespace
+
+EventDispatcher::Worker::Worker(size_t queueSize):
+   events(queueSize),
+   quotes(queueSize),
+   depth(queueSize),
+   sleeping(false),
+   quotesHeld(false),
+   depthHeld(false),
+   posted(0),
+   queued(0),
+   dropped(0),
+   waits(0),
+   maxDepth(0),
+   delivered(0),
+   latencyNs(0),
+   maxLatencyNs(0)
+{}
+
+EventDispatcher::EventDispatcher(IAPIEvents* events, const FacadeSettings& settings):
+   m_events(events),
+   m_settings(settings),
+   m_stopping(false)
+{
+   ATLASSERT(m_events);
+   ATLASSERT(settings.dispatchThreads > 0);
+
+   const unsigned threads = std::max(settings.dispatchThreads, 1u);
+   for(unsigned i = 0; i < threads; ++i)
+   {
+      m_workers.push_back(WorkerPtr(new Worker(settings.dispatchQueueSize)));
+   }
+
+   for(size_t i = 0; i < m_workers.size(); ++i)
+   {
+      m_workers[i]->thread = std::thread(&EventDispatcher::run, this, std::ref(*m_workers[i]));
+   }
+}
+
+EventDispatcher::~EventDispatcher()
+{
+   m_stopping.store(true);
+
+   for(size_t i = 0; i < m_workers.size(); ++i)
+   {
+      Worker& worker = *m_workers[i];
+      {
+         std::lock_guard<std::mutex> lock(worker.wakeLock);
+         worker.wake.notify_one();
+      }
+
+      worker.thread.join();
+   }
+}
+
+void EventDispatcher::GetStats(DispatchStats& stats) const
+{
+   stats = DispatchStats();
+
+   unsigned long long latencyNs = 0;
+   unsigned long long maxLatencyNs = 0;
+
+   for(size_t i = 0; i < m_workers.size(); ++i)
+   {
+      const Worker& worker = *m_workers[i];
+
+      stats.queued += worker.queued.load(std::memory_order_relaxed);
+      stats.delivered += worker.delivered.load(std::memory_order_relaxed);
+      stats.dropped += worker.dropped.load(std::memory_order_relaxed);
+      stats.conflated += worker.conflator.GetMergedCount();
+      stats.waits += worker.waits.load(std::memory_order_relaxed);
+      stats.depth += static_cast<unsigned>(worker.events.Size() + worker.quotes.Size() + worker.depth.Size());
+      stats.maxDepth = std::max(stats.maxDepth, worker.maxDepth.load(std::memory_order_relaxed));
+
+      latencyNs += worker.latencyNs.load(std::memory_order_relaxed);
+      maxLatencyNs = std::max(maxLatencyNs, worker.maxLatencyNs.load(std::memory_order_relaxed));
+   }
+
+   stats.avgLatencyUs = stats.delivered ? latencyNs / 1000.0 / stats.delivered : 0.0;
+   stats.maxLatencyUs = maxLatencyNs / 1000.0;
+}
+
+void EventDispatcher::OnError(const CString& error)
+{
+   postCall(std::bind(&IAPIEvents::OnError, std::placeholders::_1, error));
+}
+
+void EventDispatcher::OnMarketDataConnection(const bool connected)
+{
+   postCall(std::bind(&IAPIEvents::OnMarketDataConnection, std::placeholders::_1, connected));
+}
+
+void EventDispatcher::OnTradingConnection(const bool connected)
+{
+   postCall(std::bind(&IAPIEvents::OnTradingConnection, std::placeholders::_1, connected));
+}
+
+void EventDispatcher::OnSymbolSubscribed(const CString& requestedSymbol, const SymbolInfo& symbol)
+{
+   if(m_settings.overflowPolicy == ConflateOnOverflow)
+   {
+      m_workers[symbol.id % m_workers.size()]->conflator.AddSymbol(symbol.id, symbol.fullName);
+   }
+
+   // Symbol worker delivers subscription before the first symbol quotes.
+   postCall(std::bind(&IAPIEvents::OnSymbolSubscribed, std::placeholders::_1, requestedSymbol, symbol),
+      symbol.id % m_workers.size());
+}
+
+void EventDispatcher::OnSymbolError(const CString& symbol)
+{
+   postCall(std::bind(&IAPIEvents::OnSymbolError, std::placeholders::_1, symbol));
+}
+
+void EventDispatcher::OnSymbolsBatchCompleted(const SymbolsBatch& batch)
+{
+   postCall(std::bind(&IAPIEvents::OnSymbolsBatchCompleted, std::placeholders::_1, batch));
+}
+
+void EventDispatcher::OnSymbolQuote(const SymbolInfo& symbol)
+{
+   Worker& worker = *m_workers[symbol.id % m_workers.size()];
+
+   if(m_settings.overflowPolicy == ConflateOnOverflow)
+   {
+      QuoteEvent quotes;
+      quotes.symbolId = symbol.id;
+      quotes.count = 0;
+      quotes.changedMask = 0;
+
+      for(size_t i = 0; i < symbol.lastQuotes.size() && quotes.count < QuoteEvent::MaxQuotes; ++i)
+      {
+         quotes.quotes[quotes.count++] = symbol.lastQuotes[i];
+         quotes.changedMask |= QuoteEvent::TypeMask(symbol.lastQuotes[i].type);
+      }
+
+      postQuotes(quotes);
+      return;
+   }
+
+   Event event;
+   event.type = Event::CallEvent;
+   event.call = std::bind(&IAPIEvents::OnSymbolQuote, std::placeholders::_1, symbol);
+   post(worker, worker.quotes, event, m_settings.overflowPolicy);
+}
+
+void EventDispatcher::OnQuoteEvent(const QuoteEvent& quotes)
+{
+   postQuotes(quotes);
+}
+
+void EventDispatcher::OnQuotesPending()
+{
+   postCall(std::bind(&IAPIEvents::OnQuotesPending, std::placeholders::_1));
+}
+
+void EventDispatcher::OnDepthUpdate(const DepthUpdate& update)
+{
+   // Depth updates are never dropped or conflated, otherwise listener's copy of the book breaks,
+   // so they have own queue dropping quote updates never touches.
+   Worker& worker = *m_workers[update.symbolId % m_workers.size()];
+
+   Event event;
+   event.type = Event::CallEvent;
+   event.call = std::bind(&IAPIEvents::OnDepthUpdate, std::placeholders::_1, update);
+   post(worker, worker.depth, event, BlockOnOverflow);
+}
+
+void EventDispatcher::OnAccountsReloaded()
+{
+   postCall(std::bind(&IAPIEvents::OnAccountsReloaded, std::placeholders::_1));
+}
+
+void EventDispatcher::OnPositionsReloaded()
+{
+   postCall(std::bind(&IAPIEvents::OnPositionsReloaded, std::placeholders::_1));
+}
+
+void EventDispatcher::OnAccountChanged(const AccountInfo& account)
+{
+   postCall(std::bind(&IAPIEvents::OnAccountChanged, std::placeholders::_1, account));
+}
+
+void EventDispatcher::OnPositionChanged(const AccountInfo& account, const PositionInfo& position, const bool newPosition)
+{
+   postCall(std::bind(&IAPIEvents::OnPositionChanged, std::placeholders::_1, account, position, newPosition));
+}
+
+void EventDispatcher::OnOrderChanged(const OrderInfo& order)
+{
+   postCall(std::bind(&IAPIEvents::OnOrderChanged, std::placeholders::_1, order));
+}
+
+void EventDispatcher::OnFill(const FillEvent& fill)
+{
+   postCall(std::bind(&IAPIEvents::OnFill, std::placeholders::_1, fill));
+}
+
+void EventDispatcher::OnOrderState(const OrderStateEvent& state)
+{
+   postCall(std::bind(&IAPIEvents::OnOrderState, std::placeholders::_1, state));
+}
+
+void EventDispatcher::OnBarsReceived(const Bars& bars)
+{
+   postCall(std::bind(&IAPIEvents::OnBarsReceived, std::placeholders::_1, bars));
+}
+
+void EventDispatcher::OnBarsUpdated(const BarsUpdate& update)
+{
+   postCall(std::bind(&IAPIEvents::OnBarsUpdated, std::placeholders::_1, update));
+}
+
+void EventDispatcher::OnTradeBarClosed(const CString& requestGuid, const BarInfo& bar)
+{
+   postCall(std::bind(&IAPIEvents::OnTradeBarClosed, std::placeholders::_1, requestGuid, bar));
+}
+
+void EventDispatcher::postCall(const Call& call, size_t worker)
+{
+   Event event;
+   event.type = Event::CallEvent;
+   event.call = call;
+
+   // Only quote updates may be dropped or conflated.
+   Worker& target = *m_workers[worker];
+   post(target, target.events, event, BlockOnOverflow);
+}
+
+void EventDispatcher::postQuotes(const QuoteEvent& quotes)
+{
+   Worker& worker = *m_workers[quotes.symbolId % m_workers.size()];
+
+   Event event;
+
+   if(m_settings.overflowPolicy == ConflateOnOverflow)
+   {
+      if(!worker.conflator.Push(quotes))
+      {
+         // Already pending, will be delivered by queued conflated event.
+         return;
+      }
+
+      event.type = Event::ConflatedEvent;
+      post(worker, worker.quotes, event, BlockOnOverflow);
+      return;
+   }
+
+   event.type = Event::QuotesEvent;
+   event.quotes = quotes;
+   post(worker, worker.quotes, event, m_settings.overflowPolicy);
+}
+
+void EventDispatcher::post(Worker& worker, EventQueue& queue, Event& event, OverflowPolicy policy)
+{
+   event.queued = Clock::now();
+   event.sequence = worker.posted++;
+
+   if(!queue.TryPush(event))
+   {
+      if(policy == DropOldestOnOverflow)
+      {
+         Event oldest;
+         do
+         {
+            if(queue.TryPop(oldest))
+            {
+               worker.dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+         }
+         while(!queue.TryPush(event));
+      }
+      else
+      {
+         worker.waits.fetch_add(1, std::memory_order_relaxed);
+         do
+         {
+            std::this_thread::yield();
+         }
+         while(!queue.TryPush(event));
+      }
+   }
+
+   worker.queued.fetch_add(1, std::memory_order_relaxed);
+   UpdateMax(worker.maxDepth, static_cast<unsigned>(queue.Size()));
+
+   if(worker.sleeping.load())
+   {
+      std::lock_guard<std::mutex> lock(worker.wakeLock);
+      worker.wake.notify_one();
+   }
+}
+
+bool EventDispatcher::popUpdate(Worker& worker, Event& event)
+{
+   if(!worker.quotesHeld) worker.quotesHeld = worker.quotes.TryPop(worker.heldQuotes);
+   if(!worker.depthHeld) worker.depthHeld = worker.depth.TryPop(worker.heldDepth);
+
+   // Update popped from one queue might be posted after the other queue was checked.
+   // Updates posted before popped one are visible by now, so the other queue is checked once more.
+   if(worker.depthHeld && !worker.quotesHeld)
+   {
+      worker.quotesHeld = worker.quotes.TryPop(worker.heldQuotes);
+   }
+   else if(worker.quotesHeld && !worker.depthHeld)
+   {
+      worker.depthHeld = worker.depth.TryPop(worker.heldDepth);
+   }
+
+   if(worker.depthHeld && (!worker.quotesHeld || worker.heldDepth.sequence < worker.heldQuotes.sequence))
+   {
+      event = std::move(worker.heldDepth);
+      worker.heldDepth.call = Call();
+      worker.depthHeld = false;
+      return true;
+   }
+
+   if(worker.quotesHeld)
+   {
+      event = std::move(worker.heldQuotes);
+      worker.heldQuotes.call = Call();
+      worker.quotesHeld = false;
+      return true;
+   }
+
+   return false;
+}
+
+void EventDispatcher::run(Worker& worker)
+{
+   Event event;
+   unsigned spins = 0;
+
+   for(;;)
+   {
+      // Read stop flag before pop, so events queued before stop are never left behind.
+      const bool stopping = m_stopping.load();
+
+      if(worker.events.TryPop(event))
+      {
+         deliver(worker, event);
+         spins = 0;
+         continue;
+      }
+
+      if(popUpdate(worker, event))
+      {
+         // Events queued before this quote update might be queued after events queue was checked,
+         // they must be delivered first, e.g. symbol subscription before its first quote.
+         Event previous;
+         while(worker.events.TryPop(previous))
+         {
+            deliver(worker, previous);
+         }
+
+         deliver(worker, event);
+         spins = 0;
+         continue;
+      }
+
+      if(stopping)
+      {
+         break;
+      }
+
+      if(++spins < SpinsBeforeSleep)
+      {
+         std::this_thread::yield();
+         continue;
+      }
+
+      worker.sleeping.store(true);
+      if(worker.events.Size() == 0 && worker.quotes.Size() == 0 && worker.depth.Size() == 0 && !m_stopping.load())
+      {
+         std::unique_lock<std::mutex> lock(worker.wakeLock);
+         worker.wake.wait_for(lock, MaxSleep);
+      }
+      worker.sleeping.store(false);
+   }
+}
+
+void EventDispatcher::deliver(Worker& worker, Event& event)
+{
+   const unsigned long long latencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now() - event.queued).count();
+
+   worker.latencyNs.fetch_add(latencyNs, std::memory_order_relaxed);
+   UpdateMax(worker.maxLatencyNs, latencyNs);
+
+   switch(event.type)
+   {
+   case Event::CallEvent:
+      event.call(*m_events);
+      event.call = Call();
+      break;
+
+   case Event::QuotesEvent:
+      m_events->OnQuoteEvent(event.quotes);
+      break;
+
+   case Event::ConflatedEvent:
+      worker.conflator.Take(worker.drained, static_cast<size_t>(-1));
+      for(size_t i = 0; i < worker.drained.size(); ++i)
+      {
+         deliverQuotes(worker, worker.drained[i]);
+      }
+      break;
+   }
+
+   worker.delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventDispatcher::deliverQuotes(Worker& worker, const QuoteEvent& quotes)
+{
+   if(m_settings.quoteEvents)
+   {
+      m_events->OnQuoteEvent(quotes);
+      return;
+   }
+
+   SymbolInfo symInfo;
+   symInfo.id = quotes.symbolId;
+   symInfo.fullName = worker.conflator.GetName(quotes.symbolId);
+   symInfo.lastQuotes.assign(quotes.quotes, quotes.quotes + quotes.count);
+
+   m_events->OnSymbolQuote(symInfo);
+}
+
+} // namespace cqg
@@ -0,0 +1,169 @@
+/// @file EventDispatcher.h
+/// @brief Simple C++ facade for CQG API - events delivery by worker threads.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "BoundedQueue.h"
+#include "QuoteConflator.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cqg
+{
+
+/// @class EventDispatcher
+/// @brief Events listener which queues events and delivers them to user listener by worker threads.
+///        Symbol quotes & subscription go to worker selected by symbol identifier, all other events go to
+///        the first worker, so events order is kept per symbol and for all other events. Other events have separate queue,
+///        they are never dropped or conflated and are delivered ahead of already queued quote updates.
+///        Market depth updates have separate queue too, so they are never dropped, and are delivered
+///        in order they were posted with quote updates of the same worker.
+/// @note Every IAPIEvents method must be queued here, otherwise the event is lost in dispatch mode.
+class EventDispatcher: public IAPIEvents
+{
+public:
+
+   /// @brief Starts worker threads.
+   /// @param events [in] user events listener.
+   /// @param settings [in] dispatch settings, dispatchThreads must be non zero.
+   EventDispatcher(IAPIEvents* events, const FacadeSettings& settings);
+
+   /// @brief Delivers all queued events & stops workers.
+   ~EventDispatcher();
+
+   /// @brief Gets dispatch counters.
+   void GetStats(DispatchStats& stats) const;
+
+   /// @name IAPIEvents implementation, called from CQGCEL thread.
+   /// @{
+
+   virtual void OnError(const CString& error);
+   virtual void OnMarketDataConnection(const bool connected);
+   virtual void OnTradingConnection(const bool connected);
+   virtual void OnSymbolSubscribed(const CString& requestedSymbol, const SymbolInfo& symbol);
+   virtual void OnSymbolError(const CString& symbol);
+   virtual void OnSymbolsBatchCompleted(const SymbolsBatch& batch);
+   virtual void OnSymbolQuote(const SymbolInfo& symbol);
+   virtual void OnQuoteEvent(const QuoteEvent& quotes);
+   virtual void OnQuotesPending();
+   virtual void OnDepthUpdate(const DepthUpdate& update);
+   virtual void OnAccountsReloaded();
+   virtual void OnPositionsReloaded();
+   virtual void OnAccountChanged(const AccountInfo& account);
+   virtual void OnPositionChanged(const AccountInfo& account, const PositionInfo& position, const bool newPosition);
+   virtual void OnOrderChanged(const OrderInfo& order);
+   virtual void OnFill(const FillEvent& fill);
+   virtual void OnOrderState(const OrderStateEvent& state);
+   virtual void OnBarsReceived(const Bars& bars);
+   virtual void OnBarsUpdated(const BarsUpdate& update);
+   virtual void OnTradeBarClosed(const CString& requestGuid, const BarInfo& bar);
+
+   /// @}
+
+private:
+
+   typedef std::chrono::steady_clock Clock;
+   typedef std::function<void(IAPIEvents&)> Call;
+
+   /// @brief Queued event.
+   struct Event
+   {
+      enum Type
+      {
+         CallEvent,        ///< Generic event, call is set.
+         QuotesEvent,      ///< Quote update, quotes are set.
+         ConflatedEvent    ///< Worker shall deliver pending conflated quote updates.
+      };
+
+      Type type;
+      unsigned long long sequence;   ///< Post order of events of the worker.
+      QuoteEvent quotes;
+      Call call;
+      Clock::time_point queued;
+   };
+
+   typedef BoundedQueue<Event> EventQueue;
+
+   /// @brief Worker thread state.
+   struct Worker
+   {
+      explicit Worker(size_t queueSize);
+
+      EventQueue events;                ///< Queue of all events but quote updates.
+      EventQueue quotes;                ///< Queue of quote updates, overflow policy applies to it.
+      EventQueue depth;                 ///< Queue of market depth updates, never dropped.
+      QuoteConflator conflator;         ///< Pending quote updates, ConflateOnOverflow policy only.
+      std::vector<QuoteEvent> drained;  ///< Conflated quote updates being delivered.
+      std::thread thread;               ///< Worker thread.
+
+      std::mutex wakeLock;              ///< Guards wake condition.
+      std::condition_variable wake;     ///< Signaled when events are queued to sleeping worker.
+      std::atomic<bool> sleeping;       ///< True if worker waits for wake condition.
+
+      // Written by worker thread only.
+      Event heldQuotes;                 ///< Quote update popped but not delivered yet.
+      Event heldDepth;                  ///< Depth update popped but not delivered yet.
+      bool quotesHeld;                  ///< True if heldQuotes is set.
+      bool depthHeld;                   ///< True if heldDepth is set.
+
+      // Written by CQGCEL thread.
+      unsigned long long posted;        ///< Sequence of the next posted event.
+      std::atomic<unsigned long long> queued;
+      std::atomic<unsigned long long> dropped;
+      std::atomic<unsigned long long> waits;
+      std::atomic<unsigned> maxDepth;
+
+      // Written by worker thread.
+      std::atomic<unsigned long long> delivered;
+      std::atomic<unsigned long long> latencyNs;
+      std::atomic<unsigned long long> maxLatencyNs;
+   };
+
+   typedef std::unique_ptr<Worker> WorkerPtr;
+
+   EventDispatcher(const EventDispatcher&);
+   EventDispatcher& operator=(const EventDispatcher&);
+
+   /// @brief Queues generic event to worker, the first one by default.
+   void postCall(const Call& call, size_t worker = 0);
+
+   /// @brief Queues symbol quote update to its worker.
+   void postQuotes(const QuoteEvent& quotes);
+
+   /// @brief Queues event according to overflow policy.
+   void post(Worker& worker, EventQueue& queue, Event& event, OverflowPolicy policy);
+
+   /// @brief Pops the earliest posted quote or depth update of worker.
+   /// @return False if there are no updates.
+   bool popUpdate(Worker& worker, Event& event);
+
+   /// @brief Worker thread procedure.
+   void run(Worker& worker);
+
+   /// @brief Delivers single event to user listener.
+   void deliver(Worker& worker, Event& event);
+
+   /// @brief Delivers conflated quote update via OnQuoteEvent() or OnSymbolQuote(), as configured.
+   void deliverQuotes(Worker& worker, const QuoteEvent& quotes);
+
+   IAPIEvents* m_events;              ///< User events listener.
+   FacadeSettings m_settings;         ///< Dispatch settings.
+   std::vector<WorkerPtr> m_workers;  ///< Workers.
+   std::atomic<bool> m_stopping;      ///< True if workers shall exit once queues are empty.
+};
+
+/// @brief Smart pointer holding events dispatcher.
+typedef std::auto_ptr<EventDispatcher> EventDispatcherPtr;
+
+} // namespace cqg
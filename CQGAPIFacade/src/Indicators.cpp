@@ -0,0 +1,534 @@
+/// @file Indicators.cpp
+/// @brief Simple C++ facade for CQG API - streaming technical indicators implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "CQGIndicators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CQGAPIFACADE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace cqg
+{
+
+namespace
+{
+
+/// @brief Calculates sum & sum of squares of values.
+void GetSums(const double* values, size_t count, double& sum, double& sumSquares)
+{
+   size_t i = 0;
+   sum = sumSquares = 0.0;
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   __m128d sums = _mm_setzero_pd();
+   __m128d squares = _mm_setzero_pd();
+
+   for(; i + 2 <= count; i += 2)
+   {
+      const __m128d value = _mm_loadu_pd(values + i);
+      sums = _mm_add_pd(sums, value);
+      squares = _mm_add_pd(squares, _mm_mul_pd(value, value));
+   }
+
+   double lanes[2];
+   _mm_storeu_pd(lanes, sums);
+   sum = lanes[0] + lanes[1];
+   _mm_storeu_pd(lanes, squares);
+   sumSquares = lanes[0] + lanes[1];
+#endif
+
+   for(; i < count; ++i)
+   {
+      sum += values[i];
+      sumSquares += values[i] * values[i];
+   }
+}
+
+/// @brief Calculates sum of values[i] * decay ^ (count - 1 - i), the last value has weight 1.
+///        Vectorized Horner scheme: two lanes take odd & even values with decay ^ 2,
+///        odd count puts the first value to the second lane, so it ends with the last value.
+double GetDecayedSum(const double* values, size_t count, double decay)
+{
+   if(!count)
+   {
+      return 0.0;
+   }
+
+   size_t i = 0;
+   double sum = 0.0;
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   const __m128d decay2 = _mm_set1_pd(decay * decay);
+   __m128d sums = _mm_setzero_pd();
+
+   if(count % 2)
+   {
+      sums = _mm_set_pd(values[0], 0.0);
+      i = 1;
+   }
+
+   for(; i + 2 <= count; i += 2)
+   {
+      sums = _mm_add_pd(_mm_mul_pd(sums, decay2), _mm_loadu_pd(values + i));
+   }
+
+   double lanes[2];
+   _mm_storeu_pd(lanes, sums);
+   sum = lanes[0] * decay + lanes[1];
+#endif
+
+   for(; i < count; ++i)
+   {
+      sum = sum * decay + values[i];
+   }
+
+   return sum;
+}
+
+/// @brief Gets number of the latest values which define exponential average:
+///        older values have weights below double precision.
+size_t GetHistoryLength(double alpha)
+{
+   const double decay = 1.0 - alpha;
+   if(!(decay > 0.0))
+   {
+      return 1;
+   }
+
+   const double length = std::log(std::numeric_limits<double>::epsilon() * 0.5) / std::log(decay);
+   return static_cast<size_t>(std::ceil(length)) + 1;
+}
+
+/// @brief Calculates exponential average seeded by the first value.
+/// @param history [in] see GetHistoryLength(), only that many of the latest values are used
+///        if there are more values.
+double GetExponentialAverage(const double* values, size_t count, double alpha, size_t history)
+{
+   const double decay = 1.0 - alpha;
+
+   if(count > history)
+   {
+      return alpha * GetDecayedSum(values + count - history, history, decay);
+   }
+
+   if(!count)
+   {
+      return 0.0;
+   }
+
+   return std::pow(decay, static_cast<double>(count - 1)) * values[0] +
+      alpha * GetDecayedSum(values + 1, count - 1, decay);
+}
+
+/// @brief Checks whether bar has trades.
+bool HasTrades(const BarInfo& bar)
+{
+   return bar.close != InvalidPrice && bar.high != InvalidPrice && bar.low != InvalidPrice;
+}
+
+} // namespace
+
+RollingWindow::RollingWindow(size_t period):
+   m_values(std::max<size_t>(period, 1), 0.0),
+   m_next(0),
+   m_count(0),
+   m_updates(0),
+   m_sum(0.0),
+   m_sumSquares(0.0)
+{
+}
+
+void RollingWindow::Init(const double* values, size_t count)
+{
+   const size_t period = m_values.size();
+
+   // Value i of all values is kept at i % period like added one by one.
+   for(size_t i = count > period ? count - period : 0; i < count; ++i)
+   {
+      m_values[i % period] = values[i];
+   }
+
+   m_count = count;
+   m_next = count % period;
+   recalculate();
+}
+
+void RollingWindow::Add(double value)
+{
+   double& slot = m_values[m_next];
+
+   if(m_count >= m_values.size())
+   {
+      m_sum -= slot;
+      m_sumSquares -= slot * slot;
+   }
+
+   slot = value;
+   m_sum += value;
+   m_sumSquares += value * value;
+
+   m_next = (m_next + 1) % m_values.size();
+   ++m_count;
+
+   if(++m_updates >= m_values.size())
+   {
+      recalculate();
+   }
+}
+
+void RollingWindow::ReplaceLast(double value)
+{
+   if(!m_count)
+   {
+      Add(value);
+      return;
+   }
+
+   double& slot = m_values[(m_next + m_values.size() - 1) % m_values.size()];
+
+   m_sum += value - slot;
+   m_sumSquares += value * value - slot * slot;
+   slot = value;
+
+   if(++m_updates >= m_values.size())
+   {
+      recalculate();
+   }
+}
+
+void RollingWindow::Clear()
+{
+   m_next = 0;
+   m_count = 0;
+   m_updates = 0;
+   m_sum = 0.0;
+   m_sumSquares = 0.0;
+}
+
+void RollingWindow::recalculate()
+{
+   m_updates = 0;
+   GetSums(&m_values[0], Size(), m_sum, m_sumSquares);
+}
+
+void SMA::Init(const double* values, size_t count)
+{
+   m_window.Init(values, count);
+   m_lastValue = count > 0 ? values[count - 1] : 0.0;
+   m_previousValue = count > 1 ? values[count - 2] : m_lastValue;
+}
+
+void SMA::Add(double value)
+{
+   m_previousValue = m_window.Count() ? m_lastValue : value;
+   m_lastValue = value;
+   m_window.Add(value);
+}
+
+void SMA::ReplaceLast(double value)
+{
+   if(!m_window.Count())
+   {
+      Add(value);
+      return;
+   }
+
+   m_lastValue = value;
+   m_window.ReplaceLast(value);
+}
+
+double SMA::Value() const
+{
+   const size_t size = m_window.Size();
+   return size ? m_window.Sum() / size : 0.0;
+}
+
+EMA::EMA(size_t period):
+   m_period(std::max<size_t>(period, 1)),
+   m_alpha(2.0 / (m_period + 1)),
+   m_count(0),
+   m_value(0.0),
+   m_previous(0.0),
+   m_lastValue(0.0),
+   m_previousValue(0.0)
+{
+}
+
+void EMA::Init(const double* values, size_t count)
+{
+   m_count = 0;
+   m_value = m_previous = m_lastValue = m_previousValue = 0.0;
+
+   if(!count)
+   {
+      return;
+   }
+
+   // The last value is added as usual, so it can be replaced later.
+   if(count > 1)
+   {
+      m_value = GetExponentialAverage(values, count - 1, m_alpha, GetHistoryLength(m_alpha));
+      m_lastValue = values[count - 2];
+      m_count = count - 1;
+   }
+
+   Add(values[count - 1]);
+}
+
+void EMA::Add(double value)
+{
+   m_previous = m_value;
+   m_previousValue = m_count ? m_lastValue : value;
+   m_lastValue = value;
+   m_value = m_count ? m_value + m_alpha * (value - m_value) : value;
+   ++m_count;
+}
+
+void EMA::ReplaceLast(double value)
+{
+   if(!m_count)
+   {
+      Add(value);
+      return;
+   }
+
+   m_lastValue = value;
+   m_value = m_count > 1 ? m_previous + m_alpha * (value - m_previous) : value;
+}
+
+double BollingerBands::Deviation() const
+{
+   const RollingWindow& window = m_average.Window();
+
+   const size_t size = window.Size();
+   if(!size)
+   {
+      return 0.0;
+   }
+
+   const double mean = window.Sum() / size;
+   return std::sqrt(std::max(0.0, window.SumSquares() / size - mean * mean));
+}
+
+ATR::ATR(size_t period):
+   m_period(std::max<size_t>(period, 1)),
+   m_alpha(1.0 / m_period),
+   m_count(0),
+   m_value(0.0),
+   m_previous(0.0),
+   m_lastClose(0.0),
+   m_previousClose(0.0)
+{
+}
+
+void ATR::Init(const BarColumns& bars)
+{
+   m_count = 0;
+   m_value = m_previous = m_lastClose = m_previousClose = 0.0;
+
+   const size_t count = bars.Size();
+   if(!count)
+   {
+      return;
+   }
+
+   const Price* highs = bars.High();
+   const Price* lows = bars.Low();
+   const Price* closes = bars.Close();
+
+   // True ranges of bars before the last one, only the latest ones define average.
+   if(count > 1)
+   {
+      const size_t history = GetHistoryLength(m_alpha);
+      const size_t prefix = count - 1;
+      const size_t first = prefix > history ? prefix - history - 1 : 0;
+
+      std::vector<double> trueRanges(prefix - first);
+      size_t i = first;
+
+      if(!i)
+      {
+         trueRanges[0] = highs[0] - lows[0];
+         i = 1;
+      }
+
+#ifdef CQGAPIFACADE_USE_SSE2
+      for(; i + 2 <= prefix; i += 2)
+      {
+         const __m128d previous = _mm_loadu_pd(closes + i - 1);
+         const __m128d high = _mm_max_pd(_mm_loadu_pd(highs + i), previous);
+         const __m128d low = _mm_min_pd(_mm_loadu_pd(lows + i), previous);
+         _mm_storeu_pd(&trueRanges[i - first], _mm_sub_pd(high, low));
+      }
+#endif
+
+      for(; i < prefix; ++i)
+      {
+         trueRanges[i - first] = std::max(highs[i], closes[i - 1]) - std::min(lows[i], closes[i - 1]);
+      }
+
+      m_value = GetExponentialAverage(&trueRanges[0], trueRanges.size(), m_alpha, history);
+      m_lastClose = closes[prefix - 1];
+      m_count = prefix;
+   }
+
+   BarInfo last;
+   last.open = bars.Open()[count - 1];
+   last.high = highs[count - 1];
+   last.low = lows[count - 1];
+   last.close = closes[count - 1];
+   last.volume = static_cast<Volume>(bars.Volumes()[count - 1]);
+   Add(last);
+}
+
+void ATR::Add(const BarInfo& bar)
+{
+   const double trueRange = getTrueRange(bar, m_count ? m_lastClose : bar.close);
+
+   m_previous = m_value;
+   m_previousClose = m_lastClose;
+   if(HasTrades(bar))
+   {
+      m_lastClose = bar.close;
+   }
+
+   m_value = m_count ? m_value + m_alpha * (trueRange - m_value) : trueRange;
+   ++m_count;
+}
+
+void ATR::ReplaceLast(const BarInfo& bar)
+{
+   if(!m_count)
+   {
+      Add(bar);
+      return;
+   }
+
+   const double trueRange = getTrueRange(bar, m_count > 1 ? m_previousClose : bar.close);
+
+   m_lastClose = HasTrades(bar) ? bar.close : m_previousClose;
+   m_value = m_count > 1 ? m_previous + m_alpha * (trueRange - m_previous) : trueRange;
+}
+
+double ATR::getTrueRange(const BarInfo& bar, double previousClose) const
+{
+   if(!HasTrades(bar))
+   {
+      return 0.0;
+   }
+
+   return std::max(bar.high, previousClose) - std::min(bar.low, previousClose);
+}
+
+void VWAP::Reset()
+{
+   m_count = 0;
+   m_priceVolume = 0.0;
+   m_volume = 0.0;
+   m_lastPriceVolume = 0.0;
+   m_lastVolume = 0.0;
+}
+
+void VWAP::Init(const BarColumns& bars)
+{
+   Reset();
+
+   const size_t count = bars.Size();
+   if(!count)
+   {
+      return;
+   }
+
+   const Price* highs = bars.High();
+   const Price* lows = bars.Low();
+   const Price* closes = bars.Close();
+   const double* volumes = bars.Volumes();
+
+   size_t i = 0;
+   double priceVolume = 0.0;
+   double volume = 0.0;
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   __m128d priceVolumes = _mm_setzero_pd();
+   __m128d sumVolumes = _mm_setzero_pd();
+
+   for(; i + 2 <= count; i += 2)
+   {
+      const __m128d price = _mm_add_pd(_mm_add_pd(_mm_loadu_pd(highs + i), _mm_loadu_pd(lows + i)),
+                                       _mm_loadu_pd(closes + i));
+      const __m128d barVolume = _mm_loadu_pd(volumes + i);
+      priceVolumes = _mm_add_pd(priceVolumes, _mm_mul_pd(price, barVolume));
+      sumVolumes = _mm_add_pd(sumVolumes, barVolume);
+   }
+
+   double lanes[2];
+   _mm_storeu_pd(lanes, priceVolumes);
+   priceVolume = lanes[0] + lanes[1];
+   _mm_storeu_pd(lanes, sumVolumes);
+   volume = lanes[0] + lanes[1];
+#endif
+
+   for(; i < count; ++i)
+   {
+      priceVolume += (highs[i] + lows[i] + closes[i]) * volumes[i];
+      volume += volumes[i];
+   }
+
+   m_count = count;
+   m_priceVolume = priceVolume / 3.0;
+   m_volume = volume;
+   m_lastVolume = volumes[count - 1];
+   m_lastPriceVolume = (highs[count - 1] + lows[count - 1] + closes[count - 1]) / 3.0 * m_lastVolume;
+}
+
+void VWAP::Add(const BarInfo& bar)
+{
+   m_lastVolume = HasTrades(bar) ? static_cast<double>(bar.volume) : 0.0;
+   m_lastPriceVolume = m_lastVolume > 0.0 ? (bar.high + bar.low + bar.close) / 3.0 * m_lastVolume : 0.0;
+
+   m_priceVolume += m_lastPriceVolume;
+   m_volume += m_lastVolume;
+   ++m_count;
+}
+
+void VWAP::ReplaceLast(const BarInfo& bar)
+{
+   if(!m_count)
+   {
+      Add(bar);
+      return;
+   }
+
+   m_priceVolume -= m_lastPriceVolume;
+   m_volume -= m_lastVolume;
+   --m_count;
+
+   Add(bar);
+}
+
+void VWAP::AddTrade(Price price, Volume volume)
+{
+   if(price == InvalidPrice || volume <= 0)
+   {
+      return;
+   }
+
+   m_lastVolume = static_cast<double>(volume);
+   m_lastPriceVolume = price * m_lastVolume;
+
+   m_priceVolume += m_lastPriceVolume;
+   m_volume += m_lastVolume;
+   ++m_count;
+}
+
+} // namespace cqg
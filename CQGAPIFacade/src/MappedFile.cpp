@@ -0,0 +1,274 @@
+/// @file MappedFile.cpp
+/// @brief Simple C++ facade for CQG API - memory mapped file implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cqg
+{
+
+namespace
+{
+
+/// @brief Gets description of the last system error.
+CString GetSystemError(const char* operation, const CString& path)
+{
+   CString error;
+#ifdef _WIN32
+   error.Format("%s '%s' failed, error %u", operation, path.GetString(), static_cast<unsigned>(::GetLastError()));
+#else
+   error.Format("%s '%s' failed: %s", operation, path.GetString(), std::strerror(errno));
+#endif
+   return error;
+}
+
+} // namespace
+
+#ifdef _WIN32
+
+MappedFile::MappedFile():
+   m_file(INVALID_HANDLE_VALUE),
+   m_mapping(NULL),
+   m_data(NULL),
+   m_size(0)
+{}
+
+bool MappedFile::Open(const CString& path, CString& error)
+{
+   Close();
+
+   m_file = ::CreateFileA(path.GetString(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+      OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+   if(m_file == INVALID_HANDLE_VALUE)
+   {
+      error = GetSystemError("Opening", path);
+      return false;
+   }
+
+   LARGE_INTEGER size;
+   if(!::GetFileSizeEx(m_file, &size))
+   {
+      error = GetSystemError("Getting size of", path);
+      Close();
+      return false;
+   }
+
+   m_size = static_cast<size_t>(size.QuadPart);
+   return map(error);
+}
+
+bool MappedFile::Resize(size_t size, CString& error)
+{
+   ATLASSERT(IsOpen());
+
+   unmap();
+
+   LARGE_INTEGER position;
+   position.QuadPart = static_cast<LONGLONG>(size);
+   if(!::SetFilePointerEx(m_file, position, NULL, FILE_BEGIN) || !::SetEndOfFile(m_file))
+   {
+      error = GetSystemError("Resizing", CString("bar cache file"));
+      Close();
+      return false;
+   }
+
+   m_size = size;
+   return map(error);
+}
+
+void MappedFile::Close()
+{
+   unmap();
+
+   if(m_file != INVALID_HANDLE_VALUE)
+   {
+      ::CloseHandle(m_file);
+      m_file = INVALID_HANDLE_VALUE;
+   }
+
+   m_size = 0;
+}
+
+bool MappedFile::IsOpen() const
+{
+   return m_file != INVALID_HANDLE_VALUE;
+}
+
+bool MappedFile::MakeDirectory(const CString& path, CString& error)
+{
+   if(!::CreateDirectoryA(path.GetString(), NULL) && ::GetLastError() != ERROR_ALREADY_EXISTS)
+   {
+      error = GetSystemError("Creating directory", path);
+      return false;
+   }
+
+   return true;
+}
+
+bool MappedFile::map(CString& error)
+{
+   // Empty file can't be mapped.
+   if(!m_size)
+   {
+      return true;
+   }
+
+   m_mapping = ::CreateFileMappingA(m_file, NULL, PAGE_READWRITE, 0, 0, NULL);
+   if(!m_mapping)
+   {
+      error = GetSystemError("Mapping", CString("bar cache file"));
+      Close();
+      return false;
+   }
+
+   m_data = static_cast<char*>(::MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, m_size));
+   if(!m_data)
+   {
+      error = GetSystemError("Mapping view of", CString("bar cache file"));
+      Close();
+      return false;
+   }
+
+   return true;
+}
+
+void MappedFile::unmap()
+{
+   if(m_data)
+   {
+      ::FlushViewOfFile(m_data, 0);
+      ::UnmapViewOfFile(m_data);
+      m_data = NULL;
+   }
+
+   if(m_mapping)
+   {
+      ::CloseHandle(m_mapping);
+      m_mapping = NULL;
+   }
+}
+
+#else // _WIN32
+
+MappedFile::MappedFile():
+   m_file(-1),
+   m_data(NULL),
+   m_size(0)
+{}
+
+bool MappedFile::Open(const CString& path, CString& error)
+{
+   Close();
+
+   m_file = ::open(path.GetString(), O_RDWR | O_CREAT, 0644);
+   if(m_file < 0)
+   {
+      error = GetSystemError("Opening", path);
+      return false;
+   }
+
+   struct stat status;
+   if(::fstat(m_file, &status) != 0)
+   {
+      error = GetSystemError("Getting size of", path);
+      Close();
+      return false;
+   }
+
+   m_size = static_cast<size_t>(status.st_size);
+   return map(error);
+}
+
+bool MappedFile::Resize(size_t size, CString& error)
+{
+   ATLASSERT(IsOpen());
+
+   unmap();
+
+   if(::ftruncate(m_file, static_cast<off_t>(size)) != 0)
+   {
+      error = GetSystemError("Resizing", CString("bar cache file"));
+      Close();
+      return false;
+   }
+
+   m_size = size;
+   return map(error);
+}
+
+void MappedFile::Close()
+{
+   unmap();
+
+   if(m_file >= 0)
+   {
+      ::close(m_file);
+      m_file = -1;
+   }
+
+   m_size = 0;
+}
+
+bool MappedFile::IsOpen() const
+{
+   return m_file >= 0;
+}
+
+bool MappedFile::MakeDirectory(const CString& path, CString& error)
+{
+   if(::mkdir(path.GetString(), 0755) != 0 && errno != EEXIST)
+   {
+      error = GetSystemError("Creating directory", path);
+      return false;
+   }
+
+   return true;
+}
+
+bool MappedFile::map(CString& error)
+{
+   // Empty file can't be mapped.
+   if(!m_size)
+   {
+      return true;
+   }
+
+   void* data = ::mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+   if(data == MAP_FAILED)
+   {
+      error = GetSystemError("Mapping", CString("bar cache file"));
+      Close();
+      return false;
+   }
+
+   m_data = static_cast<char*>(data);
+   return true;
+}
+
+void MappedFile::unmap()
+{
+   if(m_data)
+   {
+      ::munmap(m_data, m_size);
+      m_data = NULL;
+   }
+}
+
+#endif // _WIN32
+
+} // namespace cqg
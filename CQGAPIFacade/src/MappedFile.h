@@ -0,0 +1,82 @@
+/// @file MappedFile.h
+/// @brief Simple C++ facade for CQG API - memory mapped file.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+
+#include <cstddef>
+
+namespace cqg
+{
+
+/// @class MappedFile
+/// @brief Read/write file mapped to memory as a whole. Grows by remapping,
+///        so pointers to data are invalidated by Resize().
+class MappedFile
+{
+public:
+
+   MappedFile();
+
+   ~MappedFile()
+   {
+      Close();
+   }
+
+   /// @brief Opens or creates file and maps its current content.
+   /// @return False if file can't be opened or mapped.
+   bool Open(const CString& path, CString& error);
+
+   /// @brief Changes file size and maps it again, data up to new size is kept.
+   /// @return False if file can't be resized or mapped, file is closed then.
+   bool Resize(size_t size, CString& error);
+
+   /// @brief Flushes changes and closes file, can be called several times.
+   void Close();
+
+   /// @brief Checks whether file is open.
+   bool IsOpen() const;
+
+   /// @brief Gets mapped data, NULL if file is empty.
+   char* Data() const
+   {
+      return m_data;
+   }
+
+   /// @brief Gets file size.
+   size_t Size() const
+   {
+      return m_size;
+   }
+
+   /// @brief Creates directory if it doesn't exist.
+   /// @return False if directory can't be created.
+   static bool MakeDirectory(const CString& path, CString& error);
+
+private:
+
+   MappedFile(const MappedFile&);
+   MappedFile& operator=(const MappedFile&);
+
+   /// @brief Maps current file content.
+   bool map(CString& error);
+
+   /// @brief Unmaps file content.
+   void unmap();
+
+#ifdef _WIN32
+   void* m_file;      ///< File handle.
+   void* m_mapping;   ///< File mapping handle.
+#else
+   int m_file;        ///< File descriptor.
+#endif
+
+   char* m_data;      ///< Mapped data.
+   size_t m_size;     ///< File size.
+};
+
+} // namespace cqg
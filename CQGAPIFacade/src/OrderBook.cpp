@@ -0,0 +1,280 @@
+/// @file OrderBook.cpp
+/// @brief Simple C++ facade for CQG API - market depth order books implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "OrderBook.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cqg
+{
+
+namespace
+{
+
+/// @brief Minimal number of ticks covered by book side arrays.
+const long long MinLevelsWindow = 64;
+
+/// @brief Maximal number of ticks covered by book side arrays. Levels far from the best one,
+///        e.g. stale or implied prices, are left out of arrays & compared with previous top levels directly.
+const long long MaxLevelsWindow = 4096;
+
+/// @brief Appends change to update.
+void AddChange(DepthUpdate& update, const bool bid, const Price price, const Volume volume)
+{
+   ATLASSERT(update.count < DepthUpdate::MaxChanges);
+
+   DepthChange& change = update.changes[update.count++];
+   change.bid = bid;
+   change.price = price;
+   change.volume = volume;
+}
+
+} // namespace
+
+OrderBook::OrderBook(const SymbolId symbolId, const Price tickSize): m_tickSize(tickSize)
+{
+   m_depth.symbolId = symbolId;
+   m_depth.bidsCount = 0;
+   m_depth.asksCount = 0;
+}
+
+void OrderBook::Apply(const MarketDepth& depth, DepthUpdate& update)
+{
+   update.symbolId = m_depth.symbolId;
+   update.count = 0;
+
+   const unsigned bidsCount = std::min<unsigned>(depth.bidsCount, MarketDepth::MaxLevels);
+   const unsigned asksCount = std::min<unsigned>(depth.asksCount, MarketDepth::MaxLevels);
+
+   DepthUpdate changed;
+   changed.count = 0;
+
+   if(m_tickSize > 0.0)
+   {
+      applySide(m_bids, true, m_depth.bids, m_depth.bidsCount, depth.bids, bidsCount, changed, update);
+      applySide(m_asks, false, m_depth.asks, m_depth.asksCount, depth.asks, asksCount, changed, update);
+   }
+   else
+   {
+      // Tick size guessed from sparse levels might be multiple of real one, so levels aren't indexed
+      // until CQGCEL reports tick size.
+      diffSide(true, m_depth.bids, m_depth.bidsCount, depth.bids, bidsCount, changed, update);
+      diffSide(false, m_depth.asks, m_depth.asksCount, depth.asks, asksCount, changed, update);
+   }
+
+   std::copy(changed.changes, changed.changes + changed.count, update.changes + update.count);
+   update.count += changed.count;
+
+   std::copy(depth.bids, depth.bids + bidsCount, m_depth.bids);
+   std::copy(depth.asks, depth.asks + asksCount, m_depth.asks);
+   m_depth.bidsCount = bidsCount;
+   m_depth.asksCount = asksCount;
+}
+
+long long OrderBook::toTick(const Price price) const
+{
+   return static_cast<long long>(std::floor(price / m_tickSize + 0.5));
+}
+
+const DepthLevel* OrderBook::findLevel(const DepthLevel* levels, unsigned count, const Price price) const
+{
+   for(unsigned i = 0; i < count; ++i)
+   {
+      if(m_tickSize > 0.0 ? toTick(levels[i].price) == toTick(price) : levels[i].price == price)
+      {
+         return &levels[i];
+      }
+   }
+
+   return NULL;
+}
+
+void OrderBook::diffSide(const bool bid, const DepthLevel* oldLevels, unsigned oldCount,
+   const DepthLevel* newLevels, unsigned newCount, DepthUpdate& changed, DepthUpdate& removed) const
+{
+   for(unsigned i = 0; i < newCount; ++i)
+   {
+      const DepthLevel* level = findLevel(oldLevels, oldCount, newLevels[i].price);
+      if(!level || level->volume != newLevels[i].volume)
+      {
+         AddChange(changed, bid, newLevels[i].price, newLevels[i].volume);
+      }
+   }
+
+   for(unsigned i = 0; i < oldCount; ++i)
+   {
+      if(!findLevel(newLevels, newCount, oldLevels[i].price))
+      {
+         AddChange(removed, bid, oldLevels[i].price, 0);
+      }
+   }
+}
+
+void OrderBook::reserve(Side& side, const DepthLevel* oldLevels, unsigned oldCount,
+   const DepthLevel* newLevels, unsigned newCount)
+{
+   if(!oldCount && !newCount)
+   {
+      return;
+   }
+
+   // Single outlier level must not blow arrays up, so only levels near the best one are covered.
+   const long long bestTick = newCount ? toTick(newLevels[0].price) : toTick(oldLevels[0].price);
+   long long minTick = bestTick;
+   long long maxTick = bestTick;
+
+   for(unsigned i = 0; i < oldCount + newCount; ++i)
+   {
+      const long long tick = toTick(i < oldCount ? oldLevels[i].price : newLevels[i - oldCount].price);
+      if(tick >= bestTick - MaxLevelsWindow / 4 && tick <= bestTick + MaxLevelsWindow / 4)
+      {
+         minTick = std::min(minTick, tick);
+         maxTick = std::max(maxTick, tick);
+      }
+   }
+
+   const long long size = static_cast<long long>(side.levels.size());
+   if(minTick >= side.firstTick && maxTick < side.firstTick + size)
+   {
+      return;
+   }
+
+   // Re-center arrays around current levels with room to move in both directions.
+   // Only the previous top levels are non zero, so they are the only ones to keep.
+   const long long span = maxTick - minTick + 1;
+   const long long newSize = std::min(MaxLevelsWindow, std::max(MinLevelsWindow, span * 4));
+
+   side.levels.assign(static_cast<size_t>(newSize), Level());
+   side.firstTick = minTick - (newSize - span) / 2;
+
+   for(unsigned i = 0; i < oldCount; ++i)
+   {
+      if(Level* level = getLevel(side, oldLevels[i].price))
+      {
+         level->volume = oldLevels[i].volume;
+         level->generation = side.generation;
+      }
+   }
+}
+
+OrderBook::Level* OrderBook::getLevel(Side& side, const Price price) const
+{
+   const long long index = toTick(price) - side.firstTick;
+   if(index < 0 || index >= static_cast<long long>(side.levels.size()))
+   {
+      return NULL;
+   }
+
+   return &side.levels[static_cast<size_t>(index)];
+}
+
+void OrderBook::applySide(Side& side, const bool bid, const DepthLevel* oldLevels, unsigned oldCount,
+   const DepthLevel* newLevels, unsigned newCount, DepthUpdate& changed, DepthUpdate& removed)
+{
+   reserve(side, oldLevels, oldCount, newLevels, newCount);
+
+   const unsigned generation = ++side.generation;
+
+   // Levels out of arrays window are compared with previous top levels directly.
+   for(unsigned i = 0; i < newCount; ++i)
+   {
+      Level* level = getLevel(side, newLevels[i].price);
+      if(!level)
+      {
+         const DepthLevel* previous = findLevel(oldLevels, oldCount, newLevels[i].price);
+         if(!previous || previous->volume != newLevels[i].volume)
+         {
+            AddChange(changed, bid, newLevels[i].price, newLevels[i].volume);
+         }
+
+         continue;
+      }
+
+      if(level->volume != newLevels[i].volume)
+      {
+         AddChange(changed, bid, newLevels[i].price, newLevels[i].volume);
+         level->volume = newLevels[i].volume;
+      }
+
+      level->generation = generation;
+   }
+
+   for(unsigned i = 0; i < oldCount; ++i)
+   {
+      Level* level = getLevel(side, oldLevels[i].price);
+      if(!level)
+      {
+         if(!findLevel(newLevels, newCount, oldLevels[i].price))
+         {
+            AddChange(removed, bid, oldLevels[i].price, 0);
+         }
+
+         continue;
+      }
+
+      if(level->generation != generation)
+      {
+         AddChange(removed, bid, oldLevels[i].price, 0);
+         level->volume = 0;
+         level->generation = generation;
+      }
+   }
+}
+
+void OrderBooks::AddSymbol(const SymbolId id, const Price tickSize)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   if(id >= m_books.size())
+   {
+      m_books.resize(id + 1, OrderBook(InvalidSymbolId, 0.0));
+   }
+
+   m_books[id] = OrderBook(id, tickSize);
+}
+
+void OrderBooks::RemoveSymbol(const SymbolId id)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   if(id < m_books.size())
+   {
+      m_books[id] = OrderBook(InvalidSymbolId, 0.0);
+   }
+}
+
+bool OrderBooks::Apply(const MarketDepth& depth, DepthUpdate& update)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   if(depth.symbolId >= m_books.size() || m_books[depth.symbolId].GetDepth().symbolId != depth.symbolId)
+   {
+      update.symbolId = depth.symbolId;
+      update.count = 0;
+      return false;
+   }
+
+   m_books[depth.symbolId].Apply(depth, update);
+   return true;
+}
+
+bool OrderBooks::Get(const SymbolId id, MarketDepth& depth) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   if(id >= m_books.size() || m_books[id].GetDepth().symbolId != id)
+   {
+      return false;
+   }
+
+   depth = m_books[id].GetDepth();
+   return true;
+}
+
+} // namespace cqg
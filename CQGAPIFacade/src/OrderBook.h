@@ -0,0 +1,122 @@
+/// @file OrderBook.h
+/// @brief Simple C++ facade for CQG API - market depth order books.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+
+#include <mutex>
+#include <vector>
+
+namespace cqg
+{
+
+/// @class OrderBook
+/// @brief Single symbol price level book. Level volumes are kept in contiguous arrays
+///        indexed by price offset in ticks, so level lookup is O(1) without any node based maps.
+///        Top levels snapshot is kept ready for O(1) access. Arrays cover limited window around the best level,
+///        levels out of it and levels of symbol with unknown tick size are compared with previous top levels directly.
+class OrderBook
+{
+public:
+
+   /// @brief Creates empty book.
+   /// @param symbolId [in] symbol identifier.
+   /// @param tickSize [in] symbol tick size reported by CQGCEL, zero if unknown.
+   OrderBook(const SymbolId symbolId, const Price tickSize);
+
+   /// @brief Applies new market depth snapshot.
+   /// @param depth [in] new top levels.
+   /// @param update [out] changed levels, removed ones go first.
+   void Apply(const MarketDepth& depth, DepthUpdate& update);
+
+   /// @brief Gets current top levels.
+   const MarketDepth& GetDepth() const
+   {
+      return m_depth;
+   }
+
+private:
+
+   /// @brief Price level, generation tells which snapshot updated it last time.
+   struct Level
+   {
+      Level(): volume(0), generation(0)
+      {}
+
+      Volume volume;
+      unsigned generation;
+   };
+
+   /// @brief Book side levels, levels[i] is level at firstTick + i.
+   struct Side
+   {
+      Side(): firstTick(0), generation(0)
+      {}
+
+      std::vector<Level> levels;
+      long long firstTick;
+      unsigned generation;
+   };
+
+   /// @brief Converts price to ticks.
+   long long toTick(const Price price) const;
+
+   /// @brief Gets arrays level of given price.
+   /// @return NULL if price is out of arrays window.
+   Level* getLevel(Side& side, const Price price) const;
+
+   /// @brief Finds level of given price, the same tick if tick size is known.
+   /// @return NULL if there is no such level.
+   const DepthLevel* findLevel(const DepthLevel* levels, unsigned count, const Price price) const;
+
+   /// @brief Compares new side levels with old ones without indexing, O(levels^2) for top levels only.
+   void diffSide(const bool bid, const DepthLevel* oldLevels, unsigned oldCount,
+      const DepthLevel* newLevels, unsigned newCount, DepthUpdate& changed, DepthUpdate& removed) const;
+
+   /// @brief Makes sure side arrays cover given levels near the best one, re-centers arrays if needed.
+   void reserve(Side& side, const DepthLevel* oldLevels, unsigned oldCount,
+      const DepthLevel* newLevels, unsigned newCount);
+
+   /// @brief Applies new side levels, appends changes to update & removals to removed.
+   void applySide(Side& side, const bool bid, const DepthLevel* oldLevels, unsigned oldCount,
+      const DepthLevel* newLevels, unsigned newCount, DepthUpdate& changed, DepthUpdate& removed);
+
+   Price m_tickSize;     ///< Symbol tick size.
+   Side m_bids;          ///< Bid levels.
+   Side m_asks;          ///< Ask levels.
+   MarketDepth m_depth;  ///< Current top levels.
+};
+
+/// @class OrderBooks
+/// @brief Order books of all subscribed symbols, indexed by symbol identifier.
+///        Updated from CQGCEL thread, snapshots can be read from any thread.
+class OrderBooks
+{
+public:
+
+   /// @brief Creates empty book of subscribed symbol.
+   void AddSymbol(const SymbolId id, const Price tickSize);
+
+   /// @brief Drops book of symbol, its depth is not known anymore.
+   void RemoveSymbol(const SymbolId id);
+
+   /// @brief Applies new symbol market depth snapshot.
+   /// @param depth [in] new top levels.
+   /// @param update [out] changed levels.
+   /// @return False if symbol is not known.
+   bool Apply(const MarketDepth& depth, DepthUpdate& update);
+
+   /// @brief Gets current symbol market depth.
+   /// @return False if symbol is not known.
+   bool Get(const SymbolId id, MarketDepth& depth) const;
+
+private:
+   mutable std::mutex m_lock;        ///< Guards books.
+   std::vector<OrderBook> m_books;   ///< Books indexed by symbol identifier.
+};
+
+} // namespace cqg
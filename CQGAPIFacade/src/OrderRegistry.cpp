@@ -0,0 +1,282 @@
+/// @file OrderRegistry.cpp
+/// @brief Simple C++ facade for CQG API - orders known to facade indexed by guid & gateway order ID implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "OrderRegistry.h"
+
+#include <algorithm>
+
+namespace cqg
+{
+
+void OrderRegistry::OnPlaced(const OrderInfo& order)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   // Order change may come first if backend reports it before placing returns.
+   const std::pair<OrdersMap::iterator, bool> inserted =
+      m_orders.insert(OrdersMap::value_type(order.orderGuid, Order()));
+   Order& placed = inserted.first->second;
+
+   if(!inserted.second)
+   {
+      count(placed, -1);
+   }
+   else
+   {
+      placed.info = order;
+   }
+
+   placed.internal = true;
+   count(placed, 1);
+}
+
+void OrderRegistry::OnChanged(OrderInfo& order, const FillKey& lastFill)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const std::pair<OrdersMap::iterator, bool> inserted =
+      m_orders.insert(OrdersMap::value_type(order.orderGuid, Order()));
+   Order& changed = inserted.first->second;
+   const bool wasFinal = !inserted.second && changed.info.final;
+
+   if(!inserted.second)
+   {
+      count(changed, -1);
+   }
+   else
+   {
+      changed.internal = false;
+   }
+
+   // Modification sent by facade stays pending until order reports it's done.
+   if(changed.modifyPending && isModifyAck(changed, order))
+   {
+      onModifyAck(changed, order);
+   }
+
+   // Each change reports the last fill, it's new only if fill or its status differs from reported one.
+   if(!order.orderFills.empty())
+   {
+      if(changed.info.fillSeq != 0 && lastFill == changed.lastFill)
+      {
+         order.orderFills.clear();
+      }
+      else
+      {
+         changed.lastFill = lastFill;
+      }
+   }
+
+   order.fillSeq = changed.info.fillSeq + (order.orderFills.empty() ? 0 : 1);
+   order.modifyPending = order.modifyPending || changed.modifyPending;
+
+   changed.info = order;
+   count(changed, 1);
+
+   if(!order.gwOrderID.IsEmpty())
+   {
+      m_guids[order.gwOrderID] = order.orderGuid;
+   }
+
+   // Counts & modification stats are settled, final order is kept for a while for lookups.
+   if(order.final && !wasFinal)
+   {
+      onFinal(order.orderGuid);
+   }
+}
+
+bool OrderRegistry::Get(const CString& orderGuid, OrderInfo& order) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const OrdersMap::const_iterator it = m_orders.find(orderGuid);
+   if(it == m_orders.end())
+   {
+      return false;
+   }
+
+   order = it->second.info;
+   return true;
+}
+
+bool OrderRegistry::GetByGwOrderID(const GWOrderID& gwOrderID, OrderInfo& order) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const GuidsMap::const_iterator itGuid = m_guids.find(gwOrderID);
+   if(itGuid == m_guids.end())
+   {
+      return false;
+   }
+
+   const OrdersMap::const_iterator it = m_orders.find(itGuid->second);
+   if(it == m_orders.end())
+   {
+      return false;
+   }
+
+   order = it->second.info;
+   return true;
+}
+
+bool OrderRegistry::IsFinal(const CString& orderGuid) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const OrdersMap::const_iterator it = m_orders.find(orderGuid);
+   return it != m_orders.end() && it->second.info.final;
+}
+
+void OrderRegistry::OnModifySent(const CString& orderGuid, Quantity quantity, const Clock::time_point& sent)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const OrdersMap::iterator it = m_orders.find(orderGuid);
+   if(it == m_orders.end() || it->second.info.final)
+   {
+      return;
+   }
+
+   Order& order = it->second;
+   if(!order.modifyPending)
+   {
+      ++m_modifyStats.pending;
+   }
+
+   order.modifyPending = true;
+   order.modifySeen = false;
+   order.modifyQuantity = quantity;
+   order.info.modifyPending = true;
+   order.modifySent = sent;
+   ++m_modifyStats.requested;
+}
+
+bool OrderRegistry::IsModifyPending(const CString& orderGuid) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const OrdersMap::const_iterator it = m_orders.find(orderGuid);
+   return it != m_orders.end() && it->second.info.modifyPending;
+}
+
+Quantity OrderRegistry::GetFilledQty(const CString& orderGuid) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const OrdersMap::const_iterator it = m_orders.find(orderGuid);
+   return it != m_orders.end() ? it->second.info.filledQty : 0;
+}
+
+void OrderRegistry::GetModifyStats(OrderModifyStats& stats) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+   stats = m_modifyStats;
+}
+
+int OrderRegistry::GetWorkingCount(const ID& gwAccountID, bool internalOnly) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   if(gwAccountID == ID())
+   {
+      return getCount(m_total, internalOnly);
+   }
+
+   const AccountCounts::const_iterator it = m_accounts.find(gwAccountID);
+   return it != m_accounts.end() ? getCount(it->second, internalOnly) : 0;
+}
+
+int OrderRegistry::GetSymbolWorkingCount(const CString& symbolFullName, bool internalOnly) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const SymbolCounts::const_iterator it = m_symbols.find(symbolFullName);
+   return it != m_symbols.end() ? getCount(it->second, internalOnly) : 0;
+}
+
+void OrderRegistry::Clear()
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   m_orders.clear();
+   m_guids.clear();
+   m_total = Counts();
+   m_accounts.clear();
+   m_symbols.clear();
+   m_modifyStats = OrderModifyStats();
+   m_finalOrders.clear();
+}
+
+void OrderRegistry::onFinal(const CString& orderGuid)
+{
+   m_finalOrders.push_back(orderGuid);
+   if(m_finalOrders.size() <= MaxFinalOrders)
+   {
+      return;
+   }
+
+   const OrdersMap::iterator it = m_orders.find(m_finalOrders.front());
+   m_finalOrders.pop_front();
+
+   if(it == m_orders.end())
+   {
+      return;
+   }
+
+   // Gateway order ID may be taken by later order already.
+   const GuidsMap::iterator itGuid = m_guids.find(it->second.info.gwOrderID);
+   if(itGuid != m_guids.end() && itGuid->second == it->first)
+   {
+      m_guids.erase(itGuid);
+   }
+
+   m_orders.erase(it);
+}
+
+bool OrderRegistry::isModifyAck(Order& order, const OrderInfo& change)
+{
+   // Fill or status change may come before gateway takes modification.
+   order.modifySeen = order.modifySeen || change.modifyPending;
+
+   const bool rejected = !change.error.IsEmpty() && change.error != order.info.error;
+   const bool modified = order.modifySeen || (order.modifyQuantity != 0 && change.quantity == order.modifyQuantity);
+
+   return change.final || rejected || (modified && !change.modifyPending);
+}
+
+void OrderRegistry::onModifyAck(Order& order, const OrderInfo& change)
+{
+   const double us = std::chrono::duration<double, std::micro>(Clock::now() - order.modifySent).count();
+   order.modifyPending = false;
+
+   OrderModifyStats& stats = m_modifyStats;
+   --stats.pending;
+   ++stats.acknowledged;
+   stats.rejected += !change.error.IsEmpty() && change.error != order.info.error ? 1 : 0;
+   stats.lastAckUs = us;
+   stats.avgAckUs += (us - stats.avgAckUs) / stats.acknowledged;
+   stats.maxAckUs = std::max(stats.maxAckUs, us);
+}
+
+void OrderRegistry::count(const Order& order, int delta)
+{
+   if(order.info.final)
+   {
+      return;
+   }
+
+   Counts* counts[] = { &m_total, &m_accounts[order.info.gwAccountID], &m_symbols[order.info.symbol] };
+
+   for(size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+   {
+      counts[i]->all += delta;
+      counts[i]->internal += order.internal ? delta : 0;
+   }
+}
+
+} // namespace cqg
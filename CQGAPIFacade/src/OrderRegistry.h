@@ -0,0 +1,142 @@
+/// @file OrderRegistry.h
+/// @brief Simple C++ facade for CQG API - orders known to facade indexed by guid & gateway order ID.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "Backend.h"
+#include "SymbolTable.h"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace cqg
+{
+
+/// @class OrderRegistry
+/// @brief The last state of orders placed by facade or reported by order changes.
+///        The latest MaxFinalOrders final orders are kept for lookups too, older ones are evicted,
+///        so registry doesn't grow with session orders. Working orders are counted per account & symbol
+///        as orders change state, so counts take O(1). Updated from CQGCEL thread, read from any thread.
+///        Order modification is pending since OnModifySent() until order change reports it's done: order has been
+///        reported in modification and is not anymore, its quantity became the requested one, it's rejected or final.
+class OrderRegistry
+{
+public:
+
+   typedef std::chrono::steady_clock Clock;
+
+   /// @brief Number of final orders kept for lookups.
+   static const size_t MaxFinalOrders = 10000;
+
+   OrderRegistry(): m_modifyStats()
+   {}
+
+   /// @brief Adds order just placed by facade, its gateway order ID is not known yet.
+   void OnPlaced(const OrderInfo& order);
+
+   /// @brief Updates order state by order change, adds orders placed elsewhere.
+   /// @param order [in, out] order change, its fill sequence number & pending modification are set,
+   ///        the last fill is dropped if it's already reported.
+   /// @param lastFill [in] identity of the order last fill.
+   void OnChanged(OrderInfo& order, const FillKey& lastFill);
+
+   /// @brief Gets the last state of order.
+   /// @return False if order is unknown.
+   bool Get(const CString& orderGuid, OrderInfo& order) const;
+
+   /// @brief Gets the last state of order by its gateway order ID.
+   /// @return False if order is unknown or gateway hasn't accepted it yet.
+   bool GetByGwOrderID(const GWOrderID& gwOrderID, OrderInfo& order) const;
+
+   /// @brief Checks whether order is known & not working anymore.
+   bool IsFinal(const CString& orderGuid) const;
+
+   /// @brief Marks order modification sent.
+   /// @param quantity [in] requested order quantity, zero if quantity isn't modified.
+   /// @param sent [in] time modification was sent at.
+   void OnModifySent(const CString& orderGuid, Quantity quantity, const Clock::time_point& sent);
+
+   /// @brief Gets order filled quantity, zero if order is unknown.
+   Quantity GetFilledQty(const CString& orderGuid) const;
+
+   /// @brief Checks whether order modification is sent but not acknowledged yet.
+   bool IsModifyPending(const CString& orderGuid) const;
+
+   /// @brief Gets modifications counters.
+   void GetModifyStats(OrderModifyStats& stats) const;
+
+   /// @brief Gets number of working orders of account.
+   /// @param gwAccountID [in] account ID, zero for all accounts.
+   /// @param internalOnly [in] true to count orders placed by facade only.
+   int GetWorkingCount(const ID& gwAccountID, bool internalOnly) const;
+
+   /// @brief Gets number of working orders of symbol, see GetWorkingCount().
+   int GetSymbolWorkingCount(const CString& symbolFullName, bool internalOnly) const;
+
+   /// @brief Drops all orders.
+   void Clear();
+
+private:
+
+   /// @brief Working orders counts.
+   struct Counts
+   {
+      Counts(): all(0), internal(0)
+      {}
+
+      int all;        ///< All working orders.
+      int internal;   ///< Working orders placed by facade.
+   };
+
+   /// @brief Order & its origin.
+   struct Order
+   {
+      OrderInfo info;                 ///< The last order state.
+      bool internal;                  ///< True if order is placed by facade.
+      bool modifyPending;             ///< True if modification sent by facade is not acknowledged yet.
+      bool modifySeen;                ///< True if order has been reported in modification since it was sent.
+      Quantity modifyQuantity;        ///< Requested quantity of pending modification, zero if not modified.
+      Clock::time_point modifySent;   ///< Time pending modification was sent at.
+      FillKey lastFill;               ///< Identity of the last reported fill.
+   };
+
+   typedef std::unordered_map<CString, Order, CStringHash> OrdersMap;
+   typedef std::unordered_map<GWOrderID, CString, CStringHash> GuidsMap;
+   typedef std::unordered_map<ID, Counts> AccountCounts;
+   typedef std::unordered_map<CString, Counts, CStringHash> SymbolCounts;
+
+   /// @brief Adds working order to counts or removes it.
+   /// @param delta [in] 1 to add, -1 to remove.
+   void count(const Order& order, int delta);
+
+   /// @brief Remembers order turned final, evicts the oldest final order if there are too many.
+   void onFinal(const CString& orderGuid);
+
+   /// @brief Checks whether order change acknowledges pending modification.
+   static bool isModifyAck(Order& order, const OrderInfo& change);
+
+   /// @brief Counts acknowledged modification of changed order.
+   void onModifyAck(Order& order, const OrderInfo& change);
+
+   /// @brief Gets one of counts.
+   static int getCount(const Counts& counts, bool internalOnly)
+   {
+      return internalOnly ? counts.internal : counts.all;
+   }
+
+   mutable std::mutex m_lock;     ///< Guards orders.
+   OrdersMap m_orders;            ///< Orders by guid.
+   GuidsMap m_guids;              ///< Order guids by gateway order ID.
+   Counts m_total;                ///< Working orders of all accounts.
+   AccountCounts m_accounts;      ///< Working orders by account ID.
+   SymbolCounts m_symbols;        ///< Working orders by symbol full name.
+   OrderModifyStats m_modifyStats;   ///< Modifications counters.
+   std::deque<CString> m_finalOrders;   ///< Guids of final orders kept, the oldest first.
+};
+
+} // namespace cqg
@@ -0,0 +1,222 @@
+/// @file Portfolio.cpp
+/// @brief Simple C++ facade for CQG API - columnar positions & vectorized portfolio mark-to-market implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "CQGPortfolio.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CQGAPIFACADE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace cqg
+{
+
+namespace
+{
+
+/// @brief Gets sum of values.
+double GetSum(const double* values, size_t count)
+{
+   size_t i = 0;
+   double sum = 0.0;
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   __m128d sum0 = _mm_setzero_pd();
+   __m128d sum1 = _mm_setzero_pd();
+
+   for(; i + 4 <= count; i += 4)
+   {
+      sum0 = _mm_add_pd(sum0, _mm_loadu_pd(values + i));
+      sum1 = _mm_add_pd(sum1, _mm_loadu_pd(values + i + 2));
+   }
+
+   double lanes[2];
+   _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+   sum = lanes[0] + lanes[1];
+#endif
+
+   for(; i < count; ++i)
+   {
+      sum += values[i];
+   }
+
+   return sum;
+}
+
+#ifdef CQGAPIFACADE_USE_SSE2
+
+/// @brief Gathers two values by indexes, SSE2 has no gather instruction.
+inline __m128d Gather(const double* values, const unsigned* index)
+{
+   return _mm_loadh_pd(_mm_load_sd(values + index[0]), values + index[1]);
+}
+
+#endif
+
+} // namespace
+
+MoneyAmount GetOpenTradeEquity(
+   const double* quantity,
+   const Price* averagePrice,
+   const unsigned* markIndex,
+   const Price* markPrice,
+   const double* pointValue,
+   size_t count)
+{
+   size_t i = 0;
+   MoneyAmount ote = 0.0;
+
+#ifdef CQGAPIFACADE_USE_SSE2
+   // Two independent accumulators hide add latency.
+   __m128d ote0 = _mm_setzero_pd();
+   __m128d ote1 = _mm_setzero_pd();
+
+   for(; i + 4 <= count; i += 4)
+   {
+      const __m128d diff0 = _mm_sub_pd(Gather(markPrice, markIndex + i), _mm_loadu_pd(averagePrice + i));
+      const __m128d diff1 = _mm_sub_pd(Gather(markPrice, markIndex + i + 2), _mm_loadu_pd(averagePrice + i + 2));
+      const __m128d value0 = _mm_mul_pd(_mm_loadu_pd(quantity + i), Gather(pointValue, markIndex + i));
+      const __m128d value1 = _mm_mul_pd(_mm_loadu_pd(quantity + i + 2), Gather(pointValue, markIndex + i + 2));
+      ote0 = _mm_add_pd(ote0, _mm_mul_pd(diff0, value0));
+      ote1 = _mm_add_pd(ote1, _mm_mul_pd(diff1, value1));
+   }
+
+   double lanes[2];
+   _mm_storeu_pd(lanes, _mm_add_pd(ote0, ote1));
+   ote = lanes[0] + lanes[1];
+#endif
+
+   for(; i < count; ++i)
+   {
+      ote += (markPrice[markIndex[i]] - averagePrice[i]) * (quantity[i] * pointValue[markIndex[i]]);
+   }
+
+   return ote;
+}
+
+PositionHandle PortfolioColumns::Add(const ID& gwAccountID, SymbolId symbolId, double quantity, Price averagePrice)
+{
+   const unsigned markIndex = getMarkIndex(symbolId, quantity < 0.0);
+
+   const std::pair<AccountIndex::iterator, bool> inserted =
+      m_accountIndex.insert(AccountIndex::value_type(gwAccountID, m_accounts.size()));
+
+   if(inserted.second)
+   {
+      const AccountRows rows = { gwAccountID, Size(), Size() };
+      m_accounts.push_back(rows);
+   }
+
+   // Row goes right after the last account row, rows of later accounts move by one.
+   const size_t account = inserted.first->second;
+   const size_t row = m_accounts[account].end;
+
+   for(size_t i = account; i < m_accounts.size(); ++i)
+   {
+      m_accounts[i].begin += i == account ? 0 : 1;
+      ++m_accounts[i].end;
+   }
+
+   m_quantity.insert(m_quantity.begin() + row, quantity);
+   m_averagePrice.insert(m_averagePrice.begin() + row, averagePrice);
+   m_markIndex.insert(m_markIndex.begin() + row, markIndex);
+   m_profitLoss.insert(m_profitLoss.begin() + row, 0.0);
+
+   const PositionHandle position = m_rows.size();
+   m_rows.push_back(row);
+   m_handles.insert(m_handles.begin() + row, position);
+
+   for(size_t i = row + 1; i < m_handles.size(); ++i)
+   {
+      m_rows[m_handles[i]] = i;
+   }
+
+   return position;
+}
+
+void PortfolioColumns::SetPosition(PositionHandle position, double quantity, Price averagePrice, MoneyAmount profitLoss)
+{
+   const size_t row = m_rows[position];
+   m_quantity[row] = quantity;
+   m_averagePrice[row] = averagePrice;
+   m_profitLoss[row] = profitLoss;
+
+   // Symbol long mark price index is even, short one follows it.
+   m_markIndex[row] = (m_markIndex[row] & ~1u) | (quantity < 0.0 ? 1u : 0u);
+}
+
+MoneyAmount PortfolioColumns::GetOte(PositionHandle position) const
+{
+   const size_t row = m_rows[position];
+   const unsigned index = m_markIndex[row];
+   return (m_markPrice[index] - m_averagePrice[row]) * (m_quantity[row] * m_pointValue[index]);
+}
+
+bool PortfolioColumns::GetAccountProfitLoss(const ID& gwAccountID, AccountProfitLoss& result) const
+{
+   const AccountIndex::const_iterator it = m_accountIndex.find(gwAccountID);
+   if(it == m_accountIndex.end())
+   {
+      result.gwAccountID = gwAccountID;
+      result.ote = 0.0;
+      result.profitLoss = 0.0;
+      return false;
+   }
+
+   getProfitLoss(m_accounts[it->second], result);
+   return true;
+}
+
+void PortfolioColumns::GetAccountsProfitLoss(AccountsProfitLoss& result) const
+{
+   result.resize(m_accounts.size());
+
+   for(size_t i = 0; i < m_accounts.size(); ++i)
+   {
+      getProfitLoss(m_accounts[i], result[i]);
+   }
+}
+
+void PortfolioColumns::Clear()
+{
+   m_accounts.clear();
+   m_accountIndex.clear();
+   m_rows.clear();
+   m_handles.clear();
+   m_quantity.clear();
+   m_averagePrice.clear();
+   m_markIndex.clear();
+   m_profitLoss.clear();
+   m_markPrice.clear();
+   m_pointValue.clear();
+}
+
+unsigned PortfolioColumns::getMarkIndex(SymbolId symbolId, bool shortPosition)
+{
+   const size_t index = 2 * static_cast<size_t>(symbolId);
+   if(index >= m_markPrice.size())
+   {
+      m_markPrice.resize(index + 2, 0.0);
+      m_pointValue.resize(index + 2, 1.0);
+   }
+
+   return static_cast<unsigned>(index) + (shortPosition ? 1 : 0);
+}
+
+void PortfolioColumns::getProfitLoss(const AccountRows& rows, AccountProfitLoss& result) const
+{
+   const size_t begin = rows.begin;
+   const size_t count = rows.end - rows.begin;
+
+   result.gwAccountID = rows.gwAccountID;
+   result.ote = count ? GetOpenTradeEquity(&m_quantity[begin], &m_averagePrice[begin], &m_markIndex[begin],
+      &m_markPrice[0], &m_pointValue[0], count) : 0.0;
+   result.profitLoss = count ? GetSum(&m_profitLoss[begin], count) : 0.0;
+}
+
+} // namespace cqg
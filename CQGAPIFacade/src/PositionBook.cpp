@@ -0,0 +1,289 @@
+/// @file PositionBook.cpp
+/// @brief Simple C++ facade for CQG API - account positions kept from fills & marked to market by quotes implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "PositionBook.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace cqg
+{
+
+void PositionBook::Reset(const ID& gwAccountID, const Positions& positions, const std::vector<SymbolId>& symbolIds)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   // Positions missing in new state are flat.
+   const std::vector<PositionHandle>& handles = m_accounts[gwAccountID];
+   for(size_t i = 0; i < handles.size(); ++i)
+   {
+      m_columns.SetPosition(handles[i], 0.0, 0.0, 0.0);
+      m_positions[handles[i]].pointsProfitLoss = 0.0;
+   }
+
+   for(size_t i = 0; i < positions.size() && i < symbolIds.size(); ++i)
+   {
+      const PositionInfo& info = positions[i];
+      const PositionHandle position = getPosition(gwAccountID, symbolIds[i], info.symbol);
+      Symbol& symbol = getSymbol(symbolIds[i]);
+
+      const double quantity = info.longPosition ? info.quantity : -static_cast<double>(info.quantity);
+      const Price averagePrice = info.quantity && info.averagePrice != InvalidPrice ? info.averagePrice : 0.0;
+      const MoneyAmount profitLoss = info.profitLoss != InvalidMoneyAmount ? info.profitLoss : 0.0;
+      m_columns.SetPosition(position, quantity, averagePrice, profitLoss);
+
+      // Symbol is marked at price CQGCEL reported OTE in money implies until symbol prices are known.
+      if(!symbol.HasPrices() && quantity != 0.0)
+      {
+         symbol.impliedPrice = info.ote != InvalidMoneyAmount ?
+            averagePrice + info.ote / (quantity * symbol.pointValue) : averagePrice;
+         symbol.impliedAverage = averagePrice;
+      }
+
+      markSymbol(symbolIds[i], symbol);
+   }
+}
+
+void PositionBook::SetPointValue(const SymbolId symbolId, const Price tickSize, const MoneyAmount tickValue)
+{
+   if(tickSize <= 0.0 || tickValue <= 0.0)
+   {
+      return;
+   }
+
+   Symbol& symbol = getSymbol(symbolId);
+
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const double previousValue = symbol.pointValue;
+   symbol.pointValue = tickValue / tickSize;
+   symbol.pointValueKnown = true;
+   m_columns.SetSymbolPointValue(symbolId, symbol.pointValue);
+
+   for(size_t i = 0; i < symbol.positions.size(); ++i)
+   {
+      const PositionHandle position = symbol.positions[i];
+
+      // P/L booked in price points becomes money.
+      Position& properties = m_positions[position];
+      if(properties.pointsProfitLoss != 0.0)
+      {
+         const MoneyAmount profitLoss = m_columns.GetProfitLoss(position) +
+            properties.pointsProfitLoss * (symbol.pointValue - 1.0);
+         m_columns.SetPosition(position, m_columns.GetQuantity(position), m_columns.GetAveragePrice(position), profitLoss);
+         properties.pointsProfitLoss = 0.0;
+      }
+   }
+
+   // Mark price implied by OTE reported in money keeps that OTE.
+   if(!symbol.HasPrices() && symbol.impliedPrice != InvalidPrice && symbol.impliedAverage != InvalidPrice)
+   {
+      symbol.impliedPrice = symbol.impliedAverage +
+         (symbol.impliedPrice - symbol.impliedAverage) * previousValue / symbol.pointValue;
+      markSymbol(symbolId, symbol);
+   }
+}
+
+void PositionBook::OnFill(const ID& gwAccountID, const SymbolId symbolId, bool buy, const FillInfo& fill)
+{
+   if(fill.fillQty == 0)
+   {
+      return;
+   }
+
+   Symbol& symbol = getSymbol(symbolId);
+
+   // Canceled fill is reverted by fill of opposite side.
+   const bool fillBuy = (fill.fillQty < 0) != (buy != fill.canceled);
+   const long fillQty = fillBuy ? std::labs(fill.fillQty) : -std::labs(fill.fillQty);
+
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const PositionHandle position = getPosition(gwAccountID, symbolId, fill.symbol);
+
+   const long signedQty = static_cast<long>(m_columns.GetQuantity(position));
+   const long newQty = signedQty + fillQty;
+   Price averagePrice = m_columns.GetAveragePrice(position);
+   MoneyAmount profitLoss = m_columns.GetProfitLoss(position);
+
+   if(signedQty == 0 || (signedQty > 0) == (fillQty > 0))
+   {
+      // Opening or increasing position.
+      averagePrice = (averagePrice * std::labs(signedQty) + fill.fillPrice * std::labs(fillQty)) / std::labs(newQty);
+   }
+   else
+   {
+      // Decreasing, closing or reversing position.
+      const long closedQty = std::min(std::labs(signedQty), std::labs(fillQty));
+      const double direction = signedQty > 0 ? 1.0 : -1.0;
+      const double points = (fill.fillPrice - averagePrice) * closedQty * direction;
+      profitLoss += points * symbol.pointValue;
+
+      if(!symbol.pointValueKnown)
+      {
+         m_positions[position].pointsProfitLoss += points;
+      }
+
+      if(std::labs(fillQty) > std::labs(signedQty)) averagePrice = fill.fillPrice;
+      if(newQty == 0) averagePrice = 0.0;
+   }
+
+   m_columns.SetPosition(position, static_cast<double>(newQty), averagePrice, profitLoss);
+
+   // Symbol is marked at the last fill price until symbol prices are known.
+   if(!symbol.HasPrices())
+   {
+      symbol.impliedPrice = fill.fillPrice;
+      symbol.impliedAverage = InvalidPrice;
+      markSymbol(symbolId, symbol);
+   }
+}
+
+void PositionBook::OnQuotes(const QuoteEvent& quotes)
+{
+   Symbol& symbol = getSymbol(quotes.symbolId);
+
+   for(unsigned i = 0; i < quotes.count; ++i)
+   {
+      const QuoteInfo& quote = quotes.quotes[i];
+      switch(quote.type)
+      {
+      case QuoteInfo::Bid: symbol.bid = quote.price; break;
+      case QuoteInfo::Ask: symbol.ask = quote.price; break;
+      case QuoteInfo::Trade: symbol.trade = quote.price; break;
+      default: break;
+      }
+   }
+
+   if(symbol.positions.empty())
+   {
+      return;
+   }
+
+   // Single symbol prices update whatever number of positions symbol has.
+   std::lock_guard<std::mutex> lock(m_lock);
+   markSymbol(quotes.symbolId, symbol);
+}
+
+bool PositionBook::GetPositions(const ID& gwAccountID, Positions& positions) const
+{
+   positions.clear();
+
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const AccountPositions::const_iterator it = m_accounts.find(gwAccountID);
+   if(it == m_accounts.end() || it->second.empty())
+   {
+      return false;
+   }
+
+   positions.resize(it->second.size());
+   for(size_t i = 0; i < it->second.size(); ++i)
+   {
+      const PositionHandle position = it->second[i];
+      const double quantity = m_columns.GetQuantity(position);
+
+      PositionInfo& info = positions[i];
+      info.symbol = m_positions[position].symbol;
+      info.longPosition = quantity >= 0.0;
+      info.quantity = static_cast<Quantity>(quantity >= 0.0 ? quantity : -quantity);
+      info.averagePrice = info.quantity ? m_columns.GetAveragePrice(position) : InvalidPrice;
+      info.ote = m_columns.GetOte(position);
+      info.profitLoss = m_columns.GetProfitLoss(position);
+   }
+
+   return true;
+}
+
+bool PositionBook::GetProfitLoss(const ID& gwAccountID, MoneyAmount& ote, MoneyAmount& profitLoss) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   AccountProfitLoss account;
+   const bool found = m_columns.GetAccountProfitLoss(gwAccountID, account);
+
+   ote = account.ote;
+   profitLoss = account.profitLoss;
+   return found;
+}
+
+void PositionBook::GetAccountsProfitLoss(AccountsProfitLoss& accounts) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+   m_columns.GetAccountsProfitLoss(accounts);
+}
+
+void PositionBook::Clear()
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   m_columns.Clear();
+   m_positions.clear();
+   m_accounts.clear();
+
+   for(size_t i = 0; i < m_symbols.size(); ++i)
+   {
+      m_symbols[i].positions.clear();
+   }
+}
+
+PositionBook::Symbol& PositionBook::getSymbol(const SymbolId symbolId)
+{
+   if(symbolId >= m_symbols.size())
+   {
+      m_symbols.resize(symbolId + 1);
+   }
+
+   return m_symbols[symbolId];
+}
+
+PositionHandle PositionBook::getPosition(const ID& gwAccountID, const SymbolId symbolId, const CString& symbol)
+{
+   std::vector<PositionHandle>& handles = m_accounts[gwAccountID];
+   for(size_t i = 0; i < handles.size(); ++i)
+   {
+      if(m_positions[handles[i]].symbolId == symbolId)
+      {
+         return handles[i];
+      }
+   }
+
+   Symbol& symbolState = getSymbol(symbolId);
+   const PositionHandle position = m_columns.Add(gwAccountID, symbolId, 0.0, 0.0);
+   m_columns.SetSymbolPointValue(symbolId, symbolState.pointValue);
+   markSymbol(symbolId, symbolState);
+
+   Position properties;
+   properties.gwAccountID = gwAccountID;
+   properties.symbolId = symbolId;
+   properties.symbol = symbol;
+   properties.pointsProfitLoss = 0.0;
+   m_positions.push_back(properties);
+
+   handles.push_back(position);
+   symbolState.positions.push_back(position);
+   return position;
+}
+
+void PositionBook::markSymbol(const SymbolId symbolId, const Symbol& symbol)
+{
+   m_columns.SetSymbolPrices(symbolId, getMarkPrice(symbol, symbol.bid), getMarkPrice(symbol, symbol.ask));
+}
+
+Price PositionBook::getMarkPrice(const Symbol& symbol, Price sidePrice)
+{
+   Price price = sidePrice != InvalidPrice ? sidePrice : symbol.trade;
+   if(price == InvalidPrice)
+   {
+      price = symbol.impliedPrice;
+   }
+
+   return price != InvalidPrice ? price : 0.0;
+}
+
+} // namespace cqg
@@ -0,0 +1,125 @@
+/// @file PositionBook.h
+/// @brief Simple C++ facade for CQG API - account positions kept from fills & marked to market by quotes.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "CQGPortfolio.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cqg
+{
+
+/// @class PositionBook
+/// @brief Account positions kept by facade from order fills, so they are read without CQGCEL.
+///        Open positions are marked to market on each bid, ask or trade update of position symbol:
+///        long positions at bid, short ones at ask, at trade price until the side price is known.
+///        Money amounts use symbol point value (tick value / tick size). Until symbol is subscribed
+///        it's unknown, P/L of fills is booked in price points then and converted once point value is known.
+///        Position numbers & symbol mark prices are kept in PortfolioColumns, so quote update sets symbol prices
+///        only and account totals are vectorized. Until symbol prices are known its positions are marked
+///        at the last fill price or at price implied by OTE CQGCEL reported on positions reload.
+///        Updated from CQGCEL thread, read from any thread.
+class PositionBook
+{
+public:
+
+   /// @brief Replaces account positions, e.g. by ones CQGCEL reports after positions reload.
+   /// @param symbolIds [in] identifiers of positions symbols, symbolIds[i] is identifier of positions[i].
+   void Reset(const ID& gwAccountID, const Positions& positions, const std::vector<SymbolId>& symbolIds);
+
+   /// @brief Sets symbol point value once symbol is subscribed, converts P/L booked in price points to money.
+   /// @param tickSize [in] symbol tick size, zero if unknown.
+   /// @param tickValue [in] money value of one tick, zero if unknown.
+   void SetPointValue(const SymbolId symbolId, const Price tickSize, const MoneyAmount tickValue);
+
+   /// @brief Applies order fill leg to account position, canceled fill is reverted by opposite fill.
+   /// @param buy [in] order side, negative leg quantity means opposite side.
+   void OnFill(const ID& gwAccountID, const SymbolId symbolId, bool buy, const FillInfo& fill);
+
+   /// @brief Remembers symbol prices and marks symbol positions to market.
+   void OnQuotes(const QuoteEvent& quotes);
+
+   /// @brief Gets account positions including flat ones with realized P/L.
+   /// @return False if account has no positions.
+   bool GetPositions(const ID& gwAccountID, Positions& positions) const;
+
+   /// @brief Gets account totals of positions OTE & P/L.
+   /// @return False if account has no positions.
+   bool GetProfitLoss(const ID& gwAccountID, MoneyAmount& ote, MoneyAmount& profitLoss) const;
+
+   /// @brief Gets totals of all accounts having positions.
+   void GetAccountsProfitLoss(AccountsProfitLoss& accounts) const;
+
+   /// @brief Drops all positions, keeps symbols prices.
+   void Clear();
+
+private:
+
+   /// @brief Position properties besides PortfolioColumns values.
+   struct Position
+   {
+      ID gwAccountID;      ///< Position account.
+      SymbolId symbolId;   ///< Position symbol.
+      CString symbol;      ///< Position symbol full name.
+      MoneyAmount pointsProfitLoss;   ///< Realized P/L in price points booked while point value is unknown.
+   };
+
+   /// @brief Symbol prices & its positions.
+   struct Symbol
+   {
+      Symbol():
+         bid(InvalidPrice),
+         ask(InvalidPrice),
+         trade(InvalidPrice),
+         impliedPrice(InvalidPrice),
+         impliedAverage(InvalidPrice),
+         pointValue(1.0),
+         pointValueKnown(false)
+      {}
+
+      /// @brief Checks whether any symbol price is known.
+      bool HasPrices() const
+      {
+         return bid != InvalidPrice || ask != InvalidPrice || trade != InvalidPrice;
+      }
+
+      Price bid;                               ///< The last bid price.
+      Price ask;                               ///< The last ask price.
+      Price trade;                             ///< The last trade price.
+      Price impliedPrice;                      ///< Mark price while symbol prices are unknown.
+      Price impliedAverage;                    ///< Average price of position OTE implied mark price, if any.
+      double pointValue;                       ///< Money value of one price point, 1 until it's known.
+      bool pointValueKnown;                    ///< True once symbol is subscribed & its point value is set.
+      std::vector<PositionHandle> positions;   ///< Symbol positions.
+   };
+
+   typedef std::unordered_map<ID, std::vector<PositionHandle> > AccountPositions;
+
+   /// @brief Gets symbol state, adds it if needed.
+   Symbol& getSymbol(const SymbolId symbolId);
+
+   /// @brief Finds account position of symbol, adds flat one if needed.
+   PositionHandle getPosition(const ID& gwAccountID, const SymbolId symbolId, const CString& symbol);
+
+   /// @brief Sets prices symbol positions are marked at: long at bid, short at ask, trade or implied price
+   ///        if side price is unknown. Must be called under lock.
+   void markSymbol(const SymbolId symbolId, const Symbol& symbol);
+
+   /// @brief Gets price positions of given side are marked at.
+   static Price getMarkPrice(const Symbol& symbol, Price sidePrice);
+
+   mutable std::mutex m_lock;          ///< Guards positions, symbols are touched by CQGCEL thread only.
+   PortfolioColumns m_columns;         ///< Positions numbers by handle.
+   std::vector<Position> m_positions;  ///< Positions properties by handle.
+   AccountPositions m_accounts;        ///< Positions by gateway account ID.
+   std::vector<Symbol> m_symbols;      ///< Symbols by identifier.
+};
+
+} // namespace cqg
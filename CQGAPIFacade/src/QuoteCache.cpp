@@ -0,0 +1,95 @@
+/// @file QuoteCache.cpp
+/// @brief Simple C++ facade for CQG API - last known symbol quotes implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "QuoteCache.h"
+
+namespace cqg
+{
+
+void QuoteCache::Update(const QuoteEvent& quotes, QuoteEvent& changed)
+{
+   changed.symbolId = quotes.symbolId;
+   changed.count = 0;
+   changed.changedMask = 0;
+
+   if(quotes.symbolId == InvalidSymbolId)
+   {
+      ATLASSERT(0);
+      return;
+   }
+
+   if(quotes.symbolId >= m_symbols.size())
+   {
+      m_symbols.resize(quotes.symbolId + 1);
+   }
+
+   SymbolQuotes& state = m_symbols[quotes.symbolId];
+
+   for(unsigned i = 0; i < quotes.count; ++i)
+   {
+      const QuoteInfo& quote = quotes.quotes[i];
+      if(quote.type == QuoteInfo::Unknown || quote.type > QuoteInfo::Low)
+      {
+         continue;
+      }
+
+      const unsigned mask = QuoteEvent::TypeMask(quote.type);
+      QuoteInfo& last = state.quotes[quote.type - 1];
+
+      // New trade may have the same price & volume as previous one, only its time differs.
+      if((state.validMask & mask) && last.price == quote.price && last.volume == quote.volume &&
+         (quote.type != QuoteInfo::Trade || last.timestamp == quote.timestamp))
+      {
+         continue;
+      }
+
+      state.validMask |= mask;
+      last = quote;
+
+      if(!(changed.changedMask & mask))
+      {
+         changed.quotes[changed.count++] = quote;
+         changed.changedMask |= mask;
+      }
+      else
+      {
+         // Several quotes of the same type in one update, the latest wins.
+         for(unsigned j = 0; j < changed.count; ++j)
+         {
+            if(changed.quotes[j].type == quote.type) changed.quotes[j] = quote;
+         }
+      }
+   }
+}
+
+bool QuoteCache::Get(const SymbolId id, QuoteEvent& quotes) const
+{
+   quotes.symbolId = id;
+   quotes.count = 0;
+   quotes.changedMask = 0;
+
+   if(id >= m_symbols.size())
+   {
+      return false;
+   }
+
+   const SymbolQuotes& state = m_symbols[id];
+   for(unsigned i = 0; i < QuoteEvent::MaxQuotes; ++i)
+   {
+      const QuoteInfo::Type type = static_cast<QuoteInfo::Type>(i + 1);
+      if(state.validMask & QuoteEvent::TypeMask(type))
+      {
+         quotes.quotes[quotes.count++] = state.quotes[i];
+         quotes.changedMask |= QuoteEvent::TypeMask(type);
+      }
+   }
+
+   return true;
+}
+
+} // namespace cqg
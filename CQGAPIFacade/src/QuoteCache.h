@@ -0,0 +1,48 @@
+/// @file QuoteCache.h
+/// @brief Simple C++ facade for CQG API - last known symbol quotes.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+
+#include <vector>
+
+namespace cqg
+{
+
+/// @class QuoteCache
+/// @brief Keeps last known value of each quote type per symbol and
+///        extracts quotes actually changed by incoming update.
+class QuoteCache
+{
+public:
+
+   /// @brief Applies quotes update to symbol state.
+   /// @param quotes [in] incoming quotes, symbolId must be valid.
+   /// @param changed [out] quotes which price or volume differ from previously known,
+   ///                      symbol state is updated with them.
+   void Update(const QuoteEvent& quotes, QuoteEvent& changed);
+
+   /// @brief Gets all known quotes of symbol.
+   /// @return False if nothing is known about symbol.
+   bool Get(const SymbolId id, QuoteEvent& quotes) const;
+
+private:
+
+   /// @brief Per symbol state, quotes are indexed by quote type - 1.
+   struct SymbolQuotes
+   {
+      SymbolQuotes(): validMask(0)
+      {}
+
+      unsigned validMask;                       ///< Types of quotes received so far.
+      QuoteInfo quotes[QuoteEvent::MaxQuotes];  ///< Last known quotes.
+   };
+
+   std::vector<SymbolQuotes> m_symbols; ///< States indexed by symbol identifier.
+};
+
+} // namespace cqg
@@ -0,0 +1,117 @@
+/// @file QuoteConflator.cpp
+/// @brief Simple C++ facade for CQG API - per symbol quote updates conflation implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "QuoteConflator.h"
+
+namespace cqg
+{
+
+namespace
+{
+
+/// @brief Merges quotes into pending update, the latest quote of each type wins.
+void MergeQuotes(QuoteEvent& pending, const QuoteEvent& quotes)
+{
+   for(unsigned i = 0; i < quotes.count; ++i)
+   {
+      const QuoteInfo& quote = quotes.quotes[i];
+      const unsigned mask = QuoteEvent::TypeMask(quote.type);
+
+      if(pending.changedMask & mask)
+      {
+         for(unsigned j = 0; j < pending.count; ++j)
+         {
+            if(pending.quotes[j].type == quote.type) pending.quotes[j] = quote;
+         }
+      }
+      else if(pending.count < QuoteEvent::MaxQuotes)
+      {
+         pending.quotes[pending.count++] = quote;
+         pending.changedMask |= mask;
+      }
+   }
+}
+
+} // namespace
+
+void QuoteConflator::AddSymbol(const SymbolId id, const CString& fullName)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   if(id >= m_slots.size())
+   {
+      m_slots.resize(id + 1);
+   }
+
+   m_slots[id].quotes.symbolId = id;
+   m_slots[id].fullName = fullName;
+}
+
+bool QuoteConflator::Push(const QuoteEvent& quotes)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   if(quotes.symbolId == InvalidSymbolId)
+   {
+      ATLASSERT(0);
+      return false;
+   }
+
+   if(quotes.symbolId >= m_slots.size())
+   {
+      m_slots.resize(quotes.symbolId + 1);
+   }
+
+   Slot& slot = m_slots[quotes.symbolId];
+   slot.quotes.symbolId = quotes.symbolId;
+   MergeQuotes(slot.quotes, quotes);
+
+   if(slot.pending)
+   {
+      ++m_merged;
+      return false;
+   }
+
+   slot.pending = true;
+   m_pending.push_back(quotes.symbolId);
+
+   return m_pending.size() == 1;
+}
+
+void QuoteConflator::Take(std::vector<QuoteEvent>& updates, const size_t maxSymbols)
+{
+   updates.clear();
+
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   while(!m_pending.empty() && updates.size() < maxSymbols)
+   {
+      Slot& slot = m_slots[m_pending.front()];
+      m_pending.pop_front();
+
+      updates.push_back(slot.quotes);
+
+      slot.pending = false;
+      slot.quotes.count = 0;
+      slot.quotes.changedMask = 0;
+   }
+}
+
+CString QuoteConflator::GetName(const SymbolId id) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+   return id < m_slots.size() ? m_slots[id].fullName : CString();
+}
+
+unsigned long long QuoteConflator::GetMergedCount() const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+   return m_merged;
+}
+
+} // namespace cqg
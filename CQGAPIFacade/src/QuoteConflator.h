@@ -0,0 +1,69 @@
+/// @file QuoteConflator.h
+/// @brief Simple C++ facade for CQG API - per symbol quote updates conflation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace cqg
+{
+
+/// @class QuoteConflator
+/// @brief Keeps at most one pending update per symbol, merging all updates received
+///        since symbol was taken last time. Producer & consumer can work on different threads.
+class QuoteConflator
+{
+public:
+
+   QuoteConflator(): m_merged(0)
+   {}
+
+   /// @brief Registers subscribed symbol.
+   void AddSymbol(const SymbolId id, const CString& fullName);
+
+   /// @brief Merges quotes update into pending update of the symbol.
+   /// @return True if there were no pending updates before, so consumer should be notified.
+   bool Push(const QuoteEvent& quotes);
+
+   /// @brief Takes pending updates in order symbols became pending.
+   /// @param updates [out] taken updates.
+   /// @param maxSymbols [in] maximum number of updates to take.
+   void Take(std::vector<QuoteEvent>& updates, const size_t maxSymbols);
+
+   /// @brief Gets full name of registered symbol.
+   CString GetName(const SymbolId id) const;
+
+   /// @brief Gets number of updates merged into already pending ones.
+   unsigned long long GetMergedCount() const;
+
+private:
+
+   /// @brief Per symbol state.
+   struct Slot
+   {
+      Slot(): pending(false)
+      {
+         quotes.symbolId = InvalidSymbolId;
+         quotes.count = 0;
+         quotes.changedMask = 0;
+      }
+
+      bool pending;        ///< True if symbol is in pending queue.
+      QuoteEvent quotes;   ///< Pending update.
+      CString fullName;    ///< Symbol full name.
+   };
+
+   mutable std::mutex m_lock;          ///< Guards all members.
+   std::vector<Slot> m_slots;          ///< States indexed by symbol identifier.
+   std::deque<SymbolId> m_pending;     ///< Pending symbols in order they became pending.
+   unsigned long long m_merged;        ///< Number of updates merged into pending ones.
+};
+
+} // namespace cqg
@@ -0,0 +1,1196 @@
+/// @file SimulatedBackend.cpp
+/// @brief Simple C++ facade for CQG API - deterministic simulated CQGCEL backend.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "Backend.h"
+#include "SymbolTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace cqg
+{
+
+namespace
+{
+
+const double MillisecondsPerDay = 24.0 * 60.0 * 60.0 * 1000.0;
+const double MinutesPerDay = 24.0 * 60.0;
+
+/// @brief Max number of bars simulated per request.
+const long MaxSimulatedBars = 100000;
+
+/// @class Random
+/// @brief Xorshift pseudo random generator, gives the same sequence on every platform.
+class Random
+{
+public:
+
+   explicit Random(unsigned seed): m_state(seed ? seed : 0x9E3779B9u)
+   {}
+
+   unsigned Next()
+   {
+      m_state ^= m_state << 13;
+      m_state ^= m_state >> 17;
+      m_state ^= m_state << 5;
+      return m_state;
+   }
+
+   /// @brief Returns number in range [0, range).
+   unsigned Next(unsigned range)
+   {
+      return range ? Next() % range : 0;
+   }
+
+private:
+   unsigned m_state;
+};
+
+/// @brief Scrambles bits of value, so close values give unrelated results.
+unsigned Mix(unsigned value)
+{
+   value ^= value >> 16;
+   value *= 0x7FEB352Du;
+   value ^= value >> 15;
+   value *= 0x846CA68Bu;
+   value ^= value >> 16;
+   return value;
+}
+
+/// @brief Checks whether symbol can be resolved by simulated CQGCEL.
+bool IsValidSymbol(const CString& symbol)
+{
+   if(symbol.IsEmpty())
+   {
+      return false;
+   }
+
+   for(const char* ch = symbol.GetString(); *ch; ++ch)
+   {
+      const bool valid = (*ch >= 'A' && *ch <= 'Z') || (*ch >= '0' && *ch <= '9') || *ch == '.';
+      if(!valid) return false;
+   }
+
+   return true;
+}
+
+/// @brief Gets full name simulated CQGCEL resolves symbol to.
+CString GetFullName(const CString& symbol)
+{
+   return symbol.Find('.') >= 0 ? symbol : CString("F.US.") + symbol + "Z5";
+}
+
+/// @brief Appends quote to quote event.
+void AddQuote(QuoteEvent& quotes, QuoteInfo::Type type, Price price, Volume volume, DATE timestamp)
+{
+   ATLASSERT(quotes.count < QuoteEvent::MaxQuotes);
+
+   QuoteInfo& quote = quotes.quotes[quotes.count++];
+   quote.type = type;
+   quote.price = price;
+   quote.volume = volume;
+   quote.timestamp = timestamp;
+
+   quotes.changedMask |= QuoteEvent::TypeMask(type);
+}
+
+} // namespace
+
+/// @class SimulatedBackend
+/// @brief In-process CQGCEL model generating subscriptions, quotes, order lifecycle and bars.
+///        Everything happens on the thread calling PumpEvents(), same as CQGCEL
+///        delivers events on its STA thread, so no locking is needed.
+class SimulatedBackend : public IBackend
+{
+public:
+
+   explicit SimulatedBackend(const SimulationSettings& settings):
+      m_settings(settings),
+      m_random(settings.seed),
+      m_events(NULL),
+      m_defaultLevel(TradesAndBBALevel),
+      m_lineTime(settings.startTime.m_dt),
+      m_nextInstrument(0),
+      m_quotesCount(0),
+      m_ordersCount(0),
+      m_barRequestsCount(0)
+   {
+      if(m_settings.tickSize <= 0.0) m_settings.tickSize = 0.01;
+      if(m_settings.tradeRatio == 0) m_settings.tradeRatio = 1;
+   }
+
+   /// @name IBackend implementation.
+   /// @{
+
+   virtual void Startup(IBackendEvents* events, const FacadeSettings& settings)
+   {
+      m_events = events;
+      m_defaultLevel = settings.marketDepth ? TradesAndDOMLevel : TradesAndBBALevel;
+
+      m_accounts.clear();
+      for(unsigned i = 0; i < m_settings.accountsCount; ++i)
+      {
+         AccountInfo account;
+         account.fcmID = 1;
+         account.fcmAccountID.Format("SIM%05u", i + 1);
+         account.gwAccountID = static_cast<ID>(100001 + i);
+         account.gwAccountName.Format("Simulated %u", i + 1);
+         account.currency = "USD";
+         account.balance = 1000000.0;
+         account.ote = 0.0;
+         account.profitLoss = 0.0;
+         m_accounts.push_back(account);
+      }
+
+      post(std::bind(&IBackendEvents::OnDataConnectionStatusChanged, m_events, true));
+      post(std::bind(&IBackendEvents::OnGWConnectionStatusChanged, m_events, true));
+      post(std::bind(&IBackendEvents::OnAccountsReloaded, m_events));
+      post(std::bind(&IBackendEvents::OnPositionsReloaded, m_events));
+   }
+
+   virtual void Shutdown() throw()
+   {
+      m_events = NULL;
+      m_pending.clear();
+   }
+
+   virtual unsigned PumpEvents(unsigned maxEvents)
+   {
+      unsigned delivered = 0;
+
+      while(delivered < maxEvents && m_events)
+      {
+         if(!m_pending.empty())
+         {
+            const Event event = m_pending.front();
+            m_pending.pop_front();
+            event();
+         }
+         else if(!m_instruments.empty())
+         {
+            simulateQuote();
+         }
+         else
+         {
+            break;
+         }
+
+         ++delivered;
+      }
+
+      return delivered;
+   }
+
+   virtual void Post(const std::function<void()>& call)
+   {
+      post(call);
+   }
+
+   virtual bool NewInstrument(const CString& symbol, CString& /*error*/)
+   {
+      if(!IsValidSymbol(symbol))
+      {
+         post(std::bind(&IBackendEvents::OnIncorrectSymbol, m_events, symbol));
+         return true;
+      }
+
+      const CString fullName = GetFullName(symbol);
+
+      size_t index = findInstrument(fullName);
+      if(index == m_instruments.size())
+      {
+         Instrument instrument;
+         instrument.id = InvalidSymbolId;
+         instrument.subscribed = false;
+         instrument.level = NoQuotesLevel;
+         instrument.fullName = fullName;
+         instrument.trade = roundToTick(m_settings.startPrice);
+         instrument.bid = instrument.trade - m_settings.tickSize;
+         instrument.ask = instrument.trade + m_settings.tickSize;
+         instrument.bidVolume = 1;
+         instrument.askVolume = 1;
+         instrument.tradeVolume = 1;
+         instrument.tradeTime = m_lineTime;
+         instrument.quoteTime = m_lineTime;
+
+         for(unsigned i = 0; i < MarketDepth::MaxLevels; ++i)
+         {
+            instrument.bidDepth[i] = 10 * (i + 1);
+            instrument.askDepth[i] = 10 * (i + 1);
+         }
+         instrument.high = instrument.trade;
+         instrument.low = instrument.trade;
+         instrument.close = instrument.trade;
+         m_instruments.push_back(instrument);
+         m_instrumentIndex[fullName] = index;
+      }
+
+      post(std::bind(&SimulatedBackend::fireInstrumentSubscribed, this, symbol, index));
+      return true;
+   }
+
+   virtual bool RemoveInstrument(const SymbolId id, CString& error)
+   {
+      Instrument* instrument = findSubscribed(id, error);
+      if(!instrument)
+      {
+         return false;
+      }
+
+      instrument->subscribed = false;
+      return true;
+   }
+
+   virtual bool SetSubscriptionLevel(const SymbolId id, const SubscriptionLevel level, CString& error)
+   {
+      Instrument* instrument = findSubscribed(id, error);
+      if(!instrument)
+      {
+         return false;
+      }
+
+      if(level == TradesAndDOMLevel && instrument->level != TradesAndDOMLevel)
+      {
+         post(std::bind(&SimulatedBackend::fireDOMChanged, this, id));
+      }
+
+      instrument->level = level;
+      return true;
+   }
+
+   virtual CString RequestTimedBars(const BarsRequest& barsRequest, CString& error)
+   {
+      if(barsRequest.intradayPeriodInMinutes <= 0)
+      {
+         error = "Invalid intraday period.";
+         return CString();
+      }
+
+      Bars bars;
+      bars.requestGuid.Format("{SIM-BARS-%08u}", ++m_barRequestsCount);
+
+      const double period = barsRequest.intradayPeriodInMinutes / MinutesPerDay;
+      const double lastBar = std::floor(m_lineTime / period + 1e-6) * period;
+
+      long count = 0;
+      double firstBar = lastBar;
+
+      if(barsRequest.useIndexRange)
+      {
+         // Index 0 is the current bar, older bars have negative indexes.
+         const long newest = std::min(std::max(barsRequest.startIndex, barsRequest.endIndex), 0L);
+         count = std::abs(barsRequest.startIndex - barsRequest.endIndex) + 1;
+         count = std::min(count, MaxSimulatedBars);
+         firstBar = lastBar + (newest - count + 1) * period;
+      }
+      else
+      {
+         // Times exactly at bar start may be rounded, so they must not skip to the next bar.
+         const double start = std::ceil(barsRequest.startDate.m_dt / period - 1e-6) * period;
+         const double end = std::min(barsRequest.endDate.m_dt, lastBar);
+         count = end < start ? 0 : static_cast<long>((end - start) / period + 0.5) + 1;
+         count = std::min(count, MaxSimulatedBars);
+         firstBar = start;
+      }
+
+      bars.requestedCount = count;
+      bars.bars.reserve(count);
+
+      // Bar depends on symbol, period & bar time only, so overlapping requests get the same bars.
+      const unsigned seed = m_settings.seed ^ static_cast<unsigned>(CStringHash()(barsRequest.symbol)) ^
+         barsRequest.intradayPeriodInMinutes;
+
+      for(long i = 0; i < count; ++i)
+      {
+         const long long barNumber = static_cast<long long>(std::floor(firstBar / period + 0.5)) + i;
+         Random random(Mix(seed ^ static_cast<unsigned>(barNumber)));
+
+         BarInfo bar;
+         bar.timestamp = COleDateTime(barNumber * period);
+         bar.open = getBarClose(seed, barNumber - 1);
+         bar.close = getBarClose(seed, barNumber);
+         bar.high = std::max(bar.open, bar.close) + random.Next(3) * m_settings.tickSize;
+         bar.low = std::min(bar.open, bar.close) - random.Next(3) * m_settings.tickSize;
+         bar.volume = 1 + random.Next(1000);
+         bars.bars.push_back(bar);
+      }
+
+      // Bars ending in the past are never updated.
+      if(barsRequest.subscribe && count > 0 && (barsRequest.useIndexRange || barsRequest.endDate.m_dt >= lastBar))
+      {
+         LiveBars& live = m_liveBars[bars.requestGuid];
+         live.fullName = GetFullName(barsRequest.symbol);
+         live.period = period;
+         live.count = count;
+         live.last = bars.bars.back();
+      }
+
+      post(std::bind(&IBackendEvents::OnTimedBarsResolved, m_events, bars));
+      return bars.requestGuid;
+   }
+
+   virtual bool RemoveTimedBars(const CString& requestGuid, CString& /*error*/)
+   {
+      // Bars ending in the past are not live, but can be removed as well.
+      m_liveBars.erase(requestGuid);
+      return true;
+   }
+
+   virtual bool GWLogon(const CString& /*user*/, const CString& /*password*/, CString& /*error*/)
+   {
+      post(std::bind(&IBackendEvents::OnGWConnectionStatusChanged, m_events, true));
+      return true;
+   }
+
+   virtual COleDateTime GetLineTime(CString& /*error*/)
+   {
+      return COleDateTime(m_lineTime);
+   }
+
+   virtual bool GetAccounts(Accounts& accounts, CString& /*error*/)
+   {
+      accounts = m_accounts;
+      return true;
+   }
+
+   virtual bool GetPositions(const ID& gwAccountID, Positions& positions, CString& error)
+   {
+      if(!findAccount(gwAccountID))
+      {
+         error = "Account not found.";
+         return false;
+      }
+
+      for(PositionsMap::const_iterator it = m_positions.begin(); it != m_positions.end(); ++it)
+      {
+         if(it->first.first == gwAccountID && it->second.quantity != 0)
+         {
+            positions.push_back(it->second);
+         }
+      }
+
+      return true;
+   }
+
+   virtual CString PlaceOrder(
+      OrderType type,
+      const ID& gwAccountID,
+      const CString& symbolFullName,
+      bool buy,
+      Quantity quantity,
+      const CString& description,
+      const OrderPrice& price,
+      const OrderPrice& stopLimitPrice,
+      CString& error)
+   {
+      PreparedOrder order;
+      if(!prepareOrder(type, gwAccountID, symbolFullName, buy, description, order, error))
+      {
+         return CString();
+      }
+
+      return placeOrder(order, price, quantity, stopLimitPrice, error);
+   }
+
+   virtual bool PrepareOrderTicket(OrderTicketId ticketId, const OrderTicket& ticket, CString& error)
+   {
+      PreparedOrder order;
+      if(!prepareOrder(ticket.type, ticket.gwAccountID, ticket.symbolFullName, ticket.buy, ticket.description,
+         order, error))
+      {
+         return false;
+      }
+
+      if(ticketId >= m_tickets.size())
+      {
+         m_tickets.resize(ticketId + 1);
+      }
+
+      m_tickets[ticketId] = order;
+      return true;
+   }
+
+   virtual CString SubmitOrderTicket(
+      OrderTicketId ticketId,
+      const OrderPrice& price,
+      Quantity quantity,
+      const OrderPrice& stopLimitPrice,
+      CString& error)
+   {
+      if(ticketId >= m_tickets.size() || m_tickets[ticketId].instrument >= m_instruments.size())
+      {
+         error = "Order ticket not found.";
+         return CString();
+      }
+
+      return placeOrder(m_tickets[ticketId], price, quantity, stopLimitPrice, error);
+   }
+
+   virtual void ReleaseOrderTicket(OrderTicketId ticketId)
+   {
+      if(ticketId < m_tickets.size())
+      {
+         m_tickets[ticketId] = PreparedOrder();
+      }
+   }
+
+   virtual void PlaceOrders(const OrderRequests& orders, OrderResults& results)
+   {
+      results.resize(orders.size());
+
+      PreparedOrder prepared;
+      const OrderRequest* last = NULL;
+
+      for(size_t i = 0; i < orders.size(); ++i)
+      {
+         const OrderRequest& order = orders[i];
+         OrderResult& result = results[i];
+
+         // Orders of the same account & symbol reuse previous resolving.
+         if(last == NULL || order.gwAccountID != last->gwAccountID || order.symbolFullName != last->symbolFullName)
+         {
+            last = NULL;
+            if(!prepareOrder(order.type, order.gwAccountID, order.symbolFullName, order.buy, order.description,
+               prepared, result.error))
+            {
+               continue;
+            }
+
+            last = &order;
+         }
+
+         prepared.type = order.type;
+         prepared.buy = order.buy;
+         prepared.description = order.description;
+         result.orderGuid = placeOrder(prepared, order.price, order.quantity, order.stopLimitPrice, result.error);
+      }
+   }
+
+   virtual bool CancelOrder(const CString& orderGuid, CString& error)
+   {
+      const OrderIndex::const_iterator it = m_orderIndex.find(orderGuid);
+      if(it == m_orderIndex.end())
+      {
+         error = "Order with given guid not found.";
+         return false;
+      }
+
+      if(m_orders[it->second].info.final)
+      {
+         error = "Order cannot be cancelled.";
+         return false;
+      }
+
+      post(std::bind(&SimulatedBackend::cancelOrder, this, it->second));
+      return true;
+   }
+
+   virtual bool ModifyOrder(
+      const CString& orderGuid,
+      const OrderPrice& price,
+      const OrderPrice& stopLimitPrice,
+      Quantity quantity,
+      CString& error)
+   {
+      const OrderIndex::const_iterator it = m_orderIndex.find(orderGuid);
+      if(it == m_orderIndex.end())
+      {
+         error = "Order with given guid not found.";
+         return false;
+      }
+
+      Order& order = m_orders[it->second];
+      if(order.info.final)
+      {
+         error = "Order cannot be modified.";
+         return false;
+      }
+
+      if((order.type == Market && price.initialized()) ||
+         (order.type != StopLimit && stopLimitPrice.initialized()))
+      {
+         error = "Invalid order parameters.";
+         return false;
+      }
+
+      // Gateway reports order in modification, then acknowledges modification with the next order change.
+      order.info.modifyPending = true;
+      post(std::bind(&SimulatedBackend::fireOrderChanged, this, it->second));
+      post(std::bind(&SimulatedBackend::modifyOrder, this, it->second,
+         price.initialized() ? price.price() : order.price,
+         stopLimitPrice.initialized() ? stopLimitPrice.price() : order.stopLimitPrice,
+         quantity ? quantity : order.info.quantity));
+
+      return true;
+   }
+
+   virtual void CancelOrders(const OrderGuids& orderGuids, OrderResults& results)
+   {
+      for(size_t i = 0; i < orderGuids.size(); ++i)
+      {
+         if(results[i].error.IsEmpty())
+         {
+            CancelOrder(orderGuids[i], results[i].error);
+         }
+      }
+   }
+
+   virtual bool CancelAllOrders(const ID& gwAccountID, const CString& symbolFullName, CString& /*error*/)
+   {
+      for(size_t i = 0; i < m_orders.size(); ++i)
+      {
+         const OrderInfo& info = m_orders[i].info;
+         if(!info.final &&
+            (gwAccountID == ID() || info.gwAccountID == gwAccountID) &&
+            (symbolFullName.IsEmpty() || info.symbol == symbolFullName))
+         {
+            post(std::bind(&SimulatedBackend::cancelOrder, this, i));
+         }
+      }
+
+      return true;
+   }
+
+   /// @}
+
+private:
+
+   typedef std::function<void()> Event;
+
+   /// @brief Simulated instrument state.
+   struct Instrument
+   {
+      SymbolId id;
+      bool subscribed;
+      SubscriptionLevel level;
+      CString fullName;
+      Price bid;
+      Price ask;
+      Price trade;
+      Volume bidVolume;
+      Volume askVolume;
+      Volume tradeVolume;
+      DATE tradeTime;
+      DATE quoteTime;
+      Price high;
+      Price low;
+      Price close;
+      Volume bidDepth[MarketDepth::MaxLevels];   ///< DOM volumes, best bid level first.
+      Volume askDepth[MarketDepth::MaxLevels];   ///< DOM volumes, best ask level first.
+      std::vector<size_t> workingOrders;         ///< Indexes of working orders in placing order.
+   };
+
+   /// @brief Order parameters resolved ahead of placing.
+   struct PreparedOrder
+   {
+      PreparedOrder(): type(Market), gwAccountID(0), instrument(static_cast<size_t>(-1)), buy(false)
+      {}
+
+      OrderType type;
+      ID gwAccountID;
+      size_t instrument;
+      bool buy;
+      CString description;
+   };
+
+   /// @brief Simulated order state.
+   struct Order
+   {
+      OrderInfo info;
+      OrderType type;
+      size_t instrument;
+      Price price;
+      Price stopLimitPrice;
+      bool triggered;
+      long fillsCount;
+   };
+
+   /// @brief Subscribed bars request state.
+   struct LiveBars
+   {
+      CString fullName;   ///< Full name of bars symbol.
+      double period;      ///< Bar period in days.
+      long count;         ///< Number of reported bars.
+      BarInfo last;       ///< Last reported bar.
+   };
+
+   typedef std::vector<Instrument> Instruments;
+   typedef std::map<CString, LiveBars> LiveBarsMap;
+   typedef std::vector<Order> Orders;
+   typedef std::vector<PreparedOrder> PreparedOrders;
+   typedef std::map<CString, size_t> OrderIndex;
+   typedef std::unordered_map<CString, size_t, CStringHash> InstrumentIndex;
+   typedef std::map<std::pair<ID, CString>, PositionInfo> PositionsMap;
+
+   /// @brief Checks order account & symbol.
+   bool prepareOrder(
+      OrderType type,
+      const ID& gwAccountID,
+      const CString& symbolFullName,
+      bool buy,
+      const CString& description,
+      PreparedOrder& order,
+      CString& error) const
+   {
+      if(!findAccount(gwAccountID))
+      {
+         error = "Account not found.";
+         return false;
+      }
+
+      order.instrument = findInstrument(symbolFullName);
+      if(order.instrument == m_instruments.size())
+      {
+         error = "Instrument not found.";
+         return false;
+      }
+
+      order.type = type;
+      order.gwAccountID = gwAccountID;
+      order.buy = buy;
+      order.description = description;
+      return true;
+   }
+
+   /// @brief Places order of prepared parameters.
+   CString placeOrder(
+      const PreparedOrder& prepared,
+      const OrderPrice& price,
+      Quantity quantity,
+      const OrderPrice& stopLimitPrice,
+      CString& error)
+   {
+      const OrderType type = prepared.type;
+
+      if(quantity == 0 || (type != Market && !price.initialized()) ||
+         (type == StopLimit && !stopLimitPrice.initialized()))
+      {
+         error = "Invalid order parameters.";
+         return CString();
+      }
+
+      Order order;
+      order.type = type;
+      order.instrument = prepared.instrument;
+      order.price = price.initialized() ? price.price() : InvalidPrice;
+      order.stopLimitPrice = stopLimitPrice.initialized() ? stopLimitPrice.price() : InvalidPrice;
+      order.triggered = false;
+      order.fillsCount = 0;
+
+      ++m_ordersCount;
+      order.info.orderGuid.Format("{SIM-ORDER-%08u}", m_ordersCount);
+      order.info.gwOrderID.Format("%u", 50000000 + m_ordersCount);
+      order.info.symbol = m_instruments[prepared.instrument].fullName;
+      order.info.gwAccountID = prepared.gwAccountID;
+      order.info.buy = prepared.buy;
+      order.info.final = false;
+      order.info.modifyPending = false;
+      order.info.fillSeq = 0;
+      order.info.quantity = quantity;
+      order.info.filledQty = 0;
+      order.info.description = prepared.description;
+
+      m_orders.push_back(order);
+      m_orderIndex[order.info.orderGuid] = m_orders.size() - 1;
+      m_instruments[prepared.instrument].workingOrders.push_back(m_orders.size() - 1);
+
+      post(std::bind(&SimulatedBackend::fireOrderChanged, this, m_orders.size() - 1));
+      post(std::bind(&SimulatedBackend::matchOrder, this, m_orders.size() - 1));
+
+      return order.info.orderGuid;
+   }
+
+   /// @brief Queues event to be delivered by PumpEvents().
+   void post(const Event& event)
+   {
+      if(m_events)
+      {
+         m_pending.push_back(event);
+      }
+   }
+
+   /// @brief Gets close price of historical bar: slow wave plus noise around start price.
+   Price getBarClose(unsigned seed, long long barNumber) const
+   {
+      const int wave = static_cast<int>(std::floor(40.0 * std::sin(barNumber / 50.0) + 0.5));
+      const int noise = static_cast<int>(Mix(seed ^ static_cast<unsigned>(barNumber) ^ 0x5BD1E995u) % 9) - 4;
+      return roundToTick(m_settings.startPrice + (wave + noise) * m_settings.tickSize);
+   }
+
+   Price roundToTick(Price price) const
+   {
+      return std::floor(price / m_settings.tickSize + 0.5) * m_settings.tickSize;
+   }
+
+   /// @brief Returns number of ticks between prices.
+   int ticksBetween(Price from, Price to) const
+   {
+      return static_cast<int>(std::floor((to - from) / m_settings.tickSize + 0.5));
+   }
+
+   /// @brief Finds subscribed instrument by identifier.
+   Instrument* findSubscribed(const SymbolId id, CString& error)
+   {
+      if(id >= m_indexById.size() || !m_instruments[m_indexById[id]].subscribed)
+      {
+         error = "Instrument not subscribed.";
+         return NULL;
+      }
+
+      return &m_instruments[m_indexById[id]];
+   }
+
+   size_t findInstrument(const CString& fullName) const
+   {
+      const InstrumentIndex::const_iterator it = m_instrumentIndex.find(fullName);
+      return it != m_instrumentIndex.end() ? it->second : m_instruments.size();
+   }
+
+   const AccountInfo* findAccount(const ID& gwAccountID) const
+   {
+      for(Accounts::const_iterator it = m_accounts.begin(); it != m_accounts.end(); ++it)
+      {
+         if(it->gwAccountID == gwAccountID) return &*it;
+      }
+
+      return NULL;
+   }
+
+   void fireInstrumentSubscribed(const CString& requestedSymbol, size_t index)
+   {
+      Instrument& instrument = m_instruments[index];
+
+      QuoteEvent quotes;
+      quotes.symbolId = InvalidSymbolId;
+      GetAllQuotes(instrument, quotes);
+
+      if(!instrument.subscribed)
+      {
+         instrument.subscribed = true;
+         instrument.level = m_defaultLevel;
+      }
+
+      // Simulated P/L is in price points, so tick value equals tick size.
+      instrument.id = m_events->OnInstrumentSubscribed(requestedSymbol, instrument.fullName,
+         m_settings.tickSize, m_settings.tickSize, quotes);
+
+      if(instrument.id >= m_indexById.size())
+      {
+         m_indexById.resize(instrument.id + 1);
+      }
+      m_indexById[instrument.id] = index;
+
+      if(instrument.level == TradesAndDOMLevel)
+      {
+         fireDOMChanged(instrument.id);
+      }
+   }
+
+   /// @brief Fires market depth event with levels going one tick apart from BBA.
+   void fireDOMChanged(const SymbolId id)
+   {
+      const Instrument& instrument = m_instruments[m_indexById[id]];
+
+      MarketDepth depth;
+      depth.symbolId = instrument.id;
+      depth.bidsCount = 0;
+      depth.asksCount = 0;
+
+      for(unsigned i = 0; i < MarketDepth::MaxLevels; ++i)
+      {
+         const Price bid = instrument.bid - i * m_settings.tickSize;
+         if(bid >= m_settings.tickSize / 2)
+         {
+            depth.bids[depth.bidsCount].price = bid;
+            depth.bids[depth.bidsCount].volume = instrument.bidDepth[i];
+            ++depth.bidsCount;
+         }
+
+         depth.asks[depth.asksCount].price = instrument.ask + i * m_settings.tickSize;
+         depth.asks[depth.asksCount].volume = instrument.askDepth[i];
+         ++depth.asksCount;
+      }
+
+      m_events->OnInstrumentDOMChanged(depth);
+   }
+
+   /// @brief Moves DOM side volumes when side best price moves, so volumes stay at the same prices.
+   /// @param volumes [in, out] side volumes, best level first.
+   /// @param shift [in] number of ticks best level moved away from the opposite side.
+   void shiftDepth(Volume* volumes, int shift)
+   {
+      const int levels = MarketDepth::MaxLevels;
+      shift = std::max(-levels, std::min(levels, shift));
+
+      if(shift > 0)
+      {
+         // Best levels are gone, deeper levels become visible.
+         std::copy(volumes + shift, volumes + levels, volumes);
+         for(int i = levels - shift; i < levels; ++i) volumes[i] = 1 + m_random.Next(100);
+      }
+      else if(shift < 0)
+      {
+         // New best levels appeared.
+         std::copy_backward(volumes, volumes + levels + shift, volumes + levels);
+         for(int i = 0; i < -shift; ++i) volumes[i] = 1 + m_random.Next(100);
+      }
+   }
+
+   /// @brief Fills quote event with all instrument quotes, as CQGCEL quotes collection has.
+   static void GetAllQuotes(const Instrument& instrument, QuoteEvent& quotes)
+   {
+      quotes.count = 0;
+      quotes.changedMask = 0;
+      AddQuote(quotes, QuoteInfo::Ask, instrument.ask, instrument.askVolume, instrument.quoteTime);
+      AddQuote(quotes, QuoteInfo::Bid, instrument.bid, instrument.bidVolume, instrument.quoteTime);
+      AddQuote(quotes, QuoteInfo::Trade, instrument.trade, instrument.tradeVolume, instrument.tradeTime);
+      AddQuote(quotes, QuoteInfo::Close, instrument.close, 0, instrument.quoteTime);
+      AddQuote(quotes, QuoteInfo::High, instrument.high, 0, instrument.quoteTime);
+      AddQuote(quotes, QuoteInfo::Low, instrument.low, 0, instrument.quoteTime);
+   }
+
+   /// @brief Moves market of the next instrument in round robin manner & fires quote event.
+   ///        Like CQGCEL, whole quotes collection is reported even if only one side of BBA moved.
+   void simulateQuote()
+   {
+      const size_t index = m_nextInstrument++ % m_instruments.size();
+      Instrument& instrument = m_instruments[index];
+
+      m_lineTime += m_settings.quoteIntervalMs / MillisecondsPerDay;
+
+      if(!m_liveBars.empty())
+      {
+         addLiveBars();
+      }
+
+      if(instrument.id == InvalidSymbolId || !instrument.subscribed || instrument.level == NoQuotesLevel)
+      {
+         // Subscription is not reported yet or market data is off.
+         return;
+      }
+
+      instrument.quoteTime = m_lineTime;
+
+      const bool marketDepth = instrument.level == TradesAndDOMLevel;
+      bool quotesChanged = true;
+      bool depthChanged = false;
+
+      if(++m_quotesCount % m_settings.tradeRatio == 0)
+      {
+         const bool atAsk = (m_random.Next() & 1) != 0;
+         instrument.trade = atAsk ? instrument.ask : instrument.bid;
+         instrument.tradeVolume = 1 + m_random.Next(10);
+         instrument.tradeTime = m_lineTime;
+         instrument.high = std::max(instrument.high, instrument.trade);
+         instrument.low = std::min(instrument.low, instrument.trade);
+
+         if(!m_liveBars.empty())
+         {
+            updateLiveBars(instrument);
+         }
+      }
+      else if((m_random.Next() & 1) != 0)
+      {
+         quotesChanged = instrument.level != TradesLevel;
+
+         // Bid side update, price moves at most one tick keeping spread positive.
+         const int move = static_cast<int>(m_random.Next(3)) - 1;
+         const Price bid = instrument.bid;
+         instrument.bid = std::max(instrument.bid + move * m_settings.tickSize, m_settings.tickSize);
+         instrument.bid = std::min(instrument.bid, instrument.ask - m_settings.tickSize);
+         instrument.bidVolume = 1 + m_random.Next(50);
+
+         if(marketDepth)
+         {
+            shiftDepth(instrument.bidDepth, ticksBetween(instrument.bid, bid));
+            instrument.bidDepth[0] = instrument.bidVolume;
+            instrument.bidDepth[1 + m_random.Next(MarketDepth::MaxLevels - 1)] = 1 + m_random.Next(100);
+            depthChanged = true;
+         }
+      }
+      else
+      {
+         // Ask side update.
+         quotesChanged = instrument.level != TradesLevel;
+         const int move = static_cast<int>(m_random.Next(3)) - 1;
+         const Price ask = instrument.ask;
+         instrument.ask = std::max(instrument.ask + move * m_settings.tickSize, instrument.bid + m_settings.tickSize);
+         instrument.askVolume = 1 + m_random.Next(50);
+
+         if(marketDepth)
+         {
+            shiftDepth(instrument.askDepth, ticksBetween(ask, instrument.ask));
+            instrument.askDepth[0] = instrument.askVolume;
+            instrument.askDepth[1 + m_random.Next(MarketDepth::MaxLevels - 1)] = 1 + m_random.Next(100);
+            depthChanged = true;
+         }
+      }
+
+      if(quotesChanged)
+      {
+         QuoteEvent quotes;
+         quotes.symbolId = instrument.id;
+         GetAllQuotes(instrument, quotes);
+
+         m_events->OnInstrumentChanged(quotes);
+      }
+
+      if(depthChanged)
+      {
+         fireDOMChanged(instrument.id);
+      }
+
+      // Filled orders leave working orders list, so matching goes over its copy.
+      m_matchingOrders = instrument.workingOrders;
+      for(size_t i = 0; i < m_matchingOrders.size(); ++i)
+      {
+         matchOrder(m_matchingOrders[i]);
+      }
+   }
+
+   /// @brief Adds bars to subscribed bars requests once Line Time reaches next bar.
+   void addLiveBars()
+   {
+      for(LiveBarsMap::iterator it = m_liveBars.begin(); it != m_liveBars.end(); ++it)
+      {
+         LiveBars& live = it->second;
+
+         while(m_lineTime >= live.last.timestamp.m_dt + live.period)
+         {
+            BarsUpdate update;
+            update.requestGuid = it->first;
+            update.change = BarAdded;
+            update.index = live.count++;
+            update.bar.timestamp = COleDateTime(live.last.timestamp.m_dt + live.period);
+            update.bar.open = update.bar.high = update.bar.low = update.bar.close = live.last.close;
+            update.bar.volume = 0;
+
+            live.last = update.bar;
+            m_events->OnTimedBarsChanged(update);
+         }
+      }
+   }
+
+   /// @brief Updates last bar of subscribed bars requests of traded instrument.
+   void updateLiveBars(const Instrument& instrument)
+   {
+      for(LiveBarsMap::iterator it = m_liveBars.begin(); it != m_liveBars.end(); ++it)
+      {
+         LiveBars& live = it->second;
+         if(live.fullName != instrument.fullName)
+         {
+            continue;
+         }
+
+         live.last.close = instrument.trade;
+         live.last.high = std::max(live.last.high, instrument.trade);
+         live.last.low = std::min(live.last.low, instrument.trade);
+         live.last.volume += instrument.tradeVolume;
+
+         BarsUpdate update;
+         update.requestGuid = it->first;
+         update.change = BarUpdated;
+         update.index = live.count - 1;
+         update.bar = live.last;
+
+         m_events->OnTimedBarsChanged(update);
+      }
+   }
+
+   /// @brief Fills order if it's marketable at current instrument prices, up to best price volume.
+   void matchOrder(size_t index)
+   {
+      Order& order = m_orders[index];
+      if(order.info.final)
+      {
+         return;
+      }
+
+      const Instrument& instrument = m_instruments[order.instrument];
+      const bool buy = order.info.buy;
+      const Price marketPrice = buy ? instrument.ask : instrument.bid;
+      const Volume marketVolume = buy ? instrument.askVolume : instrument.bidVolume;
+
+      if((order.type == Stop || order.type == StopLimit) && !order.triggered)
+      {
+         order.triggered = buy ? instrument.trade >= order.price : instrument.trade <= order.price;
+         if(!order.triggered) return;
+      }
+
+      Price fillPrice = InvalidPrice;
+      if(order.type == Market || order.type == Stop)
+      {
+         fillPrice = marketPrice;
+      }
+      else
+      {
+         const Price limit = order.type == Limit ? order.price : order.stopLimitPrice;
+         if(buy ? marketPrice <= limit : marketPrice >= limit)
+         {
+            fillPrice = marketPrice;
+         }
+      }
+
+      if(fillPrice == InvalidPrice)
+      {
+         return;
+      }
+
+      FillInfo fill;
+      fill.canceled = false;
+      fill.symbol = order.info.symbol;
+      fill.fillPrice = fillPrice;
+      const Volume remaining = order.info.quantity - order.info.filledQty;
+      fill.fillQty = std::min(remaining, std::max<Volume>(marketVolume, 1));
+
+      order.info.filledQty += static_cast<Quantity>(fill.fillQty);
+      order.info.final = order.info.filledQty == order.info.quantity;
+      order.info.orderFills.assign(1, fill);
+      ++order.fillsCount;
+
+      if(order.info.final)
+      {
+         removeWorkingOrder(index);
+      }
+
+      updatePosition(order.info, fill);
+      fireOrderChanged(index);
+   }
+
+   void cancelOrder(size_t index)
+   {
+      Order& order = m_orders[index];
+      if(order.info.final)
+      {
+         return;
+      }
+
+      order.info.final = true;
+      removeWorkingOrder(index);
+      fireOrderChanged(index);
+   }
+
+   /// @brief Removes final order from working orders of its instrument.
+   void removeWorkingOrder(size_t index)
+   {
+      std::vector<size_t>& working = m_instruments[m_orders[index].instrument].workingOrders;
+      working.erase(std::find(working.begin(), working.end(), index));
+   }
+
+   void modifyOrder(size_t index, Price price, Price stopLimitPrice, Quantity quantity)
+   {
+      Order& order = m_orders[index];
+      order.info.modifyPending = false;
+      if(order.info.final)
+      {
+         return;
+      }
+
+      order.price = price;
+      order.stopLimitPrice = stopLimitPrice;
+      order.info.quantity = quantity;
+      fireOrderChanged(index);
+
+      // Order may become marketable at new price.
+      matchOrder(index);
+   }
+
+   /// @brief Fires order change carrying the last order fill, like CQGCEL does.
+   void fireOrderChanged(size_t index)
+   {
+      const Order& order = m_orders[index];
+      OrderInfo info = order.info;
+
+      m_events->OnOrderChanged(info, FillKey(order.fillsCount, 0));
+   }
+
+   /// @brief Applies fill to account position and fires position event.
+   void updatePosition(const OrderInfo& order, const FillInfo& fill)
+   {
+      const PositionsMap::key_type key(order.gwAccountID, fill.symbol);
+      const bool newPosition = m_positions.find(key) == m_positions.end();
+
+      PositionInfo& position = m_positions[key];
+      if(newPosition)
+      {
+         position.symbol = fill.symbol;
+         position.longPosition = order.buy;
+         position.quantity = 0;
+         position.averagePrice = InvalidPrice;
+         position.ote = 0.0;
+         position.profitLoss = 0.0;
+      }
+
+      const long signedQty = position.longPosition ?
+         static_cast<long>(position.quantity) : -static_cast<long>(position.quantity);
+      const long fillQty = order.buy ? fill.fillQty : -fill.fillQty;
+      const long newQty = signedQty + fillQty;
+
+      if(signedQty == 0 || (signedQty > 0) == (fillQty > 0))
+      {
+         // Opening or increasing position.
+         const Price avgPrice = signedQty == 0 ? 0.0 : position.averagePrice;
+         position.averagePrice = (avgPrice * std::labs(signedQty) + fill.fillPrice * std::labs(fillQty)) /
+            std::labs(newQty);
+      }
+      else
+      {
+         // Decreasing, closing or reversing position.
+         const long closedQty = std::min(std::labs(signedQty), std::labs(fillQty));
+         const double direction = signedQty > 0 ? 1.0 : -1.0;
+         position.profitLoss += (fill.fillPrice - position.averagePrice) * closedQty * direction;
+
+         if(std::labs(fillQty) > std::labs(signedQty)) position.averagePrice = fill.fillPrice;
+         if(newQty == 0) position.averagePrice = InvalidPrice;
+      }
+
+      position.longPosition = newQty != 0 ? newQty > 0 : order.buy;
+      position.quantity = static_cast<Quantity>(std::labs(newQty));
+
+      const AccountInfo* account = findAccount(order.gwAccountID);
+      ATLASSERT(account);
+
+      m_events->OnPositionChanged(*account, position, newPosition);
+   }
+
+   SimulationSettings m_settings;    ///< Simulation settings.
+   Random m_random;                  ///< Market data generator.
+   IBackendEvents* m_events;         ///< Facade core events listener.
+   SubscriptionLevel m_defaultLevel; ///< Level of newly subscribed instruments.
+   std::deque<Event> m_pending;      ///< Events waiting for PumpEvents().
+   DATE m_lineTime;                  ///< Simulated Line Time.
+
+   Accounts m_accounts;              ///< Simulated accounts.
+   PositionsMap m_positions;         ///< Positions by account ID & symbol.
+   Instruments m_instruments;        ///< Subscribed instruments.
+   std::vector<size_t> m_indexById;  ///< Instrument indexes by symbol identifier.
+   InstrumentIndex m_instrumentIndex; ///< Instrument indexes by full name.
+   LiveBarsMap m_liveBars;           ///< Subscribed bars requests by guid.
+   Orders m_orders;                  ///< All placed orders.
+   std::vector<size_t> m_matchingOrders; ///< Working orders matched by the current quote.
+   OrderIndex m_orderIndex;          ///< Order indexes by guid.
+   PreparedOrders m_tickets;         ///< Prepared order tickets by identifier.
+
+   size_t m_nextInstrument;          ///< Next instrument to move market.
+   unsigned m_quotesCount;           ///< Number of simulated quote updates.
+   unsigned m_ordersCount;           ///< Number of placed orders.
+   unsigned m_barRequestsCount;      ///< Number of bar requests.
+}; // class SimulatedBackend
+
+IBackendPtr CreateSimulatedBackend(const SimulationSettings& settings)
+{
+   return IBackendPtr(new SimulatedBackend(settings));
+}
+
+} // namespace cqg
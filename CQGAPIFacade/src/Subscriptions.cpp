@@ -0,0 +1,49 @@
+/// @file Subscriptions.cpp
+/// @brief Simple C++ facade for CQG API - symbol subscriptions reference counting implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "Subscriptions.h"
+
+namespace cqg
+{
+
+bool Subscriptions::AddRef(const SymbolId id, const unsigned refs, const Price tickSize, const SubscriptionLevel level)
+{
+   if(id >= m_symbols.size())
+   {
+      m_symbols.resize(id + 1);
+   }
+
+   Subscription& subscription = m_symbols[id];
+   const bool first = subscription.refs == 0;
+
+   if(first)
+   {
+      subscription.level = level;
+      ++m_subscribedCount;
+   }
+
+   subscription.refs += refs;
+   subscription.tickSize = tickSize;
+
+   return first;
+}
+
+unsigned Subscriptions::Release(const SymbolId id)
+{
+   ATLASSERT(IsSubscribed(id));
+
+   Subscription& subscription = m_symbols[id];
+   if(--subscription.refs == 0)
+   {
+      --m_subscribedCount;
+   }
+
+   return subscription.refs;
+}
+
+} // namespace cqg
@@ -0,0 +1,87 @@
+/// @file Subscriptions.h
+/// @brief Simple C++ facade for CQG API - symbol subscriptions reference counting.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+
+#include <vector>
+
+namespace cqg
+{
+
+/// @class Subscriptions
+/// @brief Subscription state of symbols indexed by symbol identifier.
+class Subscriptions
+{
+public:
+
+   Subscriptions(): m_subscribedCount(0)
+   {}
+
+   /// @brief Adds symbol subscription references.
+   /// @param id [in] symbol identifier.
+   /// @param refs [in] number of references to add.
+   /// @param tickSize [in] symbol tick size.
+   /// @param level [in] subscription level if symbol is not subscribed yet.
+   /// @return True if symbol was not subscribed before.
+   bool AddRef(const SymbolId id, const unsigned refs, const Price tickSize, const SubscriptionLevel level);
+
+   /// @brief Releases one symbol subscription reference.
+   /// @return Number of references left.
+   unsigned Release(const SymbolId id);
+
+   /// @brief Checks whether symbol has at least one reference.
+   bool IsSubscribed(const SymbolId id) const
+   {
+      return id < m_symbols.size() && m_symbols[id].refs > 0;
+   }
+
+   /// @brief Gets subscribed symbol level.
+   SubscriptionLevel GetLevel(const SymbolId id) const
+   {
+      ATLASSERT(IsSubscribed(id));
+      return m_symbols[id].level;
+   }
+
+   /// @brief Sets subscribed symbol level.
+   void SetLevel(const SymbolId id, const SubscriptionLevel level)
+   {
+      ATLASSERT(IsSubscribed(id));
+      m_symbols[id].level = level;
+   }
+
+   /// @brief Gets subscribed symbol tick size.
+   Price GetTickSize(const SymbolId id) const
+   {
+      ATLASSERT(IsSubscribed(id));
+      return m_symbols[id].tickSize;
+   }
+
+   /// @brief Gets number of subscribed symbols.
+   unsigned GetSubscribedCount() const
+   {
+      return m_subscribedCount;
+   }
+
+private:
+
+   /// @brief Single symbol subscription.
+   struct Subscription
+   {
+      Subscription(): refs(0), level(NoQuotesLevel), tickSize(0.0)
+      {}
+
+      unsigned refs;              ///< Number of references, zero if not subscribed.
+      SubscriptionLevel level;    ///< Market data subscription level.
+      Price tickSize;             ///< Symbol tick size.
+   };
+
+   std::vector<Subscription> m_symbols;   ///< Subscriptions by symbol identifier.
+   unsigned m_subscribedCount;            ///< Number of symbols with non zero references.
+};
+
+} // namespace cqg
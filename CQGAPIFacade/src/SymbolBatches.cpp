@@ -0,0 +1,128 @@
+/// @file SymbolBatches.cpp
+/// @brief Simple C++ facade for CQG API - symbol subscription batches tracking implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "SymbolBatches.h"
+
+#include <algorithm>
+
+namespace cqg
+{
+
+unsigned SymbolBatches::Start(const SymbolNames& symbols, SymbolNames& unique)
+{
+   unique.clear();
+
+   const unsigned batchId = ++m_lastId;
+
+   Batch& batch = m_batches[batchId];
+   batch.start = Clock::now();
+   batch.issued = false;
+   batch.pending = 0;
+   batch.result.batchId = batchId;
+   batch.result.issueMs = 0.0;
+   batch.result.elapsedMs = 0.0;
+
+   for(SymbolNames::const_iterator it = symbols.begin(); it != symbols.end(); ++it)
+   {
+      std::vector<unsigned>& waiting = m_waiting[*it];
+
+      if(std::find(waiting.begin(), waiting.end(), batchId) != waiting.end())
+      {
+         continue;
+      }
+
+      if(waiting.empty())
+      {
+         unique.push_back(*it);
+      }
+
+      waiting.push_back(batchId);
+      ++batch.pending;
+   }
+
+   return batchId;
+}
+
+void SymbolBatches::Issued(const unsigned batchId, SymbolsBatches& completed)
+{
+   const Batches::iterator it = m_batches.find(batchId);
+   if(it == m_batches.end())
+   {
+      return;
+   }
+
+   it->second.issued = true;
+   it->second.result.issueMs = std::chrono::duration<double, std::milli>(Clock::now() - it->second.start).count();
+   checkCompleted(it, completed);
+}
+
+unsigned SymbolBatches::OnResolved(const CString& requestedSymbol, const SymbolInfo& symbol, SymbolsBatches& completed)
+{
+   return complete(requestedSymbol, &symbol, completed);
+}
+
+void SymbolBatches::OnFailed(const CString& requestedSymbol, SymbolsBatches& completed)
+{
+   complete(requestedSymbol, NULL, completed);
+}
+
+unsigned SymbolBatches::complete(const CString& requestedSymbol, const SymbolInfo* symbol, SymbolsBatches& completed)
+{
+   const Waiting::iterator waiting = m_waiting.find(requestedSymbol);
+   if(waiting == m_waiting.end())
+   {
+      // Requested by RequestSymbol() or already resolved.
+      return 0;
+   }
+
+   std::vector<unsigned> batchIds;
+   batchIds.swap(waiting->second);
+   m_waiting.erase(waiting);
+
+   for(size_t i = 0; i < batchIds.size(); ++i)
+   {
+      const Batches::iterator it = m_batches.find(batchIds[i]);
+      if(it == m_batches.end())
+      {
+         continue;
+      }
+
+      SymbolsBatch& result = it->second.result;
+      if(symbol)
+      {
+         result.requested.push_back(requestedSymbol);
+         result.resolved.push_back(*symbol);
+      }
+      else
+      {
+         result.failed.push_back(requestedSymbol);
+      }
+
+      --it->second.pending;
+      checkCompleted(it, completed);
+   }
+
+   return static_cast<unsigned>(batchIds.size());
+}
+
+void SymbolBatches::checkCompleted(Batches::iterator it, SymbolsBatches& completed)
+{
+   Batch& batch = it->second;
+   if(!batch.issued || batch.pending)
+   {
+      return;
+   }
+
+   batch.result.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - batch.start).count();
+
+   completed.push_back(SymbolsBatch());
+   std::swap(completed.back(), batch.result);
+   m_batches.erase(it);
+}
+
+} // namespace cqg
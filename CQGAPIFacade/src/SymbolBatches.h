@@ -0,0 +1,85 @@
+/// @file SymbolBatches.h
+/// @brief Simple C++ facade for CQG API - symbol subscription batches tracking.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "SymbolTable.h"
+
+#include <chrono>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace cqg
+{
+
+/// @brief Completed symbols batches container.
+typedef std::vector<SymbolsBatch> SymbolsBatches;
+
+/// @class SymbolBatches
+/// @brief Tracks resolution of symbols requested by batches, see IAPIFacade::RequestSymbols().
+///        Symbol resolution completes every batch waiting for that symbol, so the same symbol
+///        requested by several batches is resolved by CQGCEL once.
+class SymbolBatches
+{
+public:
+
+   SymbolBatches(): m_lastId(0)
+   {}
+
+   /// @brief Starts new batch, all its symbols become pending.
+   /// @param symbols [in] requested symbols.
+   /// @param unique [out] requested symbols without duplicates and ones already pending for other batches,
+   ///        i.e. symbols to be requested from CQGCEL.
+   /// @return Batch identifier.
+   unsigned Start(const SymbolNames& symbols, SymbolNames& unique);
+
+   /// @brief Marks batch as issued, i.e. all its symbols are requested from CQGCEL.
+   /// @param completed [out] batch result if it's completed already.
+   void Issued(const unsigned batchId, SymbolsBatches& completed);
+
+   /// @brief Handles resolved symbol.
+   /// @param requestedSymbol [in] requested symbol name.
+   /// @param symbol [in] resolved symbol.
+   /// @param completed [out] completed batches.
+   /// @return Number of batches waiting for the symbol.
+   unsigned OnResolved(const CString& requestedSymbol, const SymbolInfo& symbol, SymbolsBatches& completed);
+
+   /// @brief Handles symbol failed resolution.
+   /// @param requestedSymbol [in] requested symbol name.
+   /// @param completed [out] completed batches.
+   void OnFailed(const CString& requestedSymbol, SymbolsBatches& completed);
+
+private:
+
+   typedef std::chrono::steady_clock Clock;
+
+   /// @brief Batch being resolved.
+   struct Batch
+   {
+      Clock::time_point start;   ///< Time batch was requested.
+      bool issued;               ///< True if all symbols are requested from CQGCEL.
+      unsigned pending;          ///< Number of symbols not resolved yet.
+      SymbolsBatch result;       ///< Batch result being collected.
+   };
+
+   typedef std::map<unsigned, Batch> Batches;
+   typedef std::unordered_map<CString, std::vector<unsigned>, CStringHash> Waiting;
+
+   /// @brief Completes symbol for all batches waiting for it.
+   /// @return Number of batches waiting for the symbol.
+   unsigned complete(const CString& requestedSymbol, const SymbolInfo* symbol, SymbolsBatches& completed);
+
+   /// @brief Moves batch to completed ones if nothing is pending.
+   void checkCompleted(Batches::iterator it, SymbolsBatches& completed);
+
+   unsigned m_lastId;       ///< Last assigned batch identifier.
+   Batches m_batches;       ///< Incomplete batches by identifier.
+   Waiting m_waiting;       ///< Identifiers of batches waiting for requested symbol.
+};
+
+} // namespace cqg
@@ -0,0 +1,41 @@
+/// @file SymbolTable.cpp
+/// @brief Simple C++ facade for CQG API - interned symbol names implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "SymbolTable.h"
+
+namespace cqg
+{
+
+SymbolId SymbolTable::Intern(const CString& fullName)
+{
+   const IdsMap::const_iterator it = m_ids.find(fullName);
+   if(it != m_ids.end())
+   {
+      return it->second;
+   }
+
+   const SymbolId id = static_cast<SymbolId>(m_names.size());
+   m_names.push_back(fullName);
+   m_ids.insert(IdsMap::value_type(fullName, id));
+
+   return id;
+}
+
+SymbolId SymbolTable::Find(const CString& fullName) const
+{
+   const IdsMap::const_iterator it = m_ids.find(fullName);
+   return it != m_ids.end() ? it->second : InvalidSymbolId;
+}
+
+const CString& SymbolTable::GetName(const SymbolId id) const
+{
+   static const CString empty;
+   return IsValid(id) ? m_names[id] : empty;
+}
+
+} // namespace cqg
@@ -0,0 +1,69 @@
+/// @file SymbolTable.h
+/// @brief Simple C++ facade for CQG API - interned symbol names.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace cqg
+{
+
+/// @brief FNV-1a hash of CString contents, usable with unordered containers.
+struct CStringHash
+{
+   size_t operator()(const CString& str) const
+   {
+      size_t result = 2166136261u;
+      for(const char* ch = str.GetString(); *ch; ++ch)
+      {
+         result = (result ^ static_cast<unsigned char>(*ch)) * 16777619u;
+      }
+
+      return result;
+   }
+};
+
+/// @class SymbolTable
+/// @brief Maps full symbol names to compact sequential identifiers and back.
+///        Identifiers are never reused, so they can index plain arrays of per symbol state.
+class SymbolTable
+{
+public:
+
+   /// @brief Gets identifier of given symbol, assigns new one if symbol is not known yet.
+   SymbolId Intern(const CString& fullName);
+
+   /// @brief Gets identifier of given symbol.
+   /// @return Symbol identifier or InvalidSymbolId if symbol is not known.
+   SymbolId Find(const CString& fullName) const;
+
+   /// @brief Gets full name of given symbol.
+   /// @return Symbol full name, reference is valid until next Intern() call.
+   const CString& GetName(const SymbolId id) const;
+
+   /// @brief Checks whether identifier is known.
+   bool IsValid(const SymbolId id) const
+   {
+      return id < m_names.size();
+   }
+
+   /// @brief Gets number of interned symbols.
+   size_t Size() const
+   {
+      return m_names.size();
+   }
+
+private:
+   typedef std::unordered_map<CString, SymbolId, CStringHash> IdsMap;
+
+   IdsMap m_ids;                 ///< Identifiers by full name.
+   std::vector<CString> m_names; ///< Full names by identifier.
+};
+
+} // namespace cqg
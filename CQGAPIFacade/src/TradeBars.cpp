@@ -0,0 +1,241 @@
+/// @file TradeBars.cpp
+/// @brief Simple C++ facade for CQG API - bars built from trades of symbol quote updates implementation.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#include "stdafx.h"
+
+#include "TradeBars.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cqg
+{
+
+namespace
+{
+
+const double MinutesPerDay = 24.0 * 60.0;
+
+/// @brief Gets trade quote of quote update.
+/// @return NULL if update has no valid trade.
+const QuoteInfo* FindTrade(const QuoteEvent& quotes)
+{
+   if(!(quotes.changedMask & QuoteEvent::TypeMask(QuoteInfo::Trade)))
+   {
+      return NULL;
+   }
+
+   for(unsigned i = 0; i < quotes.count; ++i)
+   {
+      if(quotes.quotes[i].type == QuoteInfo::Trade)
+      {
+         return quotes.quotes[i].price != InvalidPrice ? &quotes.quotes[i] : NULL;
+      }
+   }
+
+   return NULL;
+}
+
+} // namespace
+
+CString TradeBars::Add(const TradeBarsRequest& request, const QuoteEvent& lastQuotes, CString& error)
+{
+   if(request.symbolId == InvalidSymbolId)
+   {
+      error = "Invalid symbol identifier";
+      return CString();
+   }
+
+   if(!(request.size > 0.0) ||
+      (request.type != TimeTradeBars && request.type != TickTradeBars &&
+       request.type != VolumeTradeBars && request.type != RangeTradeBars))
+   {
+      error = "Invalid trade bars type or size";
+      return CString();
+   }
+
+   CString requestGuid;
+   requestGuid.Format("{FACADE-TRADEBARS-%08u}", ++m_guidsCount);
+
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   Series& series = m_series[requestGuid];
+   series.requestGuid = requestGuid;
+   series.request = request;
+   series.period = request.size / MinutesPerDay;
+   series.hasCurrent = false;
+   series.trades = 0;
+
+   if(request.symbolId >= m_symbols.size())
+   {
+      m_symbols.resize(request.symbolId + 1);
+   }
+
+   SymbolSeries& symbol = m_symbols[request.symbolId];
+   symbol.series.push_back(&series);
+
+   // Trade already reported isn't new one.
+   const QuoteInfo* trade = FindTrade(lastQuotes);
+   if(!symbol.hasTrade && trade)
+   {
+      symbol.hasTrade = true;
+      symbol.lastTrade.price = trade->price;
+      symbol.lastTrade.volume = trade->volume;
+      symbol.lastTrade.timestamp = trade->timestamp;
+   }
+
+   return requestGuid;
+}
+
+bool TradeBars::Remove(const CString& requestGuid, SymbolId& symbolId)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const SeriesMap::iterator it = m_series.find(requestGuid);
+   if(it == m_series.end())
+   {
+      return false;
+   }
+
+   symbolId = it->second.request.symbolId;
+
+   std::vector<Series*>& series = m_symbols[symbolId].series;
+   series.erase(std::remove(series.begin(), series.end(), &it->second), series.end());
+
+   m_series.erase(it);
+   return true;
+}
+
+bool TradeBars::Get(const CString& requestGuid, Bars& bars) const
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   const SeriesMap::const_iterator it = m_series.find(requestGuid);
+   if(it == m_series.end())
+   {
+      return false;
+   }
+
+   const Series& series = it->second;
+
+   bars.requestGuid = requestGuid;
+   bars.error.Empty();
+   bars.bars.assign(series.closed.begin(), series.closed.end());
+   if(series.hasCurrent)
+   {
+      bars.bars.push_back(series.current);
+   }
+
+   bars.requestedCount = static_cast<long>(bars.bars.size());
+   return true;
+}
+
+void TradeBars::OnQuotes(const QuoteEvent& quotes, ClosedTradeBars& closed)
+{
+   closed.clear();
+
+   // Symbols without trade bars requests are skipped at once, their trades are seeded by Add().
+   if(quotes.symbolId >= m_symbols.size() || m_symbols[quotes.symbolId].series.empty())
+   {
+      return;
+   }
+
+   const QuoteInfo* trade = FindTrade(quotes);
+   if(!trade)
+   {
+      return;
+   }
+
+   SymbolSeries& symbol = m_symbols[quotes.symbolId];
+
+   // Quote updates repeat the last trade until the next one happens.
+   if(symbol.hasTrade &&
+      symbol.lastTrade.price == trade->price &&
+      symbol.lastTrade.volume == trade->volume &&
+      symbol.lastTrade.timestamp == trade->timestamp)
+   {
+      return;
+   }
+
+   symbol.hasTrade = true;
+   symbol.lastTrade.price = trade->price;
+   symbol.lastTrade.volume = trade->volume;
+   symbol.lastTrade.timestamp = trade->timestamp;
+
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   for(size_t i = 0; i < symbol.series.size(); ++i)
+   {
+      addTrade(*symbol.series[i], *trade, closed);
+   }
+}
+
+void TradeBars::addTrade(Series& series, const QuoteInfo& trade, ClosedTradeBars& closed)
+{
+   const TradeBarsType type = series.request.type;
+   BarInfo& bar = series.current;
+
+   if(series.hasCurrent)
+   {
+      // Time & range bars are closed by trade which doesn't fit them.
+      const bool closes = type == TimeTradeBars ?
+         trade.timestamp >= bar.timestamp.m_dt + series.period * (1.0 - 1e-9) :
+         type == RangeTradeBars &&
+            std::max(bar.high, trade.price) - std::min(bar.low, trade.price) > series.request.size * (1.0 + 1e-9);
+
+      if(closes)
+      {
+         close(series, closed);
+      }
+   }
+
+   if(!series.hasCurrent)
+   {
+      const DATE start = type == TimeTradeBars ?
+         std::floor(trade.timestamp / series.period + 1e-9) * series.period : trade.timestamp;
+
+      bar.timestamp = COleDateTime(start);
+      bar.open = bar.high = bar.low = bar.close = trade.price;
+      bar.volume = trade.volume;
+      series.trades = 1;
+      series.hasCurrent = true;
+   }
+   else
+   {
+      bar.high = std::max(bar.high, trade.price);
+      bar.low = std::min(bar.low, trade.price);
+      bar.close = trade.price;
+      bar.volume += trade.volume;
+      ++series.trades;
+   }
+
+   // Tick & volume bars are closed by trade completing them.
+   if((type == TickTradeBars && series.trades >= series.request.size) ||
+      (type == VolumeTradeBars && bar.volume >= series.request.size))
+   {
+      close(series, closed);
+   }
+}
+
+void TradeBars::close(Series& series, ClosedTradeBars& closed)
+{
+   series.hasCurrent = false;
+
+   if(series.request.maxBars > 0)
+   {
+      series.closed.push_back(series.current);
+      if(series.closed.size() > static_cast<size_t>(series.request.maxBars))
+      {
+         series.closed.pop_front();
+      }
+   }
+
+   closed.push_back(ClosedTradeBar());
+   closed.back().requestGuid = series.requestGuid;
+   closed.back().bar = series.current;
+}
+
+} // namespace cqg
@@ -0,0 +1,104 @@
+/// @file TradeBars.h
+/// @brief Simple C++ facade for CQG API - bars built from trades of symbol quote updates.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+
+#pragma once
+
+#include "CQGAPIFacade.h"
+#include "SymbolTable.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cqg
+{
+
+/// @brief Trade bar closed by quote update.
+struct ClosedTradeBar
+{
+   CString requestGuid;   ///< Trade bars request guid.
+   BarInfo bar;           ///< Closed bar.
+};
+
+typedef std::vector<ClosedTradeBar> ClosedTradeBars;
+
+/// @class TradeBars
+/// @brief Time, tick, volume & range bars of trade bars requests, see IAPIFacade::RequestTradeBars().
+///        Updated from CQGCEL thread, bars can be read from any thread.
+class TradeBars
+{
+public:
+
+   TradeBars(): m_guidsCount(0)
+   {}
+
+   /// @brief Adds trade bars request.
+   /// @param lastQuotes [in] current symbol quotes, their trade is not added to bars.
+   /// @return Request guid, empty string if request is invalid.
+   CString Add(const TradeBarsRequest& request, const QuoteEvent& lastQuotes, CString& error);
+
+   /// @brief Drops trade bars request.
+   /// @param symbolId [out] identifier of request symbol.
+   /// @return False if request is unknown.
+   bool Remove(const CString& requestGuid, SymbolId& symbolId);
+
+   /// @brief Gets kept closed bars followed by current bar.
+   /// @return False if request is unknown.
+   bool Get(const CString& requestGuid, Bars& bars) const;
+
+   /// @brief Adds new trade of symbol quote update to its bars.
+   /// @param closed [out] bars closed by trade.
+   void OnQuotes(const QuoteEvent& quotes, ClosedTradeBars& closed);
+
+private:
+
+   /// @brief The last trade seen of symbol.
+   struct LastTrade
+   {
+      Price price;
+      Volume volume;
+      DATE timestamp;
+   };
+
+   /// @brief Trade bars request state.
+   struct Series
+   {
+      CString requestGuid;           ///< Request guid.
+      TradeBarsRequest request;      ///< Request definition.
+      double period;                 ///< Time bar period in days.
+      bool hasCurrent;               ///< True if current bar has trades.
+      BarInfo current;               ///< Current bar.
+      long trades;                   ///< Number of trades in current bar.
+      std::deque<BarInfo> closed;    ///< Kept closed bars.
+   };
+
+   /// @brief Trade bars requests & the last trade of symbol.
+   struct SymbolSeries
+   {
+      SymbolSeries(): hasTrade(false)
+      {}
+
+      bool hasTrade;                   ///< True if the last trade is known.
+      LastTrade lastTrade;             ///< The last trade seen.
+      std::vector<Series*> series;     ///< Symbol trade bars requests.
+   };
+
+   typedef std::unordered_map<CString, Series, CStringHash> SeriesMap;
+
+   /// @brief Adds trade to bars, closing bars it completes.
+   static void addTrade(Series& series, const QuoteInfo& trade, ClosedTradeBars& closed);
+
+   /// @brief Closes current bar.
+   static void close(Series& series, ClosedTradeBars& closed);
+
+   mutable std::mutex m_lock;            ///< Guards bars.
+   SeriesMap m_series;                   ///< Requests by guid.
+   std::vector<SymbolSeries> m_symbols;  ///< Requests by symbol identifier.
+   unsigned m_guidsCount;                ///< Number of requests made.
+};
+
+} // namespace cqg
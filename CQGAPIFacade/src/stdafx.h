@@ -5,6 +5,8 @@
 
 #pragma once
 
+#if defined(_WIN32) && !defined(CQGAPIFACADE_PORTABLE)
+
 #ifndef _SECURE_ATL
 #define _SECURE_ATL 1
 #endif
@@ -27,3 +29,13 @@
 #include <afx.h>
 #include <afxwin.h>         // MFC core and standard components
 #include <atlcomtime.h>     // COleDateTime
+
+#else // Portable build, no MFC/ATL available
+
+#include <cassert>
+
+#define ATLASSERT(expr) assert(expr)
+#define ATLVERIFY(expr) ((void)(expr))
+#define ATLTRACE(...) ((void)0)
+
+#endif
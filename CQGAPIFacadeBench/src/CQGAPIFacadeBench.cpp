@@ -0,0 +1,2007 @@
+/// @file CQGAPIFacadeBench.cpp
+/// @brief CQG API Facade benchmark - drives facade hot paths over simulated CQGCEL.
+/// @copyright Licensed under the MIT License.
+/// @author Rostislav Ostapenko (rostislav.ostapenko@gmail.com)
+/// @date 16-Oct-2026
+///
+/// Usage: CQGAPIFacadeBench [quote events] [symbols]
+/// Results are deterministic for the same arguments except timings,
+/// so event counters can be compared between runs to detect behavior changes.
+
+#include "CQGAPIFacade.h"
+#include "CQGBarColumns.h"
+#include "CQGIndicators.h"
+#include "CQGPortfolio.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+typedef std::chrono::high_resolution_clock Clock;
+
+/// @brief Returns seconds elapsed since given moment.
+double SecondsSince(const Clock::time_point& start)
+{
+   return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// @class BenchEvents
+/// @brief Counts received events, does minimal work per event.
+struct BenchEvents : cqg::IAPIEvents
+{
+   BenchEvents():
+      errors(0),
+      subscribed(0),
+      symbolErrors(0),
+      quoteEvents(0),
+      quotes(0),
+      orderEvents(0),
+      finalOrders(0),
+      barsReceived(0),
+      barsCount(0),
+      quotesPending(0),
+      depthUpdates(0),
+      depthChanges(0),
+      batchesCompleted(0),
+      barsAdded(0),
+      barsUpdated(0),
+      tradeBarsClosed(0),
+      checksum(0.0)
+   {}
+
+   virtual void OnError(const cqg::CString& error)
+   {
+      std::printf("CEL Error: %s\n", error.GetString());
+      ++errors;
+   }
+
+   virtual void OnMarketDataConnection(const bool /*connected*/) {}
+   virtual void OnTradingConnection(const bool /*connected*/) {}
+
+   virtual void OnSymbolSubscribed(const cqg::CString& /*requestedSymbol*/, const cqg::SymbolInfo& symbol)
+   {
+      ++subscribed;
+      symbols.push_back(symbol.fullName);
+   }
+
+   virtual void OnSymbolError(const cqg::CString& /*symbol*/)
+   {
+      ++symbolErrors;
+   }
+
+   virtual void OnSymbolsBatchCompleted(const cqg::SymbolsBatch& batch)
+   {
+      ++batchesCompleted;
+      lastBatch = batch;
+   }
+
+   virtual void OnSymbolQuote(const cqg::SymbolInfo& symbol)
+   {
+      ++quoteEvents;
+      quotes += symbol.lastQuotes.size();
+
+      for(size_t i = 0; i < symbol.lastQuotes.size(); ++i)
+      {
+         checksum += symbol.lastQuotes[i].price;
+      }
+   }
+
+   virtual void OnQuoteEvent(const cqg::QuoteEvent& quoteEvent)
+   {
+      ++quoteEvents;
+      quotes += quoteEvent.count;
+
+      for(unsigned i = 0; i < quoteEvent.count; ++i)
+      {
+         checksum += quoteEvent.quotes[i].price;
+      }
+   }
+
+   virtual void OnQuotesPending()
+   {
+      ++quotesPending;
+   }
+
+   virtual void OnDepthUpdate(const cqg::DepthUpdate& update)
+   {
+      ++depthUpdates;
+      depthChanges += update.count;
+   }
+
+   virtual void OnAccountsReloaded() {}
+   virtual void OnPositionsReloaded() {}
+   virtual void OnAccountChanged(const cqg::AccountInfo& /*account*/) {}
+
+   virtual void OnPositionChanged(
+      const cqg::AccountInfo& /*account*/,
+      const cqg::PositionInfo& /*position*/,
+      const bool /*newPosition*/)
+   {}
+
+   virtual void OnOrderChanged(const cqg::OrderInfo& order)
+   {
+      ++orderEvents;
+      if(order.final) ++finalOrders;
+   }
+
+   virtual void OnBarsReceived(const cqg::Bars& bars)
+   {
+      ++barsReceived;
+      barsCount += bars.bars.size();
+      lastBars = bars;
+   }
+
+   virtual void OnBarsUpdated(const cqg::BarsUpdate& update)
+   {
+      if(update.change == cqg::BarAdded) ++barsAdded;
+      else ++barsUpdated;
+   }
+
+   virtual void OnTradeBarClosed(const cqg::CString& /*requestGuid*/, const cqg::BarInfo& bar)
+   {
+      ++tradeBarsClosed;
+      checksum += bar.close;
+   }
+
+   unsigned errors;
+   unsigned subscribed;
+   unsigned symbolErrors;
+   unsigned long long quoteEvents;
+   unsigned long long quotes;
+   unsigned orderEvents;
+   unsigned finalOrders;
+   unsigned barsReceived;
+   unsigned long long barsCount;
+   unsigned quotesPending;
+   unsigned long long depthUpdates;
+   unsigned long long depthChanges;
+   unsigned batchesCompleted;
+   unsigned long long barsAdded;
+   unsigned long long barsUpdated;
+   unsigned long long tradeBarsClosed;
+   cqg::SymbolsBatch lastBatch;
+   double checksum;
+   std::vector<cqg::CString> symbols;
+   cqg::Bars lastBars;
+};
+
+/// @brief Delivers all pending events except generated market data.
+void Drain(cqg::IAPIFacade& api, BenchEvents& events, unsigned expectedSubscriptions)
+{
+   while(events.subscribed + events.symbolErrors < expectedSubscriptions)
+   {
+      if(api.PumpEvents(1) == 0) break;
+   }
+}
+
+/// @brief Creates facade, subscribes to symbols and waits for subscriptions.
+cqg::IAPIFacadePtr Start(
+   BenchEvents& events,
+   unsigned symbolsCount,
+   const cqg::FacadeSettings& settings = cqg::FacadeSettings())
+{
+   cqg::IAPIFacadePtr api = cqg::IAPIFacade::CreateSimulated();
+   if(!api->Initialize(&events, settings))
+   {
+      std::printf("Unable to initialize: %s\n", api->GetLastError().GetString());
+      std::exit(1);
+   }
+
+   for(unsigned i = 0; i < symbolsCount; ++i)
+   {
+      cqg::CString symbol;
+      symbol.Format("SYM%u", i);
+      api->RequestSymbol(symbol);
+   }
+
+   Drain(*api, events, symbolsCount);
+   return api;
+}
+
+/// @brief Measures symbols subscription one by one versus single batch.
+/// @param invalidCount [in] number of invalid symbols added to valid ones.
+void BenchSymbolsBatch(unsigned symbolsCount, unsigned invalidCount)
+{
+   cqg::SymbolNames symbols;
+   for(unsigned i = 0; i < symbolsCount + invalidCount; ++i)
+   {
+      cqg::CString symbol;
+      symbol.Format(i < symbolsCount ? "SYM%u" : "BAD-%u", i);
+      symbols.push_back(symbol);
+   }
+
+   double sequentialElapsed = 0.0;
+   {
+      BenchEvents events;
+      cqg::IAPIFacadePtr api = Start(events, 0);
+
+      const Clock::time_point start = Clock::now();
+      for(size_t i = 0; i < symbols.size(); ++i)
+      {
+         api->RequestSymbol(symbols[i]);
+         Drain(*api, events, static_cast<unsigned>(i + 1));
+      }
+      sequentialElapsed = SecondsSince(start);
+   }
+
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 0);
+
+   const Clock::time_point start = Clock::now();
+   const unsigned batchId = api->RequestSymbols(symbols);
+   while(events.batchesCompleted == 0 && api->PumpEvents(1) != 0)
+   {
+   }
+   const double elapsed = SecondsSince(start);
+
+   std::printf("symbols batch #%u: %u resolved, %u failed, issued in %.3f ms, completed in %.3f ms "
+      "(measured %.3f ms), one by one %.3f ms\n",
+      batchId, static_cast<unsigned>(events.lastBatch.resolved.size()),
+      static_cast<unsigned>(events.lastBatch.failed.size()), events.lastBatch.issueMs,
+      events.lastBatch.elapsedMs, elapsed * 1e3, sequentialElapsed * 1e3);
+}
+
+/// @brief Measures quote update rate while symbols working set is reduced.
+void BenchSubscriptions(unsigned quoteEvents, unsigned symbolsCount)
+{
+   cqg::FacadeSettings settings;
+   settings.quoteEvents = true;
+
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount, settings);
+
+   api->PumpEvents(quoteEvents);
+   const unsigned long long allEvents = events.quoteEvents;
+
+   // Half of symbols are dropped, every other of the rest receives trades only.
+   for(cqg::SymbolId id = 0; id < symbolsCount; ++id)
+   {
+      if(id % 2 == 0)
+      {
+         api->UnsubscribeSymbol(id);
+      }
+      else if(id % 4 == 1)
+      {
+         api->SetSubscriptionLevel(id, cqg::TradesLevel);
+      }
+   }
+
+   const Clock::time_point start = Clock::now();
+   api->PumpEvents(quoteEvents);
+   const double elapsed = SecondsSince(start);
+
+   std::printf("subscriptions: %u of %u symbols subscribed, %llu quote events before, %llu after in %.3f s\n",
+      api->GetSubscribedSymbolsCount(), symbolsCount, allEvents, events.quoteEvents - allEvents, elapsed);
+}
+
+/// @brief Measures quote storm delivery throughput.
+/// @param name [in] benchmark name.
+/// @param settings [in] facade settings to measure.
+void BenchQuotes(const char* name, unsigned quoteEvents, unsigned symbolsCount, const cqg::FacadeSettings& settings)
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount, settings);
+
+   const Clock::time_point start = Clock::now();
+   const unsigned delivered = api->PumpEvents(quoteEvents);
+   const double elapsed = SecondsSince(start);
+
+   std::printf("%s: %u events, %llu quotes, %u symbols in %.3f s, %.0f events/s, checksum %.2f\n",
+      name, delivered, events.quotes, symbolsCount, elapsed, delivered / elapsed, events.checksum);
+}
+
+/// @brief Measures quote storm delivery to slow consumer draining conflated updates periodically.
+/// @param drainPeriod [in] number of quote events generated between drains.
+void BenchConflatedQuotes(unsigned quoteEvents, unsigned symbolsCount, unsigned drainPeriod)
+{
+   cqg::FacadeSettings settings;
+   settings.quoteEvents = true;
+   settings.deltaQuotes = true;
+   settings.conflateQuotes = true;
+
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount, settings);
+
+   unsigned delivered = 0;
+   unsigned drained = 0;
+
+   const Clock::time_point start = Clock::now();
+   while(delivered < quoteEvents)
+   {
+      delivered += api->PumpEvents(std::min(drainPeriod, quoteEvents - delivered));
+      drained += api->DrainQuotes(symbolsCount);
+   }
+   const double elapsed = SecondsSince(start);
+
+   std::printf("quotes (conflated, drain every %u): %u events, %u updates drained, %u pending notifications, "
+      "%llu quotes in %.3f s, %.0f events/s, checksum %.2f\n",
+      drainPeriod, delivered, drained, events.quotesPending, events.quotes, elapsed, delivered / elapsed, events.checksum);
+}
+
+/// @brief Measures quote storm delivery by dispatch worker thread.
+/// @param policy [in] dispatch queue overflow policy.
+/// @param policyName [in] policy name to print.
+void BenchDispatchedQuotes(unsigned quoteEvents, unsigned symbolsCount, cqg::OverflowPolicy policy, const char* policyName)
+{
+   cqg::FacadeSettings settings;
+   settings.quoteEvents = true;
+   settings.dispatchThreads = 1;
+   settings.dispatchQueueSize = 4096;
+   settings.overflowPolicy = policy;
+
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount, settings);
+
+   cqg::DispatchStats stats;
+   api->GetDispatchStats(stats);
+   const unsigned long long startEvents = stats.queued;
+
+   const Clock::time_point start = Clock::now();
+   const unsigned delivered = api->PumpEvents(quoteEvents);
+   const double pumpElapsed = SecondsSince(start);
+
+   for(;;)
+   {
+      api->GetDispatchStats(stats);
+      if(stats.depth == 0 && stats.delivered + stats.dropped == stats.queued) break;
+      std::this_thread::yield();
+   }
+   const double elapsed = SecondsSince(start);
+
+   std::printf("quotes (dispatched, %s): %u events, %llu queued, %llu dropped, %llu conflated, %llu waits, "
+      "max depth %u, CQGCEL thread %.3f s, delivered in %.3f s, latency avg %.1f us max %.1f us\n",
+      policyName, delivered, stats.queued - startEvents, stats.dropped, stats.conflated, stats.waits,
+      stats.maxDepth, pumpElapsed, elapsed, stats.avgLatencyUs, stats.maxLatencyUs);
+}
+
+/// @brief Measures quote storm delivery with market depth books maintained by facade.
+void BenchMarketDepth(unsigned quoteEvents, unsigned symbolsCount)
+{
+   cqg::FacadeSettings settings;
+   settings.quoteEvents = true;
+   settings.deltaQuotes = true;
+   settings.marketDepth = true;
+
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount, settings);
+
+   const Clock::time_point start = Clock::now();
+   const unsigned delivered = api->PumpEvents(quoteEvents);
+   const double elapsed = SecondsSince(start);
+
+   unsigned levels = 0;
+   cqg::MarketDepth depth;
+   const Clock::time_point snapshotStart = Clock::now();
+   for(cqg::SymbolId id = 0; id < symbolsCount; ++id)
+   {
+      if(api->GetMarketDepth(id, depth))
+      {
+         levels += depth.bidsCount + depth.asksCount;
+      }
+   }
+   const double snapshotElapsed = SecondsSince(snapshotStart);
+
+   std::printf("market depth: %u events, %llu depth updates, %llu level changes, %u book levels in %.3f s, "
+      "%.0f events/s, %.2f us per snapshot\n",
+      delivered, events.depthUpdates, events.depthChanges, levels, elapsed, delivered / elapsed,
+      snapshotElapsed * 1e6 / std::max(symbolsCount, 1u));
+}
+
+/// @class DepthBookEvents
+/// @brief Rebuilds market depth books of symbols from depth updates.
+struct DepthBookEvents : BenchEvents
+{
+   /// @brief Levels by price in millionths, prices of the same level may differ in the last bits.
+   typedef std::map<long long, cqg::Volume> Levels;
+
+   static long long Key(const cqg::Price price)
+   {
+      return static_cast<long long>(std::floor(price * 1e6 + 0.5));
+   }
+
+   virtual void OnDepthUpdate(const cqg::DepthUpdate& update)
+   {
+      BenchEvents::OnDepthUpdate(update);
+
+      if(update.symbolId >= bids.size())
+      {
+         bids.resize(update.symbolId + 1);
+         asks.resize(update.symbolId + 1);
+      }
+
+      for(unsigned i = 0; i < update.count; ++i)
+      {
+         const cqg::DepthChange& change = update.changes[i];
+         Levels& levels = change.bid ? bids[update.symbolId] : asks[update.symbolId];
+
+         if(change.volume) levels[Key(change.price)] = change.volume;
+         else levels.erase(Key(change.price));
+      }
+   }
+
+   /// @brief Checks whether rebuilt symbol book has exactly levels of given depth.
+   bool Matches(const cqg::MarketDepth& depth) const
+   {
+      const Levels empty;
+      const Levels& bidLevels = depth.symbolId < bids.size() ? bids[depth.symbolId] : empty;
+      const Levels& askLevels = depth.symbolId < asks.size() ? asks[depth.symbolId] : empty;
+
+      if(bidLevels.size() != depth.bidsCount || askLevels.size() != depth.asksCount)
+      {
+         return false;
+      }
+
+      for(unsigned i = 0; i < depth.bidsCount; ++i)
+      {
+         const Levels::const_iterator it = bidLevels.find(Key(depth.bids[i].price));
+         if(it == bidLevels.end() || it->second != depth.bids[i].volume) return false;
+      }
+
+      for(unsigned i = 0; i < depth.asksCount; ++i)
+      {
+         const Levels::const_iterator it = askLevels.find(Key(depth.asks[i].price));
+         if(it == askLevels.end() || it->second != depth.asks[i].volume) return false;
+      }
+
+      return true;
+   }
+
+   std::vector<Levels> bids;
+   std::vector<Levels> asks;
+};
+
+/// @brief Checks that depth updates survive dropping quote updates by overflowing dispatch queue,
+///        books rebuilt from depth updates must match facade books.
+void BenchDispatchedDepth(unsigned quoteEvents, unsigned symbolsCount)
+{
+   cqg::FacadeSettings settings;
+   settings.quoteEvents = true;
+   settings.deltaQuotes = true;
+   settings.marketDepth = true;
+   settings.dispatchThreads = 1;
+   settings.dispatchQueueSize = 256;
+   settings.overflowPolicy = cqg::DropOldestOnOverflow;
+
+   DepthBookEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount, settings);
+
+   const Clock::time_point start = Clock::now();
+   const unsigned delivered = api->PumpEvents(quoteEvents);
+
+   cqg::DispatchStats stats;
+   for(;;)
+   {
+      api->GetDispatchStats(stats);
+      if(stats.depth == 0 && stats.delivered + stats.dropped == stats.queued) break;
+      std::this_thread::yield();
+   }
+   const double elapsed = SecondsSince(start);
+
+   unsigned matched = 0;
+   cqg::MarketDepth depth;
+   for(cqg::SymbolId id = 0; id < symbolsCount; ++id)
+   {
+      if(api->GetMarketDepth(id, depth) && events.Matches(depth))
+      {
+         ++matched;
+      }
+   }
+
+   std::printf("market depth (dispatched, drop oldest): %u events, %llu dropped, %llu depth updates, "
+      "%u of %u rebuilt books match in %.3f s\n",
+      delivered, stats.dropped, events.depthUpdates, matched, symbolsCount, elapsed);
+}
+
+/// @brief Measures bar kernels over interleaved bars versus bar columns.
+/// @param window [in] rolling window length.
+/// @param repeats [in] number of times each kernel runs.
+void BenchBarColumns(long barsCount, size_t window, unsigned repeats)
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 0);
+
+   cqg::BarsRequest request;
+   request.symbol = "SYM0";
+   request.useIndexRange = true;
+   request.startIndex = 0;
+   request.endIndex = 1 - barsCount;
+   request.intradayPeriodInMinutes = 1;
+   request.sessionsFilter = cqg::BarsRequest::UseAllSessions;
+   request.subscribe = false;
+   request.priority = cqg::InteractiveBars;
+
+   api->RequestBars(request);
+   while(events.barsReceived == 0 && api->PumpEvents(1) != 0) {}
+
+   const cqg::BarInfos& bars = events.lastBars.bars;
+   const size_t count = bars.size();
+   std::vector<double> result(count);
+
+   double aosChecksum = 0.0;
+   Clock::time_point start = Clock::now();
+   for(unsigned r = 0; r < repeats; ++r)
+   {
+      cqg::Price high = bars[0].high;
+      cqg::Price low = bars[0].low;
+      for(size_t i = 1; i < count; ++i)
+      {
+         high = std::max(high, bars[i].high);
+         low = std::min(low, bars[i].low);
+      }
+
+      result[0] = bars[0].high - bars[0].low;
+      for(size_t i = 1; i < count; ++i)
+      {
+         result[i] = std::max(bars[i].high, bars[i - 1].close) - std::min(bars[i].low, bars[i - 1].close);
+      }
+
+      for(size_t i = 0; i + 1 < count; ++i)
+      {
+         aosChecksum += bars[i + 1].close / bars[i].close - 1.0;
+      }
+
+      for(size_t i = 0; i < count; ++i)
+      {
+         cqg::Price maximum = bars[i].high;
+         for(size_t j = i >= window ? i - window + 1 : 0; j < i; ++j) maximum = std::max(maximum, bars[j].high);
+         aosChecksum += maximum;
+      }
+
+      aosChecksum += high - low + result[count - 1];
+   }
+   const double aosElapsed = SecondsSince(start);
+
+   start = Clock::now();
+   const cqg::BarColumns columns(bars);
+   const double convertElapsed = SecondsSince(start);
+
+   double soaChecksum = 0.0;
+   start = Clock::now();
+   for(unsigned r = 0; r < repeats; ++r)
+   {
+      cqg::Price high = 0.0;
+      cqg::Price low = 0.0;
+      cqg::GetHighLow(columns, 0, count, high, low);
+
+      cqg::GetTrueRanges(columns, &result[0]);
+      const double trueRange = result[count - 1];
+
+      cqg::GetReturns(columns.Close(), count, &result[0]);
+      for(size_t i = 0; i + 1 < count; ++i) soaChecksum += result[i];
+
+      cqg::GetRollingMax(columns.High(), count, window, &result[0]);
+      for(size_t i = 0; i < count; ++i) soaChecksum += result[i];
+
+      soaChecksum += high - low + trueRange;
+   }
+   const double soaElapsed = SecondsSince(start);
+
+   std::printf("bar columns: %u bars, window %u, interleaved %.3f ms, columns %.3f ms (conversion %.3f ms), "
+      "checksums %.6f / %.6f\n",
+      static_cast<unsigned>(count), static_cast<unsigned>(window), aosElapsed * 1e3 / repeats,
+      soaElapsed * 1e3 / repeats, convertElapsed * 1e3, aosChecksum, soaChecksum);
+}
+
+/// @brief Indicator values of bars.
+struct IndicatorValues
+{
+   double sma;
+   double ema;
+   double upper;
+   double atr;
+   double vwap;
+};
+
+/// @brief Calculates indicators over all bars so far like strategy recomputing them on each bar.
+IndicatorValues RecomputeIndicators(const cqg::BarInfos& bars, size_t count, size_t period)
+{
+   IndicatorValues values;
+
+   const size_t first = count > period ? count - period : 0;
+   double sum = 0.0;
+   for(size_t i = first; i < count; ++i) sum += bars[i].close;
+   values.sma = sum / (count - first);
+
+   double variance = 0.0;
+   for(size_t i = first; i < count; ++i) variance += (bars[i].close - values.sma) * (bars[i].close - values.sma);
+   values.upper = values.sma + 2.0 * std::sqrt(variance / (count - first));
+
+   const double alpha = 2.0 / (period + 1);
+   values.ema = bars[0].close;
+   for(size_t i = 1; i < count; ++i) values.ema += alpha * (bars[i].close - values.ema);
+
+   values.atr = bars[0].high - bars[0].low;
+   for(size_t i = 1; i < count; ++i)
+   {
+      const double trueRange =
+         std::max(bars[i].high, bars[i - 1].close) - std::min(bars[i].low, bars[i - 1].close);
+      values.atr += (trueRange - values.atr) / period;
+   }
+
+   double priceVolume = 0.0;
+   double volume = 0.0;
+   for(size_t i = 0; i < count; ++i)
+   {
+      priceVolume += (bars[i].high + bars[i].low + bars[i].close) / 3.0 * bars[i].volume;
+      volume += bars[i].volume;
+   }
+   values.vwap = volume > 0.0 ? priceVolume / volume : 0.0;
+
+   return values;
+}
+
+/// @brief Checks whether indicator values match within rounding errors.
+bool SameIndicators(const IndicatorValues& lhs, const IndicatorValues& rhs)
+{
+   const double values[][2] = { { lhs.sma, rhs.sma }, { lhs.ema, rhs.ema }, { lhs.upper, rhs.upper },
+      { lhs.atr, rhs.atr }, { lhs.vwap, rhs.vwap } };
+
+   for(size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+   {
+      if(std::fabs(values[i][0] - values[i][1]) > 1e-8 * std::max(1.0, std::fabs(values[i][1])))
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+/// @brief Streaming indicators set of bench.
+struct StreamingIndicators
+{
+   explicit StreamingIndicators(size_t period):
+      sma(period), ema(period), bands(period, 2.0), atr(period)
+   {}
+
+   void Init(const cqg::BarColumns& bars)
+   {
+      sma.Init(bars);
+      ema.Init(bars);
+      bands.Init(bars);
+      atr.Init(bars);
+      vwap.Init(bars);
+   }
+
+   void Add(const cqg::BarInfo& bar)
+   {
+      sma.Add(bar);
+      ema.Add(bar);
+      bands.Add(bar);
+      atr.Add(bar);
+      vwap.Add(bar);
+   }
+
+   void ReplaceLast(const cqg::BarInfo& bar)
+   {
+      sma.ReplaceLast(bar);
+      ema.ReplaceLast(bar);
+      bands.ReplaceLast(bar);
+      atr.ReplaceLast(bar);
+      vwap.ReplaceLast(bar);
+   }
+
+   IndicatorValues Values() const
+   {
+      IndicatorValues values;
+      values.sma = sma.Value();
+      values.ema = ema.Value();
+      values.upper = bands.Upper();
+      values.atr = atr.Value();
+      values.vwap = vwap.Value();
+      return values;
+   }
+
+   cqg::SMA sma;
+   cqg::EMA ema;
+   cqg::BollingerBands bands;
+   cqg::ATR atr;
+   cqg::VWAP vwap;
+};
+
+/// @brief Measures streaming indicators versus recomputing them over bars history on each bar,
+///        and vectorized initialization from history versus adding bars one by one.
+/// @param updates [in] number of the latest bars streamed, each is added & then updated once.
+void BenchIndicators(long barsCount, size_t updates, size_t period)
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 0);
+
+   cqg::BarsRequest request;
+   request.symbol = "SYM0";
+   request.useIndexRange = true;
+   request.startIndex = 0;
+   request.endIndex = 1 - barsCount;
+   request.intradayPeriodInMinutes = 1;
+   request.sessionsFilter = cqg::BarsRequest::UseAllSessions;
+   request.subscribe = false;
+   request.priority = cqg::InteractiveBars;
+
+   api->RequestBars(request);
+   while(events.barsReceived == 0 && api->PumpEvents(1) != 0) {}
+
+   const cqg::BarInfos& bars = events.lastBars.bars;
+   const size_t count = bars.size();
+   updates = std::min(updates, count - 1);
+   const size_t history = count - updates;
+
+   const cqg::BarColumns columns(cqg::BarInfos(bars.begin(), bars.begin() + history));
+
+   StreamingIndicators sequential(period);
+   Clock::time_point start = Clock::now();
+   for(size_t i = 0; i < history; ++i) sequential.Add(bars[i]);
+   const double sequentialElapsed = SecondsSince(start);
+
+   StreamingIndicators streaming(period);
+   start = Clock::now();
+   streaming.Init(columns);
+   const double initElapsed = SecondsSince(start);
+
+   bool same = SameIndicators(streaming.Values(), sequential.Values()) &&
+      SameIndicators(streaming.Values(), RecomputeIndicators(bars, history, period));
+
+   // Bar is added with its open price first & updated to final bar later, like current bar.
+   double recomputeChecksum = 0.0;
+   start = Clock::now();
+   for(size_t i = history; i < count; ++i)
+   {
+      recomputeChecksum += RecomputeIndicators(bars, i + 1, period).ema;
+      recomputeChecksum += RecomputeIndicators(bars, i + 1, period).ema;
+   }
+   const double recomputeElapsed = SecondsSince(start);
+
+   double streamingChecksum = 0.0;
+   start = Clock::now();
+   for(size_t i = history; i < count; ++i)
+   {
+      cqg::BarInfo opened = bars[i];
+      opened.high = opened.low = opened.close = opened.open;
+
+      streaming.Add(opened);
+      streamingChecksum += streaming.ema.Value();
+      streaming.ReplaceLast(bars[i]);
+      streamingChecksum += streaming.ema.Value();
+   }
+   const double streamingElapsed = SecondsSince(start);
+
+   same = same && SameIndicators(streaming.Values(), RecomputeIndicators(bars, count, period));
+
+   std::printf("indicators: %u bars history, period %u, init %.3f ms (%.3f ms bar by bar), "
+      "%u bar updates %.1f ns each (%.1f us recomputing history), %s\n",
+      static_cast<unsigned>(history), static_cast<unsigned>(period), initElapsed * 1e3, sequentialElapsed * 1e3,
+      static_cast<unsigned>(updates * 2), streamingElapsed * 1e9 / (updates * 2),
+      recomputeElapsed * 1e6 / (updates * 2), same ? "same values as recomputed" : "DIFFERENT values");
+}
+
+/// @brief Requests bars from new simulated facade and waits for them.
+/// @param lineTime [in] simulated Line Time.
+/// @param cacheDirectory [in] bar cache directory, empty to disable cache.
+/// @param bars [out] received bars.
+/// @return Seconds from request to reception.
+double RequestSimulatedBars(
+   const cqg::BarsRequest& request,
+   const cqg::COleDateTime& lineTime,
+   const cqg::CString& cacheDirectory,
+   cqg::Bars& bars)
+{
+   cqg::SimulationSettings simulation;
+   simulation.startTime = lineTime;
+
+   cqg::FacadeSettings settings;
+   settings.barCacheDirectory = cacheDirectory;
+
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = cqg::IAPIFacade::CreateSimulated(simulation);
+   if(!api->Initialize(&events, settings))
+   {
+      std::printf("Unable to initialize: %s\n", api->GetLastError().GetString());
+      std::exit(1);
+   }
+
+   const Clock::time_point start = Clock::now();
+   api->RequestBars(request);
+   while(events.barsReceived == 0 && api->PumpEvents(1) != 0) {}
+   const double elapsed = SecondsSince(start);
+
+   bars = events.lastBars;
+   return elapsed;
+}
+
+/// @brief Measures bars request served from bar cache after restart versus cold request.
+/// @param newBars [in] number of bars added since cold request.
+void BenchBarCache(long barsCount, long newBars)
+{
+   const cqg::CString directory("CQGAPIFacadeBench.cache");
+   std::remove((directory + "/SYM0_1_31.bars").GetString());
+
+   cqg::BarsRequest request;
+   request.symbol = "SYM0";
+   request.useIndexRange = true;
+   request.startIndex = 0;
+   request.endIndex = 1 - barsCount;
+   request.intradayPeriodInMinutes = 1;
+   request.sessionsFilter = cqg::BarsRequest::UseAllSessions;
+   request.subscribe = false;
+   request.priority = cqg::InteractiveBars;
+
+   const cqg::COleDateTime coldTime = cqg::SimulationSettings().startTime;
+   const cqg::COleDateTime warmTime(coldTime.m_dt + newBars / (24.0 * 60.0));
+
+   cqg::Bars cold;
+   const double coldElapsed = RequestSimulatedBars(request, coldTime, directory, cold);
+
+   cqg::Bars warm;
+   const double warmElapsed = RequestSimulatedBars(request, warmTime, directory, warm);
+
+   cqg::Bars expected;
+   RequestSimulatedBars(request, warmTime, cqg::CString(), expected);
+
+   bool same = warm.bars.size() == expected.bars.size();
+   for(size_t i = 0; same && i < warm.bars.size(); ++i)
+   {
+      const cqg::BarInfo& lhs = warm.bars[i];
+      const cqg::BarInfo& rhs = expected.bars[i];
+      same = lhs.timestamp.m_dt == rhs.timestamp.m_dt && lhs.open == rhs.open && lhs.high == rhs.high &&
+         lhs.low == rhs.low && lhs.close == rhs.close && lhs.volume == rhs.volume;
+   }
+
+   std::printf("bar cache: %u bars, cold %.3f ms, after restart %.3f ms (%ld cached, %u received), %s\n",
+      static_cast<unsigned>(cold.bars.size()), coldElapsed * 1e3, warmElapsed * 1e3, warm.cachedCount,
+      static_cast<unsigned>(warm.bars.size() - warm.cachedCount), same ? "same as uncached" : "DIFFERS from uncached");
+}
+
+/// @class KeepingBarsEvents
+/// @brief Keeps received bars by request guid.
+struct KeepingBarsEvents : BenchEvents
+{
+   virtual void OnBarsReceived(const cqg::Bars& bars)
+   {
+      BenchEvents::OnBarsReceived(bars);
+      received[bars.requestGuid] = bars;
+   }
+
+   std::map<cqg::CString, cqg::Bars> received;
+};
+
+/// @brief Makes two rounds of overlapping bars requests and waits for all results.
+/// @param results [out] bars of each request in request order.
+/// @return Seconds taken.
+double RequestOverlappingBars(
+   unsigned symbolsCount,
+   unsigned windowsCount,
+   const cqg::FacadeSettings& settings,
+   std::vector<cqg::Bars>& results,
+   cqg::BarsCacheStats& stats)
+{
+   KeepingBarsEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 0, settings);
+
+   const cqg::DATE lineTime = api->GetLineTime().m_dt;
+   const double period = 1.0 / (24.0 * 60.0);
+
+   std::vector<cqg::CString> guids;
+   const Clock::time_point start = Clock::now();
+
+   // The first round is served by outstanding requests, the second one from memory,
+   // except requests including the current bar.
+   for(int round = 0; round < 2; ++round)
+   {
+      for(unsigned i = 0; i < symbolsCount; ++i)
+      {
+         cqg::BarsRequest request;
+         request.symbol.Format("SYM%u", i);
+         request.intradayPeriodInMinutes = 1;
+         request.sessionsFilter = cqg::BarsRequest::UseAllSessions;
+         request.subscribe = false;
+         request.priority = cqg::InteractiveBars;
+
+         request.useIndexRange = false;
+         request.startDate = cqg::COleDateTime(lineTime - 10.0);
+         request.endDate = cqg::COleDateTime(lineTime);
+         guids.push_back(api->RequestBars(request));
+
+         request.useIndexRange = true;
+         request.startIndex = 0;
+         request.endIndex = -5000;
+         guids.push_back(api->RequestBars(request));
+
+         for(unsigned w = 0; w < windowsCount; ++w)
+         {
+            request.useIndexRange = false;
+            request.startDate = cqg::COleDateTime(lineTime - 10.0 + w * 0.5);
+            request.endDate = cqg::COleDateTime(request.startDate.m_dt + 1.0 - period);
+            guids.push_back(api->RequestBars(request));
+
+            request.useIndexRange = true;
+            request.startIndex = -1;
+            request.endIndex = -100 * static_cast<long>(w + 1);
+            guids.push_back(api->RequestBars(request));
+         }
+      }
+
+      while(events.received.size() < guids.size() && api->PumpEvents(1) != 0) {}
+   }
+
+   const double elapsed = SecondsSince(start);
+
+   results.clear();
+   for(size_t i = 0; i < guids.size(); ++i)
+   {
+      results.push_back(events.received[guids[i]]);
+   }
+
+   api->GetBarsCacheStats(stats);
+   return elapsed;
+}
+
+/// @brief Measures queue & service times of backfill & interactive bars requests over limited CQGCEL requests.
+void BenchBarsScheduler(unsigned backfillCount, unsigned interactiveCount, unsigned maxRequests)
+{
+   cqg::FacadeSettings settings;
+   settings.maxBarsRequests = maxRequests;
+
+   KeepingBarsEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 0, settings);
+
+   cqg::BarsRequest request;
+   request.intradayPeriodInMinutes = 1;
+   request.sessionsFilter = cqg::BarsRequest::UseAllSessions;
+   request.subscribe = false;
+   request.useIndexRange = true;
+   request.startIndex = 0;
+   request.endIndex = -10000;
+
+   std::vector<cqg::CString> backfill;
+   std::vector<cqg::CString> interactive;
+   std::vector<cqg::CString> duplicates;
+
+   const Clock::time_point start = Clock::now();
+
+   request.priority = cqg::BackfillBars;
+   for(unsigned i = 0; i < backfillCount; ++i)
+   {
+      request.symbol.Format("BACK%u", i);
+      backfill.push_back(api->RequestBars(request));
+   }
+
+   // Interactive requests jump over queued backfill, each one repeated twice.
+   request.priority = cqg::InteractiveBars;
+   for(unsigned i = 0; i < interactiveCount; ++i)
+   {
+      request.symbol.Format("SYM%u", i);
+      interactive.push_back(api->RequestBars(request));
+      duplicates.push_back(api->RequestBars(request));
+   }
+
+   const size_t total = backfill.size() + interactive.size() + duplicates.size();
+   while(events.received.size() < total && api->PumpEvents(1) != 0) {}
+
+   const double elapsed = SecondsSince(start);
+
+   double backfillQueueMs = 0.0;
+   for(size_t i = 0; i < backfill.size(); ++i)
+   {
+      backfillQueueMs += events.received[backfill[i]].queueMs;
+   }
+
+   double interactiveQueueMs = 0.0;
+   double interactiveServiceMs = 0.0;
+   bool same = true;
+   for(size_t i = 0; i < interactive.size(); ++i)
+   {
+      const cqg::Bars& bars = events.received[interactive[i]];
+      const cqg::Bars& duplicate = events.received[duplicates[i]];
+      interactiveQueueMs += bars.queueMs;
+      interactiveServiceMs += bars.serviceMs;
+      same = same && bars.bars.size() == duplicate.bars.size() && !bars.bars.empty() &&
+         bars.bars.back().close == duplicate.bars.back().close;
+   }
+
+   std::printf("bars scheduler: %u backfill & %u interactive requests over %u CQGCEL requests, "
+      "avg queue backfill %.3f ms, interactive %.3f ms (service %.3f ms), duplicates %s, %.3f s\n",
+      backfillCount, interactiveCount, maxRequests,
+      backfill.empty() ? 0.0 : backfillQueueMs / backfill.size(),
+      interactive.empty() ? 0.0 : interactiveQueueMs / interactive.size(),
+      interactive.empty() ? 0.0 : interactiveServiceMs / interactive.size(),
+      same ? "share results" : "DIFFER", elapsed);
+}
+
+/// @brief Measures overlapping bars requests served via memory cache versus separate CQGCEL requests.
+void BenchBarIntervals(unsigned symbolsCount, unsigned windowsCount)
+{
+   cqg::FacadeSettings settings;
+   settings.barMemoryCacheSize = 10000000;
+
+   std::vector<cqg::Bars> cached;
+   cqg::BarsCacheStats stats;
+   const double cachedElapsed = RequestOverlappingBars(symbolsCount, windowsCount, settings, cached, stats);
+
+   std::vector<cqg::Bars> direct;
+   cqg::BarsCacheStats directStats;
+   const double directElapsed =
+      RequestOverlappingBars(symbolsCount, windowsCount, cqg::FacadeSettings(), direct, directStats);
+
+   bool same = cached.size() == direct.size();
+   for(size_t i = 0; same && i < cached.size(); ++i)
+   {
+      same = cached[i].bars.size() == direct[i].bars.size() && cached[i].requestedCount == direct[i].requestedCount;
+      for(size_t j = 0; same && j < cached[i].bars.size(); ++j)
+      {
+         const cqg::BarInfo& lhs = cached[i].bars[j];
+         const cqg::BarInfo& rhs = direct[i].bars[j];
+         same = lhs.timestamp.m_dt == rhs.timestamp.m_dt && lhs.open == rhs.open && lhs.high == rhs.high &&
+            lhs.low == rhs.low && lhs.close == rhs.close && lhs.volume == rhs.volume;
+      }
+   }
+
+   std::printf("bar intervals: %u requests, %llu hits, %llu coalesced, %llu misses, %llu CQGCEL requests, "
+      "%u bars in %u series, cached %.3f s, direct %.3f s, %s\n",
+      static_cast<unsigned>(cached.size()), stats.hits, stats.coalesced, stats.misses, stats.upstream,
+      stats.bars, stats.series, cachedElapsed, directElapsed, same ? "same as direct" : "DIFFERS from direct");
+}
+
+/// @brief Measures subscribed bars updates during quote storm.
+void BenchBarUpdates(unsigned quoteEvents, unsigned symbolsCount, unsigned requestsCount, long barsPerRequest)
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount);
+
+   std::vector<cqg::CString> requests;
+   for(unsigned i = 0; i < requestsCount; ++i)
+   {
+      cqg::BarsRequest request;
+      request.symbol.Format("SYM%u", i % symbolsCount);
+      request.useIndexRange = true;
+      request.startIndex = 0;
+      request.endIndex = -barsPerRequest;
+      request.intradayPeriodInMinutes = 1;
+      request.sessionsFilter = cqg::BarsRequest::UseAllSessions;
+      request.subscribe = true;
+      request.priority = cqg::InteractiveBars;
+
+      requests.push_back(api->RequestBars(request));
+   }
+
+   while(events.barsReceived < requestsCount && api->PumpEvents(1) != 0) {}
+
+   const Clock::time_point start = Clock::now();
+   const unsigned delivered = api->PumpEvents(quoteEvents);
+   const double elapsed = SecondsSince(start);
+
+   unsigned long long seriesBars = 0;
+   for(size_t i = 0; i < requests.size(); ++i)
+   {
+      cqg::Bars bars;
+      if(api->GetBars(requests[i], bars)) seriesBars += bars.bars.size();
+      api->CancelBars(requests[i]);
+   }
+
+   std::printf("bar updates: %u events, %u requests, %llu bars added, %llu bars updated, "
+      "%llu bars in series (%llu expected) in %.3f s\n",
+      delivered, requestsCount, events.barsAdded, events.barsUpdated,
+      seriesBars, events.barsCount + events.barsAdded, elapsed);
+}
+
+/// @brief Requests subscribed bars of several periods per symbol & pumps quote events updating them.
+/// @param results [out] final bars of each request in request order.
+/// @return Seconds taken by quote events.
+double RequestMultiPeriodBars(
+   unsigned quoteEvents,
+   unsigned symbolsCount,
+   long barsPerRequest,
+   const cqg::FacadeSettings& settings,
+   std::vector<cqg::Bars>& results,
+   cqg::BarsCacheStats& stats,
+   unsigned long long& barsUpdated)
+{
+   static const long Periods[] = { 5, 15, 30, 60 };
+   const unsigned periodsCount = sizeof(Periods) / sizeof(Periods[0]);
+
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount, settings);
+
+   std::vector<cqg::CString> requests;
+   for(unsigned i = 0; i < symbolsCount; ++i)
+   {
+      for(unsigned p = 0; p < periodsCount; ++p)
+      {
+         cqg::BarsRequest request;
+         request.symbol.Format("SYM%u", i);
+         request.useIndexRange = true;
+         request.startIndex = 0;
+         request.endIndex = 1 - barsPerRequest;
+         request.intradayPeriodInMinutes = Periods[p];
+         request.sessionsFilter = cqg::BarsRequest::UseAllSessions;
+         request.subscribe = true;
+         request.priority = cqg::InteractiveBars;
+
+         requests.push_back(api->RequestBars(request));
+      }
+   }
+
+   while(events.barsReceived < requests.size() && api->PumpEvents(1) != 0) {}
+
+   const Clock::time_point start = Clock::now();
+   api->PumpEvents(quoteEvents);
+   const double elapsed = SecondsSince(start);
+
+   results.clear();
+   for(size_t i = 0; i < requests.size(); ++i)
+   {
+      results.push_back(cqg::Bars());
+      api->GetBars(requests[i], results.back());
+      api->CancelBars(requests[i]);
+   }
+
+   api->GetBarsCacheStats(stats);
+   barsUpdated = events.barsAdded + events.barsUpdated;
+   return elapsed;
+}
+
+/// @brief Measures subscribed bars of several periods derived from 1 minute bars versus separate CQGCEL requests.
+void BenchDerivedBars(unsigned quoteEvents, unsigned symbolsCount, long barsPerRequest)
+{
+   cqg::FacadeSettings settings;
+   settings.baseBarPeriodInMinutes = 1;
+
+   std::vector<cqg::Bars> derived;
+   cqg::BarsCacheStats stats;
+   unsigned long long derivedUpdates = 0;
+   const double derivedElapsed =
+      RequestMultiPeriodBars(quoteEvents, symbolsCount, barsPerRequest, settings, derived, stats, derivedUpdates);
+
+   std::vector<cqg::Bars> direct;
+   cqg::BarsCacheStats directStats;
+   unsigned long long directUpdates = 0;
+   const double directElapsed = RequestMultiPeriodBars(
+      quoteEvents, symbolsCount, barsPerRequest, cqg::FacadeSettings(), direct, directStats, directUpdates);
+
+   // Simulated bars of each period are independent, so only bar times are comparable.
+   bool same = derived.size() == direct.size();
+   for(size_t i = 0; same && i < derived.size(); ++i)
+   {
+      same = !derived[i].bars.empty() && derived[i].bars.size() == direct[i].bars.size();
+      for(size_t j = 0; same && j < derived[i].bars.size(); ++j)
+      {
+         same = std::abs(derived[i].bars[j].timestamp.m_dt - direct[i].bars[j].timestamp.m_dt) < 1e-8;
+      }
+   }
+
+   std::printf("derived bars: %u requests, %llu derived from %llu CQGCEL requests (direct %u), "
+      "%llu / %llu bar changes, derived %.3f s, direct %.3f s, %s\n",
+      static_cast<unsigned>(derived.size()), stats.derived, stats.upstream, static_cast<unsigned>(direct.size()),
+      derivedUpdates, directUpdates, derivedElapsed, directElapsed,
+      same ? "same bar times as direct" : "DIFFERS from direct");
+}
+
+/// @brief Measures quote updates with time, tick, volume & range bars built from trades of each symbol.
+void BenchTradeBars(unsigned quoteEvents, unsigned symbolsCount)
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount);
+
+   const Clock::time_point plainStart = Clock::now();
+   api->PumpEvents(quoteEvents);
+   const double plainElapsed = SecondsSince(plainStart);
+
+   static const cqg::TradeBarsType Types[] =
+      { cqg::TimeTradeBars, cqg::TickTradeBars, cqg::VolumeTradeBars, cqg::RangeTradeBars };
+   static const double Sizes[] = { 1.0, 10.0, 50.0, 1.0 };
+   const unsigned typesCount = sizeof(Types) / sizeof(Types[0]);
+
+   std::vector<cqg::CString> requests;
+   for(size_t i = 0; i < events.symbols.size(); ++i)
+   {
+      for(unsigned t = 0; t < typesCount; ++t)
+      {
+         cqg::TradeBarsRequest request;
+         request.symbolId = api->GetSymbolId(events.symbols[i]);
+         request.type = Types[t];
+         request.size = Sizes[t];
+         request.maxBars = 1000000;
+         requests.push_back(api->RequestTradeBars(request));
+      }
+
+      // Trade bars keep symbol subscribed.
+      api->UnsubscribeSymbol(api->GetSymbolId(events.symbols[i]));
+   }
+
+   const Clock::time_point start = Clock::now();
+   api->PumpEvents(quoteEvents);
+   const double elapsed = SecondsSince(start);
+
+   // Bars of all types of symbol are built from the same trades.
+   bool consistent = true;
+   unsigned long long bars = 0;
+   for(size_t i = 0; i < requests.size(); i += typesCount)
+   {
+      long long volumes[typesCount] = {};
+      for(unsigned t = 0; t < typesCount; ++t)
+      {
+         cqg::Bars tradeBars;
+         consistent = consistent && api->GetTradeBars(requests[i + t], tradeBars);
+         bars += tradeBars.bars.size();
+
+         for(size_t j = 0; j < tradeBars.bars.size(); ++j)
+         {
+            volumes[t] += tradeBars.bars[j].volume;
+         }
+
+         api->CancelTradeBars(requests[i + t]);
+      }
+
+      for(unsigned t = 1; t < typesCount; ++t)
+      {
+         consistent = consistent && volumes[t] == volumes[0];
+      }
+   }
+
+   std::printf("trade bars: %u events, %u requests, %llu bars (%llu closed), %.1f ns per event "
+      "(%.1f ns without trade bars), %s\n",
+      quoteEvents, static_cast<unsigned>(requests.size()), bars, events.tradeBarsClosed,
+      elapsed * 1e9 / quoteEvents, plainElapsed * 1e9 / quoteEvents,
+      consistent ? "same volume in all bar types" : "INCONSISTENT volumes");
+}
+
+/// @brief Measures order placement & cancellation round trip through facade.
+void BenchOrders(unsigned ordersCount)
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 1);
+
+   cqg::Accounts accounts;
+   api->GetAccounts(accounts);
+   if(accounts.empty() || events.symbols.empty())
+   {
+      std::printf("orders: no accounts or symbols\n");
+      return;
+   }
+
+   std::vector<cqg::CString> guids;
+   guids.reserve(ordersCount);
+
+   // Far from market limit orders, so they keep working until canceled.
+   const Clock::time_point placeStart = Clock::now();
+   for(unsigned i = 0; i < ordersCount; ++i)
+   {
+      guids.push_back(api->PlaceOrder(cqg::Limit, accounts.front().gwAccountID, events.symbols.front(),
+         true, 1, cqg::CString("Bench"), 1.0));
+   }
+   const double placeElapsed = SecondsSince(placeStart);
+
+   while(events.orderEvents < ordersCount && api->PumpEvents(1) != 0) {}
+
+   const Clock::time_point countStart = Clock::now();
+   const int working = api->GetAllWorkingOrdersCount();
+   const int internal = api->GetInternalWorkingOrdersCount(accounts.front().gwAccountID);
+   const int symbolWorking = api->GetSymbolWorkingOrdersCount(events.symbols.front());
+   const double countElapsed = SecondsSince(countStart);
+
+   unsigned found = 0;
+   const Clock::time_point lookupStart = Clock::now();
+   for(unsigned i = 0; i < guids.size(); ++i)
+   {
+      cqg::OrderInfo order;
+      if(api->GetOrder(guids[i], order) && api->GetOrderByGwOrderID(order.gwOrderID, order) &&
+         order.orderGuid == guids[i])
+      {
+         ++found;
+      }
+   }
+   const double lookupElapsed = SecondsSince(lookupStart);
+
+   const Clock::time_point cancelStart = Clock::now();
+   for(unsigned i = 0; i < guids.size(); ++i)
+   {
+      api->CancelOrder(guids[i]);
+   }
+   const double cancelElapsed = SecondsSince(cancelStart);
+
+   while(events.finalOrders < ordersCount && api->PumpEvents(1) != 0) {}
+
+   // Final orders are refused by facade order registry.
+   unsigned refused = 0;
+   for(unsigned i = 0; i < guids.size(); ++i)
+   {
+      refused += api->CancelOrder(guids[i]) ? 0 : 1;
+   }
+
+   std::printf("orders: %u placed in %.3f s (%.2f us/order), %d working (%d internal, %d of symbol) "
+      "counted in %.2f us, "
+      "%u found by guid & gateway ID in %.2f us/order, canceled in %.3f s (%.2f us/order), %u final, "
+      "%u final refused to cancel\n",
+      ordersCount, placeElapsed, placeElapsed * 1e6 / ordersCount,
+      working, internal, symbolWorking, countElapsed * 1e6, found, lookupElapsed * 1e6 / ordersCount,
+      cancelElapsed, cancelElapsed * 1e6 / ordersCount, events.finalOrders, refused);
+}
+
+/// @class QuoteReactiveEvents
+/// @brief Places order on each quote update, like quote-reactive strategy.
+struct QuoteReactiveEvents : BenchEvents
+{
+   QuoteReactiveEvents():
+      api(NULL),
+      ticketId(cqg::InvalidOrderTicketId),
+      gwAccountID(0),
+      ordersLeft(0),
+      placed(0),
+      placeSeconds(0.0)
+   {}
+
+   virtual void OnSymbolQuote(const cqg::SymbolInfo& symbol)
+   {
+      BenchEvents::OnSymbolQuote(symbol);
+
+      if(!ordersLeft)
+      {
+         return;
+      }
+
+      --ordersLeft;
+
+      // Far from market limit orders, so they keep working until canceled.
+      const Clock::time_point start = Clock::now();
+      const cqg::CString orderGuid = ticketId != cqg::InvalidOrderTicketId ?
+         api->SubmitOrderTicket(ticketId, 1.0) :
+         api->PlaceOrder(cqg::Limit, gwAccountID, symbol.fullName, true, 1, cqg::CString("Bench"), 1.0);
+      placeSeconds += SecondsSince(start);
+
+      placed += orderGuid.IsEmpty() ? 0 : 1;
+   }
+
+   cqg::IAPIFacade* api;           ///< Facade placing orders.
+   cqg::OrderTicketId ticketId;    ///< Ticket to submit, invalid to place orders one by one.
+   cqg::ID gwAccountID;            ///< Orders account.
+   unsigned ordersLeft;            ///< Number of orders to place yet.
+   unsigned placed;                ///< Number of orders placed.
+   double placeSeconds;            ///< Time spent placing orders.
+};
+
+/// @brief Places orders from quote updates by PlaceOrder() or prepared order ticket.
+/// @return Seconds per placed order.
+double PlaceQuoteReactiveOrders(unsigned ordersCount, bool useTicket, unsigned& placed)
+{
+   QuoteReactiveEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 1);
+
+   cqg::Accounts accounts;
+   api->GetAccounts(accounts);
+   if(accounts.empty() || events.symbols.empty())
+   {
+      placed = 0;
+      return 0.0;
+   }
+
+   events.api = api.get();
+   events.gwAccountID = accounts.front().gwAccountID;
+   events.ordersLeft = ordersCount;
+
+   if(useTicket)
+   {
+      cqg::OrderTicket ticket;
+      ticket.type = cqg::Limit;
+      ticket.gwAccountID = events.gwAccountID;
+      ticket.symbolFullName = events.symbols.front();
+      ticket.buy = true;
+      ticket.quantity = 1;
+      ticket.description = "Bench";
+      events.ticketId = api->PrepareOrderTicket(ticket);
+   }
+
+   while(events.ordersLeft && api->PumpEvents(1) != 0) {}
+
+   api->CancelAllOrders();
+   if(useTicket)
+   {
+      api->ReleaseOrderTicket(events.ticketId);
+   }
+
+   placed = events.placed;
+   return events.placed ? events.placeSeconds / events.placed : 0.0;
+}
+
+/// @brief Checks that identifier of released ticket is refused once its slot is reused.
+bool IsReleasedTicketRefused()
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 1);
+
+   cqg::Accounts accounts;
+   api->GetAccounts(accounts);
+   if(accounts.empty() || events.symbols.empty())
+   {
+      return false;
+   }
+
+   cqg::OrderTicket ticket;
+   ticket.type = cqg::Limit;
+   ticket.gwAccountID = accounts.front().gwAccountID;
+   ticket.symbolFullName = events.symbols.front();
+   ticket.description = "Bench";
+
+   const cqg::OrderTicketId released = api->PrepareOrderTicket(ticket);
+   api->ReleaseOrderTicket(released);
+
+   ticket.buy = false;
+   const cqg::OrderTicketId reused = api->PrepareOrderTicket(ticket);
+
+   const bool refused = reused != released && api->SubmitOrderTicket(released, 1.0).IsEmpty() &&
+      !api->ReleaseOrderTicket(released) && !api->SubmitOrderTicket(reused, 1000.0).IsEmpty();
+
+   api->CancelAllOrders();
+   api->ReleaseOrderTicket(reused);
+   return refused;
+}
+
+/// @brief Measures tick-to-order time of orders placed from quote updates.
+void BenchOrderTickets(unsigned ordersCount)
+{
+   unsigned placed = 0;
+   const double placeOrder = PlaceQuoteReactiveOrders(ordersCount, false, placed);
+
+   unsigned submitted = 0;
+   const double submitTicket = PlaceQuoteReactiveOrders(ordersCount, true, submitted);
+
+   std::printf("order tickets: tick-to-order %.2f us by PlaceOrder (%u orders), %.2f us by ticket (%u orders), "
+      "released ticket %s\n",
+      placeOrder * 1e6, placed, submitTicket * 1e6, submitted, IsReleasedTicketRefused() ? "refused" : "ACCEPTED");
+}
+
+/// @brief Compares orders placing & cancelling one by one and by batches.
+void BenchOrderBatches(unsigned batchesCount, unsigned batchSize)
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 1);
+
+   cqg::Accounts accounts;
+   api->GetAccounts(accounts);
+   if(accounts.empty() || events.symbols.empty())
+   {
+      std::printf("order batches: no accounts or symbols\n");
+      return;
+   }
+
+   // Far from market limit orders of both sides, so they keep working until canceled.
+   cqg::OrderRequests requests(batchSize);
+   for(unsigned i = 0; i < batchSize; ++i)
+   {
+      cqg::OrderRequest& request = requests[i];
+      request.type = cqg::Limit;
+      request.gwAccountID = accounts.front().gwAccountID;
+      request.symbolFullName = events.symbols.front();
+      request.buy = i % 2 == 0;
+      request.quantity = 1;
+      request.description = "Bench";
+      request.price = request.buy ? 1.0 : 1e6;
+   }
+
+   double singlePlace = 0.0;
+   double singleCancel = 0.0;
+   cqg::OrderGuids guids(batchSize);
+
+   for(unsigned batch = 0; batch < batchesCount; ++batch)
+   {
+      Clock::time_point start = Clock::now();
+      for(unsigned i = 0; i < batchSize; ++i)
+      {
+         const cqg::OrderRequest& request = requests[i];
+         guids[i] = api->PlaceOrder(request.type, request.gwAccountID, request.symbolFullName, request.buy,
+            request.quantity, request.description, request.price);
+      }
+      singlePlace += SecondsSince(start);
+
+      start = Clock::now();
+      for(unsigned i = 0; i < batchSize; ++i)
+      {
+         api->CancelOrder(guids[i]);
+      }
+      singleCancel += SecondsSince(start);
+   }
+
+   cqg::OrderResults results;
+   unsigned placed = 0;
+   unsigned canceled = 0;
+
+   for(unsigned batch = 0; batch < batchesCount; ++batch)
+   {
+      placed += api->PlaceOrders(requests, results);
+
+      for(unsigned i = 0; i < batchSize; ++i)
+      {
+         guids[i] = results[i].orderGuid;
+      }
+
+      canceled += api->CancelOrders(guids, results);
+   }
+
+   cqg::OrderBatchStats stats;
+   api->GetOrderBatchStats(stats);
+
+   const double orders = static_cast<double>(batchesCount) * batchSize;
+   std::printf("order batches: %u x %u orders, one by one place %.2f us/order, cancel %.2f us/order; "
+      "batches place %.2f us/order (%.1f us/batch, max %.1f us), cancel %.2f us/order (%.1f us/batch), "
+      "%u placed, %u canceled, %llu failed\n",
+      batchesCount, batchSize, singlePlace * 1e6 / orders, singleCancel * 1e6 / orders,
+      stats.place.avgOrderUs, stats.place.avgBatchUs, stats.place.maxBatchUs,
+      stats.cancel.avgOrderUs, stats.cancel.avgBatchUs,
+      placed, canceled, stats.place.failed + stats.cancel.failed);
+}
+
+/// @brief Compares moving working orders by ModifyOrder() and by cancel & replace.
+void BenchOrderModify(unsigned ordersCount)
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 1);
+
+   cqg::Accounts accounts;
+   api->GetAccounts(accounts);
+   if(accounts.empty() || events.symbols.empty())
+   {
+      std::printf("order modify: no accounts or symbols\n");
+      return;
+   }
+
+   const cqg::ID gwAccountID = accounts.front().gwAccountID;
+   const cqg::CString& symbol = events.symbols.front();
+
+   // Far from market limit orders, so they keep working at new prices as well.
+   cqg::OrderGuids guids(ordersCount);
+   for(unsigned i = 0; i < ordersCount; ++i)
+   {
+      guids[i] = api->PlaceOrder(cqg::Limit, gwAccountID, symbol, true, 1, cqg::CString("Bench"), 1.0);
+   }
+
+   while(events.orderEvents < ordersCount && api->PumpEvents(1) != 0) {}
+
+   const Clock::time_point modifyStart = Clock::now();
+   unsigned modified = 0;
+   for(unsigned i = 0; i < ordersCount; ++i)
+   {
+      modified += api->ModifyOrder(guids[i], 2.0, cqg::OrderPrice(), 2) ? 1 : 0;
+   }
+   const double modifyElapsed = SecondsSince(modifyStart);
+
+   // Another modification is refused until gateway acknowledges pending one.
+   const unsigned refused = api->ModifyOrder(guids.front(), 3.0) ? 0 : 1;
+
+   cqg::OrderModifyStats stats;
+   do
+   {
+      api->GetOrderModifyStats(stats);
+   }
+   while(stats.pending && api->PumpEvents(1) != 0);
+
+   const Clock::time_point replaceStart = Clock::now();
+   for(unsigned i = 0; i < ordersCount; ++i)
+   {
+      api->CancelOrder(guids[i]);
+      guids[i] = api->PlaceOrder(cqg::Limit, gwAccountID, symbol, true, 2, cqg::CString("Bench"), 3.0);
+   }
+   const double replaceElapsed = SecondsSince(replaceStart);
+
+   api->CancelAllOrders();
+
+   std::printf("order modify: %u of %u modified in %.2f us/order, %llu acknowledged in %.2f us avg "
+      "(max %.1f us), %u refused while pending; cancel & replace %.2f us/order\n",
+      modified, ordersCount, modifyElapsed * 1e6 / ordersCount, stats.acknowledged, stats.avgAckUs,
+      stats.maxAckUs, refused, replaceElapsed * 1e6 / ordersCount);
+}
+
+/// @class FillEvents
+/// @brief Counts order fills reported by order changes or by fill events, checks fill sequence numbers.
+struct FillEvents : BenchEvents
+{
+   FillEvents():
+      fills(0),
+      filledQty(0),
+      stateEvents(0),
+      sequenceGaps(0)
+   {}
+
+   virtual void OnOrderChanged(const cqg::OrderInfo& order)
+   {
+      BenchEvents::OnOrderChanged(order);
+
+      for(size_t i = 0; i < order.orderFills.size(); ++i)
+      {
+         onFill(order.orderGuid, order.fillSeq, order.orderFills[i]);
+      }
+
+      reportedQty[order.orderGuid] = order.filledQty;
+   }
+
+   virtual void OnFill(const cqg::FillEvent& fill)
+   {
+      if(fill.leg == 0)
+      {
+         onFill(fill.orderGuid, fill.fillSeq, fill.fill);
+      }
+   }
+
+   virtual void OnOrderState(const cqg::OrderStateEvent& state)
+   {
+      ++stateEvents;
+      if(state.final) ++finalOrders;
+
+      reportedQty[state.orderGuid] = state.filledQty;
+   }
+
+   void onFill(const cqg::CString& orderGuid, unsigned fillSeq, const cqg::FillInfo& fill)
+   {
+      unsigned& lastSeq = lastFillSeq[orderGuid];
+      sequenceGaps += fillSeq == lastSeq + 1 ? 0 : 1;
+      lastSeq = fillSeq;
+
+      ++fills;
+      filledQty += fill.fillQty;
+      orderFilledQty[orderGuid] += fill.fillQty;
+   }
+
+   /// @brief Gets number of orders whose fills add up to more than order filled quantity.
+   unsigned getDuplicateFills() const
+   {
+      unsigned duplicates = 0;
+      for(std::map<cqg::CString, long long>::const_iterator it = orderFilledQty.begin(); it != orderFilledQty.end(); ++it)
+      {
+         const std::map<cqg::CString, cqg::Quantity>::const_iterator reported = reportedQty.find(it->first);
+         duplicates += reported == reportedQty.end() || it->second > reported->second ? 1 : 0;
+      }
+
+      return duplicates;
+   }
+
+   unsigned fills;                               ///< Number of fills.
+   long long filledQty;                          ///< Filled quantity of all fills.
+   unsigned stateEvents;                         ///< Number of order state events.
+   unsigned sequenceGaps;                        ///< Number of fills not following previous order fill.
+   std::map<cqg::CString, unsigned> lastFillSeq; ///< The last fill sequence number by order guid.
+   std::map<cqg::CString, long long> orderFilledQty;   ///< Quantity of reported fills by order guid.
+   std::map<cqg::CString, cqg::Quantity> reportedQty;  ///< The last order filled quantity by order guid.
+};
+
+/// @brief Fills big market orders partially on each quote, reports fills by order changes or fill events.
+/// @return Seconds spent.
+double FillOrders(unsigned ordersCount, cqg::Quantity quantity, bool fillEvents, FillEvents& events)
+{
+   cqg::FacadeSettings settings;
+   settings.fillEvents = fillEvents;
+   cqg::IAPIFacadePtr api = Start(events, 1, settings);
+
+   cqg::Accounts accounts;
+   api->GetAccounts(accounts);
+   if(accounts.empty() || events.symbols.empty())
+   {
+      return 0.0;
+   }
+
+   std::vector<cqg::CString> orderGuids(ordersCount);
+
+   const Clock::time_point start = Clock::now();
+   for(unsigned i = 0; i < ordersCount; ++i)
+   {
+      orderGuids[i] = api->PlaceOrder(cqg::Market, accounts.front().gwAccountID, events.symbols.front(), i % 2 == 0,
+         quantity, cqg::CString("Bench"), cqg::OrderPrice());
+   }
+
+   // Partially filled orders canceled get order change carrying their last fill again.
+   while(events.fills < ordersCount && api->PumpEvents(1) != 0) {}
+   for(unsigned i = 0; i < ordersCount; i += 3)
+   {
+      api->CancelOrder(orderGuids[i]);
+   }
+
+   while(events.finalOrders < ordersCount && api->PumpEvents(1) != 0) {}
+   return SecondsSince(start);
+}
+
+/// @brief Compares fills delivery by order changes and by fill events.
+void BenchFillEvents(unsigned ordersCount, cqg::Quantity quantity)
+{
+   FillEvents changes;
+   const double changesElapsed = FillOrders(ordersCount, quantity, false, changes);
+
+   FillEvents fills;
+   const double fillsElapsed = FillOrders(ordersCount, quantity, true, fills);
+
+   std::printf("fill events: %u orders of %u lots, order changes %u fills (%lld lots) in %.3f s, "
+      "fill events %u fills (%lld lots), %u order states in %.3f s, %u sequence gaps, %u duplicate fills\n",
+      ordersCount, quantity, changes.fills, changes.filledQty, changesElapsed,
+      fills.fills, fills.filledQty, fills.stateEvents, fillsElapsed, changes.sequenceGaps + fills.sequenceGaps,
+      changes.getDuplicateFills() + fills.getDuplicateFills());
+}
+
+/// @class PositionEvents
+/// @brief Refreshes account OTE & P/L on each quote update, like risk screen.
+struct PositionEvents : BenchEvents
+{
+   PositionEvents():
+      api(NULL),
+      gwAccountID(0),
+      refreshes(0),
+      oteChanges(0),
+      lastOte(0.0),
+      refreshSeconds(0.0)
+   {}
+
+   virtual void OnSymbolQuote(const cqg::SymbolInfo& symbol)
+   {
+      BenchEvents::OnSymbolQuote(symbol);
+
+      if(!api)
+      {
+         return;
+      }
+
+      cqg::MoneyAmount ote = 0.0;
+      cqg::MoneyAmount profitLoss = 0.0;
+
+      const Clock::time_point start = Clock::now();
+      api->GetLocalProfitLoss(gwAccountID, ote, profitLoss);
+      refreshSeconds += SecondsSince(start);
+
+      ++refreshes;
+      oteChanges += ote != lastOte ? 1 : 0;
+      lastOte = ote;
+   }
+
+   cqg::IAPIFacade* api;       ///< Facade to get P/L from.
+   cqg::ID gwAccountID;        ///< Account to get P/L of.
+   unsigned refreshes;         ///< Number of P/L refreshes.
+   unsigned oteChanges;        ///< Number of refreshes OTE changed at.
+   cqg::MoneyAmount lastOte;   ///< The last OTE.
+   double refreshSeconds;      ///< Time spent getting P/L.
+};
+
+/// @brief Trades market orders over symbols, checks local positions against backend ones
+///        and measures tick rate P/L refresh.
+void BenchPositions(unsigned quoteEvents, unsigned symbolsCount, unsigned ordersCount)
+{
+   PositionEvents events;
+   cqg::IAPIFacadePtr api = Start(events, symbolsCount);
+
+   cqg::Accounts accounts;
+   api->GetAccounts(accounts);
+   if(accounts.empty() || events.symbols.empty())
+   {
+      std::printf("positions: no accounts or symbols\n");
+      return;
+   }
+
+   events.api = api.get();
+   events.gwAccountID = accounts.front().gwAccountID;
+
+   // Orders of both sides & different sizes open, increase, close and reverse positions.
+   for(unsigned i = 0; i < ordersCount; ++i)
+   {
+      api->PlaceOrder(cqg::Market, events.gwAccountID, events.symbols[i % events.symbols.size()], i % 3 != 0,
+         1 + i % 7, cqg::CString("Bench"), cqg::OrderPrice());
+   }
+
+   for(unsigned i = 0; i < quoteEvents && api->PumpEvents(1) != 0; ++i) {}
+
+   // Big orders are canceled partially filled, their cancels carry the last fill again.
+   std::vector<cqg::CString> bigOrders;
+   for(size_t i = 0; i < events.symbols.size(); ++i)
+   {
+      bigOrders.push_back(api->PlaceOrder(cqg::Market, events.gwAccountID, events.symbols[i], i % 2 != 0,
+         100000, cqg::CString("Bench"), cqg::OrderPrice()));
+   }
+
+   for(unsigned i = 0; i < quoteEvents / 10 && api->PumpEvents(1) != 0; ++i) {}
+   for(size_t i = 0; i < bigOrders.size(); ++i)
+   {
+      api->CancelOrder(bigOrders[i]);
+   }
+
+   for(unsigned i = 0; i < quoteEvents / 10 && api->PumpEvents(1) != 0; ++i) {}
+
+   cqg::Positions local;
+   cqg::Positions backend;
+   api->GetLocalPositions(events.gwAccountID, local);
+   api->GetPositions(events.gwAccountID, backend);
+
+   unsigned matched = 0;
+   for(size_t i = 0; i < backend.size(); ++i)
+   {
+      for(size_t j = 0; j < local.size(); ++j)
+      {
+         const cqg::PositionInfo& lhs = backend[i];
+         const cqg::PositionInfo& rhs = local[j];
+         if(lhs.symbol == rhs.symbol && lhs.quantity == rhs.quantity &&
+            (lhs.quantity == 0 || (lhs.longPosition == rhs.longPosition &&
+               std::fabs(lhs.averagePrice - rhs.averagePrice) < 1e-9)) &&
+            std::fabs(lhs.profitLoss - rhs.profitLoss) < 1e-6)
+         {
+            ++matched;
+            break;
+         }
+      }
+   }
+
+   cqg::MoneyAmount ote = 0.0;
+   cqg::MoneyAmount profitLoss = 0.0;
+   api->GetLocalProfitLoss(events.gwAccountID, ote, profitLoss);
+
+   std::printf("positions: %u orders over %u symbols, %u of %u positions match backend, OTE %.2f, P/L %.2f, "
+      "%u P/L refreshes at %.3f us, %u OTE changes\n",
+      ordersCount, static_cast<unsigned>(events.symbols.size()), matched, static_cast<unsigned>(backend.size()),
+      ote, profitLoss,
+      events.refreshes, events.refreshes ? events.refreshSeconds * 1e6 / events.refreshes : 0.0, events.oteChanges);
+}
+
+/// @brief Compares marking portfolio to market position by position vs columnar SSE2 kernel.
+void BenchPortfolio(unsigned accountsCount, unsigned symbolsCount, unsigned repeats)
+{
+   std::vector<cqg::Price> prices(symbolsCount);
+   std::vector<double> pointValues(symbolsCount);
+   for(unsigned s = 0; s < symbolsCount; ++s)
+   {
+      prices[s] = 100.0 + s;
+      pointValues[s] = 12.5 * (1 + s % 4);
+   }
+
+   // Every account holds long & short positions of every symbol, positions added symbol by symbol
+   // like fills arrive, so columns keep regrouping rows by account.
+   std::vector<cqg::Positions> accounts(accountsCount, cqg::Positions(symbolsCount));
+   cqg::PortfolioColumns columns;
+
+   for(unsigned s = 0; s < symbolsCount; ++s)
+   {
+      for(unsigned a = 0; a < accountsCount; ++a)
+      {
+         cqg::PositionInfo& position = accounts[a][s];
+         position.symbol.Format("SYM%u", s);
+         position.longPosition = (a + s) % 3 != 0;
+         position.quantity = 1 + (a * 7 + s * 3) % 10;
+         position.averagePrice = prices[s] + ((a + s) % 9) * 0.25 - 1.0;
+         position.ote = 0.0;
+         position.profitLoss = 0.0;
+
+         const double quantity = position.longPosition ? position.quantity : -static_cast<double>(position.quantity);
+         columns.Add(a + 1, s, quantity, position.averagePrice);
+      }
+
+      columns.SetSymbolPointValue(s, pointValues[s]);
+      columns.SetSymbolPrices(s, prices[s], prices[s]);
+   }
+
+   std::vector<cqg::MoneyAmount> perPositionOte(accountsCount);
+   cqg::AccountsProfitLoss totals;
+
+   double perPositionElapsed = 0.0;
+   double columnarElapsed = 0.0;
+   double kernelElapsed = 0.0;
+   double maxDifference = 0.0;
+
+   for(unsigned r = 0; r < repeats; ++r)
+   {
+      for(unsigned s = 0; s < symbolsCount; ++s)
+      {
+         prices[s] += static_cast<int>((r * 31 + s * 17) % 5 - 2) * 0.25;
+      }
+
+      // Per position: OTE of each position, then account totals.
+      Clock::time_point start = Clock::now();
+      for(unsigned a = 0; a < accountsCount; ++a)
+      {
+         cqg::MoneyAmount ote = 0.0;
+         for(unsigned s = 0; s < symbolsCount; ++s)
+         {
+            cqg::PositionInfo& position = accounts[a][s];
+            const double direction = position.longPosition ? 1.0 : -1.0;
+            position.ote = (prices[s] - position.averagePrice) * position.quantity * direction * pointValues[s];
+            ote += position.ote;
+         }
+         perPositionOte[a] = ote;
+      }
+      perPositionElapsed += SecondsSince(start);
+
+      // Columnar: single price per symbol, then single pass over each account rows gathering symbol prices.
+      start = Clock::now();
+      for(unsigned s = 0; s < symbolsCount; ++s)
+      {
+         columns.SetSymbolPrices(s, prices[s], prices[s]);
+      }
+
+      const Clock::time_point kernelStart = Clock::now();
+      columns.GetAccountsProfitLoss(totals);
+      kernelElapsed += SecondsSince(kernelStart);
+      columnarElapsed += SecondsSince(start);
+
+      for(size_t a = 0; a < totals.size(); ++a)
+      {
+         const double difference = std::fabs(totals[a].ote - perPositionOte[totals[a].gwAccountID - 1]);
+         maxDifference = std::max(maxDifference, difference / std::max(1.0, std::fabs(totals[a].ote)));
+      }
+   }
+
+   std::printf("portfolio: %u accounts, %u positions, per position %.2f us, columnar %.2f us (kernel %.2f us) "
+      "per mark-to-market, totals %s\n",
+      static_cast<unsigned>(totals.size()), static_cast<unsigned>(columns.Size()),
+      perPositionElapsed * 1e6 / repeats, columnarElapsed * 1e6 / repeats, kernelElapsed * 1e6 / repeats,
+      maxDifference < 1e-9 ? "match" : "differ");
+}
+
+/// @brief Measures timed bars request & delivery.
+void BenchBars(unsigned requestsCount, long barsPerRequest)
+{
+   BenchEvents events;
+   cqg::IAPIFacadePtr api = Start(events, 0);
+
+   const Clock::time_point start = Clock::now();
+   for(unsigned i = 0; i < requestsCount; ++i)
+   {
+      cqg::BarsRequest request;
+      request.symbol.Format("SYM%u", i % 10);
+      request.useIndexRange = true;
+      request.startIndex = 0;
+      request.endIndex = -barsPerRequest;
+      request.intradayPeriodInMinutes = 30;
+      request.sessionsFilter = cqg::BarsRequest::UseAllSessions;
+      request.subscribe = false;
+      request.priority = cqg::InteractiveBars;
+
+      api->RequestBars(request);
+   }
+
+   while(events.barsReceived < requestsCount && api->PumpEvents(1) != 0) {}
+   const double elapsed = SecondsSince(start);
+
+   std::printf("bars: %u requests, %llu bars in %.3f s, %.0f bars/s\n",
+      events.barsReceived, events.barsCount, elapsed, events.barsCount / elapsed);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+   const unsigned quoteEvents = argc > 1 ? std::atoi(argv[1]) : 1000000;
+   const unsigned symbolsCount = argc > 2 ? std::atoi(argv[2]) : 400;
+
+   const cqg::FacadeVersion version = cqg::IAPIFacade::GetVersion();
+   std::printf("CQG API Facade v%d.%d benchmark, simulated CQGCEL\n", version.m_major, version.m_minor);
+
+   BenchSymbolsBatch(symbolsCount, 10);
+
+   cqg::FacadeSettings settings;
+   BenchQuotes("quotes (SymbolInfo)", quoteEvents, symbolsCount, settings);
+
+   settings.quoteEvents = true;
+   BenchQuotes("quotes (QuoteEvent)", quoteEvents, symbolsCount, settings);
+
+   settings.deltaQuotes = true;
+   BenchQuotes("quotes (delta QuoteEvent)", quoteEvents, symbolsCount, settings);
+   BenchConflatedQuotes(quoteEvents, symbolsCount, 10000);
+   BenchDispatchedQuotes(quoteEvents, symbolsCount, cqg::BlockOnOverflow, "block");
+   BenchDispatchedQuotes(quoteEvents, symbolsCount, cqg::DropOldestOnOverflow, "drop oldest");
+   BenchDispatchedQuotes(quoteEvents, symbolsCount, cqg::ConflateOnOverflow, "conflate");
+   BenchMarketDepth(quoteEvents, symbolsCount);
+   BenchDispatchedDepth(quoteEvents, symbolsCount);
+   BenchSubscriptions(quoteEvents, symbolsCount);
+   BenchOrders(10000);
+   BenchOrderTickets(10000);
+   BenchOrderBatches(200, 50);
+   BenchOrderModify(10000);
+   BenchFillEvents(100, 2000);
+   BenchPositions(quoteEvents, 10, 1000);
+   BenchPortfolio(20, 300, 2000);
+   BenchBars(100, 10000);
+   BenchBarUpdates(quoteEvents, 10, 20, 1000);
+   BenchBarColumns(100000, 20, 20);
+   BenchBarCache(100000, 600);
+   BenchBarIntervals(20, 10);
+   BenchBarsScheduler(200, 10, 4);
+   BenchDerivedBars(quoteEvents, 10, 500);
+   BenchTradeBars(quoteEvents, symbolsCount);
+   BenchIndicators(100000, 1000, 20);
+
+   return 0;
+}
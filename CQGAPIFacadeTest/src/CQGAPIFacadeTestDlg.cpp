@@ -207,11 +207,9 @@ void CCQGAPIFacadeTestDlg::OnSymbolSubscribed(const CString& requestedSymbol, co
 
       writeLn(str);
 
+      // Positions kept by facade, no CQGCEL positions walk
       cqg::Positions pos;
-      if(!m_api->GetPositions(accs[i].gwAccountID, pos))
-      {
-         writeLn("Unable to get positions: " + m_api->GetLastError());
-      }
+      m_api->GetLocalPositions(accs[i].gwAccountID, pos);
 
       // Print out account positions
       for(size_t j = 0; j < pos.size(); ++j)